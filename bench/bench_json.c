@@ -0,0 +1,202 @@
+// Compares `ti_json_encode` against a printf-based encoder, written like `print_value` in
+// `examples/print_types.c`, and measures `ti_json_decode` on its output.
+// Build with optimizations for meaningful numbers, e.g. `-DCMAKE_BUILD_TYPE=Release`.
+#define TYPEINFO_IMPL
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_types.h"
+#include "bench_types_typeinfo.h"
+#include "typeinfo.h"
+
+#define MESSAGE_COUNT 1024
+#define ITERATIONS    100
+
+static Bench_Message messages[MESSAGE_COUNT];
+
+static void init_messages(void) {
+    for(int i = 0; i < MESSAGE_COUNT; i++) {
+        Bench_Message* m = &messages[i];
+        m->id = (uint32_t)i;
+        m->team = (uint8_t)(i % 4);
+        m->flags = (uint16_t)(i * 7);
+        m->kind = (Bench_Kind)(i % 3);
+        m->position = (Bench_Vec3){(float)i * 0.1f, (float)i * 2.5f, (float)i * -3.0f};
+        m->velocity = (Bench_Vec3){1.0f, 0.5f, 0.25f};
+        m->timestamp = i * 0.016;
+        m->health = 100 - i % 100;
+        snprintf(m->name, sizeof(m->name), "unit_%d", i);
+        for(int j = 0; j < 8; j++) m->waypoints[j] = (Bench_Vec3){(float)j, (float)i / 7.0f, 0.0f};
+        m->description = "A unit moving along its waypoints, \"quoted\" and\ttabbed";
+        m->user_data = m;
+    }
+}
+
+typedef struct {
+    char* data;
+    size_t size, capacity;
+} Printf_Buffer;
+
+static void buf_printf(Printf_Buffer* b, const char* fmt, ...) {
+    for(;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int n = vsnprintf(b->data + b->size, b->capacity - b->size, fmt, ap);
+        va_end(ap);
+        if((size_t)n < b->capacity - b->size) {
+            b->size += (size_t)n;
+            return;
+        }
+        b->capacity = b->capacity ? b->capacity * 2 : 256;
+        b->data = realloc(b->data, b->capacity);
+    }
+}
+
+static void printf_encode(Printf_Buffer* b, Type_Info* ti, const void* value) {
+    switch(ti->tag) {
+    case TYPE_TAG_VOID:
+        buf_printf(b, "null");
+        break;
+    case TYPE_TAG_INTEGER: {
+        bool is_signed = ((Type_Info_Integer*)ti)->is_signed;
+        switch(ti->size) {
+        case 1:
+            if(is_signed) buf_printf(b, "%d", *(int8_t*)value);
+            else buf_printf(b, "%u", *(uint8_t*)value);
+            break;
+        case 2:
+            if(is_signed) buf_printf(b, "%d", *(int16_t*)value);
+            else buf_printf(b, "%u", *(uint16_t*)value);
+            break;
+        case 4:
+            if(is_signed) buf_printf(b, "%d", *(int32_t*)value);
+            else buf_printf(b, "%u", *(uint32_t*)value);
+            break;
+        default:
+            if(is_signed) buf_printf(b, "%lld", *(long long*)value);
+            else buf_printf(b, "%llu", *(unsigned long long*)value);
+            break;
+        }
+    } break;
+    case TYPE_TAG_FLOAT:
+        if(ti->size == sizeof(float)) buf_printf(b, "%.9g", *(float*)value);
+        else buf_printf(b, "%.17g", *(double*)value);
+        break;
+    case TYPE_TAG_ENUM: {
+        const char* name = ti_enum_name((Type_Info_Enum*)ti, *(int*)value);
+        buf_printf(b, "\"%s\"", name);
+    } break;
+    case TYPE_TAG_POINTER: {
+        Type_Info* pointee = ((Type_Info_Pointer*)ti)->pointer_to;
+        void* p = *(void**)value;
+        if(!p || pointee->tag == TYPE_TAG_VOID) buf_printf(b, "null");
+        else printf_encode(b, pointee, p);
+    } break;
+    case TYPE_TAG_ARRAY: {
+        Type_Info_Array* a = (Type_Info_Array*)ti;
+        buf_printf(b, "[");
+        for(size_t i = 0; i < a->num_elements; i++) {
+            if(i > 0) buf_printf(b, ",");
+            printf_encode(b, a->element_type, (char*)value + i * a->element_type->size);
+        }
+        buf_printf(b, "]");
+    } break;
+    case TYPE_TAG_VECTOR: {
+        Type_Info_Vector* v = (Type_Info_Vector*)ti;
+        buf_printf(b, "[");
+        for(size_t i = 0; i < v->num_lanes; i++) {
+            if(i > 0) buf_printf(b, ",");
+            printf_encode(b, v->lane_type, (char*)value + i * v->lane_type->size);
+        }
+        buf_printf(b, "]");
+    } break;
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION: {
+        Type_Info_Struct* s = (Type_Info_Struct*)ti;
+        buf_printf(b, "{");
+        for(size_t i = 0; i < s->members_count; i++) {
+            Type_Info_Member* m = &s->members[i];
+            void* field = (char*)value + m->offset;
+            buf_printf(b, i > 0 ? ",\"%s\":" : "\"%s\":", m->name);
+            if(m->annotation_set & TYPE_INFO_ANNOTATION_BIT(TI_ANN_CStr)) {
+                // No escaping
+                if(m->type->tag == TYPE_TAG_POINTER) buf_printf(b, "\"%s\"", *(char**)field);
+                else buf_printf(b, "\"%s\"", (char*)field);
+            } else {
+                printf_encode(b, m->type, field);
+            }
+        }
+        buf_printf(b, "}");
+    } break;
+    }
+}
+
+static void report(const char* name, double ns, size_t bytes) {
+    printf("%-22s %8.2f ns/message %10.2f MB/s\n", name, ns / ((double)MESSAGE_COUNT * ITERATIONS),
+           (double)bytes / (ns / 1e9) / (1024.0 * 1024.0));
+}
+
+int main(void) {
+    init_messages();
+
+    Printf_Buffer pb = {0};
+    size_t bytes = 0;
+    clock_t start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int i = 0; i < MESSAGE_COUNT; i++) {
+            pb.size = 0;
+            printf_encode(&pb, &typeinfo_Bench_Message.base, &messages[i]);
+            bytes += pb.size;
+        }
+    }
+    report("json (printf)", (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC, bytes);
+
+    Type_Info_Buffer tb = {0};
+    bytes = 0;
+    start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int i = 0; i < MESSAGE_COUNT; i++) {
+            tb.size = 0;
+            ti_json_encode(type_any(&messages[i], Bench_Message), &tb);
+            bytes += tb.size;
+        }
+    }
+    report("json (ti_json_encode)", (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC, bytes);
+
+    // `CStr` pointers can't be decoded in place, encode the messages without them
+    size_t* offsets = malloc((MESSAGE_COUNT + 1) * sizeof(*offsets));
+    tb.size = 0;
+    for(int i = 0; i < MESSAGE_COUNT; i++) {
+        Bench_Message m = messages[i];
+        m.description = NULL;
+        offsets[i] = tb.size;
+        ti_json_encode(type_any(&m, Bench_Message), &tb);
+    }
+    offsets[MESSAGE_COUNT] = tb.size;
+
+    Bench_Message decoded;
+    int failures = 0;
+    bytes = 0;
+    start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int i = 0; i < MESSAGE_COUNT; i++) {
+            size_t len = offsets[i + 1] - offsets[i];
+            failures += !ti_json_decode(tb.data + offsets[i], len, type_any(&decoded, Bench_Message));
+            bytes += len;
+        }
+    }
+    report("json (ti_json_decode)", (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC, bytes);
+    if(failures) printf("%d decoding failures\n", failures);
+
+    tb.size = 0;
+    ti_json_encode(type_any(&messages[MESSAGE_COUNT - 1], Bench_Message), &tb);
+    printf("\n%s\n", tb.data);
+
+    free(pb.data);
+    free(offsets);
+    ti_buffer_free(&tb);
+    return 0;
+}
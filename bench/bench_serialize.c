@@ -0,0 +1,116 @@
+// Compares walking the type info, the runtime-compiled plans used by `ti_serialize`/`ti_deserialize`
+// and the specialized functions generated by `typeinfo_metaprogram -emit-serializers`.
+// Build with optimizations for meaningful numbers, e.g. `-DCMAKE_BUILD_TYPE=Release`.
+#define TYPEINFO_IMPL
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "bench_types.h"
+#include "bench_types_typeinfo.h"
+#include "typeinfo.h"
+
+#define MESSAGE_COUNT 4096
+#define ITERATIONS    500
+
+static Bench_Message messages[MESSAGE_COUNT];
+static unsigned char data[MESSAGE_COUNT][TI_SERIALIZED_SIZE_Bench_Message];
+
+static void init_messages(void) {
+    for(int i = 0; i < MESSAGE_COUNT; i++) {
+        Bench_Message* m = &messages[i];
+        m->id = (uint32_t)i;
+        m->team = (uint8_t)(i % 4);
+        m->flags = (uint16_t)(i * 7);
+        m->kind = (Bench_Kind)(i % 3);
+        m->position = (Bench_Vec3){(float)i, (float)i * 2.0f, (float)i * 3.0f};
+        m->velocity = (Bench_Vec3){1.0f, 0.5f, 0.25f};
+        m->timestamp = i * 0.016;
+        m->health = 100 - i % 100;
+        snprintf(m->name, sizeof(m->name), "unit_%d", i);
+        for(int j = 0; j < 8; j++) m->waypoints[j] = (Bench_Vec3){(float)j, (float)i, 0.0f};
+        m->user_data = m;
+    }
+}
+
+static size_t serialize_walk(const void* value, void* out) {
+    return ti__serialize(&typeinfo_Bench_Message.base, value, out);
+}
+
+static size_t deserialize_walk(void* value, const void* data, size_t size) {
+    (void)size;
+    return ti__deserialize(&typeinfo_Bench_Message.base, value, data);
+}
+
+static size_t serialize_plan(const void* value, void* out) {
+    return ti_serialize((Type_Any){(void*)value, &typeinfo_Bench_Message.base}, out);
+}
+
+static size_t deserialize_plan(void* value, const void* data, size_t size) {
+    return ti_deserialize((Type_Any){value, &typeinfo_Bench_Message.base}, data, size);
+}
+
+// Serializes the whole array at once, instead of a message at a time
+static void bench_plan_batch(void) {
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_Bench_Message.base);
+    size_t checksum = 0;
+    clock_t start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        checksum += ti_plan_serialize(plan, messages, MESSAGE_COUNT, data);
+        checksum += data[it % MESSAGE_COUNT][0];
+    }
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC;
+    double bytes = (double)TI_SERIALIZED_SIZE_Bench_Message * MESSAGE_COUNT * ITERATIONS;
+    printf("%-26s %8.2f ns/message %10.2f MB/s (checksum %zu)\n", "serialize (plan, batch)",
+           ns / ((double)MESSAGE_COUNT * ITERATIONS), bytes / (ns / 1e9) / (1024.0 * 1024.0),
+           checksum);
+}
+
+static void bench_serialize(const char* name, size_t (*serialize)(const void*, void*)) {
+    size_t checksum = 0;
+    clock_t start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int i = 0; i < MESSAGE_COUNT; i++) {
+            checksum += serialize(&messages[i], data[i]);
+        }
+        checksum += data[it % MESSAGE_COUNT][0];
+    }
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC;
+    double bytes = (double)TI_SERIALIZED_SIZE_Bench_Message * MESSAGE_COUNT * ITERATIONS;
+    printf("%-26s %8.2f ns/message %10.2f MB/s (checksum %zu)\n", name,
+           ns / ((double)MESSAGE_COUNT * ITERATIONS), bytes / (ns / 1e9) / (1024.0 * 1024.0),
+           checksum);
+}
+
+static void bench_deserialize(const char* name, size_t (*deserialize)(void*, const void*, size_t)) {
+    size_t checksum = 0;
+    clock_t start = clock();
+    for(int it = 0; it < ITERATIONS; it++) {
+        for(int i = 0; i < MESSAGE_COUNT; i++) {
+            checksum += deserialize(&messages[i], data[i], sizeof(data[i]));
+        }
+        checksum += messages[it % MESSAGE_COUNT].id;
+    }
+    double ns = (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC;
+    double bytes = (double)TI_SERIALIZED_SIZE_Bench_Message * MESSAGE_COUNT * ITERATIONS;
+    printf("%-26s %8.2f ns/message %10.2f MB/s (checksum %zu)\n", name,
+           ns / ((double)MESSAGE_COUNT * ITERATIONS), bytes / (ns / 1e9) / (1024.0 * 1024.0),
+           checksum);
+}
+
+int main(void) {
+    init_messages();
+
+    printf("%d messages of %d bytes (%zu in memory), %d iterations\n", MESSAGE_COUNT,
+           TI_SERIALIZED_SIZE_Bench_Message, sizeof(Bench_Message), ITERATIONS);
+
+    bench_serialize("serialize (walk)", serialize_walk);
+    bench_serialize("serialize (plan)", serialize_plan);
+    bench_plan_batch();
+    bench_serialize("serialize (generated)", ti_serialize_Bench_Message);
+    bench_deserialize("deserialize (walk)", deserialize_walk);
+    bench_deserialize("deserialize (plan)", deserialize_plan);
+    bench_deserialize("deserialize (generated)", ti_deserialize_Bench_Message);
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+#ifndef BENCH_TYPES_H_
+#define BENCH_TYPES_H_
+
+#include <stdint.h>
+
+#include "typeinfo.h"
+
+typedef struct {
+    float x, y, z;
+} Bench_Vec3;
+
+typedef enum {
+    BENCH_KIND_SPAWN,
+    BENCH_KIND_MOVE,
+    BENCH_KIND_DESPAWN,
+} Bench_Kind;
+
+// A typical high-volume network message: mostly scalars, some padding and a pointer
+typedef struct TI_ROOT {
+    uint32_t id;
+    uint8_t team;
+    uint16_t flags;
+    Bench_Kind kind;
+    Bench_Vec3 position;
+    Bench_Vec3 velocity;
+    double timestamp;
+    int32_t health;
+    char name[16] TI_ANN(CStr);
+    Bench_Vec3 waypoints[8];
+    const char* description TI_ANN(CStr);
+    void* user_data;
+} Bench_Message;
+
+#endif  // BENCH_TYPES_H_
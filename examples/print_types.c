@@ -117,6 +117,21 @@ void print_value(Type_Any any, int indent) {
         printf("]\n");
     } break;
 
+    case TYPE_TAG_VECTOR: {
+        Type_Info_Vector* vinfo = (Type_Info_Vector*)ti;
+        printf("<\n");
+
+        Type_Info* lane_ti = vinfo->lane_type;
+        for(size_t i = 0; i < vinfo->num_lanes; ++i) {
+            void* lane_ptr = (char*)value + i * lane_ti->size;
+            print_indent(indent + 2);
+            print_value((Type_Any){lane_ptr, lane_ti}, indent + 2);
+        }
+
+        print_indent(indent);
+        printf(">\n");
+    } break;
+
     case TYPE_TAG_STRUCT: {
         Type_Info_Struct* sinfo = (Type_Info_Struct*)ti;
         printf("struct %s {\n", sinfo->name);
@@ -130,13 +145,7 @@ void print_value(Type_Any any, int indent) {
             if(m->qualifier_flags & TYPE_INFO_QUALIFIER_RESTRICT) printf("restrict ");
             if(strcmp(m->name, "") != 0) printf("%s = ", m->name);
 
-            bool as_cstr = false;
-            for(char** it = m->annotations; *it; it++) {
-                if(strcmp(*it, "CStr") == 0) {
-                    as_cstr = true;
-                    break;
-                }
-            }
+            bool as_cstr = ti_has_annotation(m->annotation_set, TI_ANN_CStr);
 
             void* field_ptr = (char*)value + m->offset;
 
@@ -198,14 +207,7 @@ void print_value(Type_Any any, int indent) {
             return;
         }
 
-        // Find the matching enum name
-        const char* name = NULL;
-        for(size_t i = 0; i < einfo->values_count; i++) {
-            if(einfo->values[i].value == enum_value) {
-                name = einfo->values[i].name;
-                break;
-            }
-        }
+        const char* name = ti_enum_name(einfo, enum_value);
 
         if(name) {
             printf("enum %s { %s (%lld) }\n", einfo->name, name, enum_value);
@@ -1,161 +1,536 @@
 #include "typeinfo.h"
 #include "print_types_typeinfo.h"
 
-Type_Info_Void typeinfo_void = {{ TYPE_TAG_VOID, 0, 0 }};
-Type_Info_Integer typeinfo_bool = {{ TYPE_TAG_INTEGER, sizeof(_Bool), TYPEINFO_ALIGNOF(_Bool) }, 0};
-Type_Info_Integer typeinfo_char = {{ TYPE_TAG_INTEGER, sizeof(char), TYPEINFO_ALIGNOF(char) }, (char)-1 < 0};
-Type_Info_Integer typeinfo_signed_char = {{ TYPE_TAG_INTEGER, sizeof(signed char), TYPEINFO_ALIGNOF(signed char) }, 1};
-Type_Info_Integer typeinfo_unsigned_char = {{ TYPE_TAG_INTEGER, sizeof(unsigned char), TYPEINFO_ALIGNOF(unsigned char) }, 0};
-Type_Info_Integer typeinfo_short = {{ TYPE_TAG_INTEGER, sizeof(short), TYPEINFO_ALIGNOF(short) }, 1};
-Type_Info_Integer typeinfo_unsigned_short = {{ TYPE_TAG_INTEGER, sizeof(unsigned short), TYPEINFO_ALIGNOF(unsigned short) }, 0};
-Type_Info_Integer typeinfo_int = {{ TYPE_TAG_INTEGER, sizeof(int), TYPEINFO_ALIGNOF(int) }, 1};
-Type_Info_Integer typeinfo_unsigned_int = {{ TYPE_TAG_INTEGER, sizeof(unsigned int), TYPEINFO_ALIGNOF(unsigned int) }, 0};
-Type_Info_Integer typeinfo_long = {{ TYPE_TAG_INTEGER, sizeof(long), TYPEINFO_ALIGNOF(long) }, 1};
-Type_Info_Integer typeinfo_unsigned_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned long), TYPEINFO_ALIGNOF(unsigned long) }, 0};
-Type_Info_Integer typeinfo_long_long = {{ TYPE_TAG_INTEGER, sizeof(long long), TYPEINFO_ALIGNOF(long long) }, 1};
-Type_Info_Integer typeinfo_unsigned_long_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned long long), TYPEINFO_ALIGNOF(unsigned long long) }, 0};
-Type_Info_Float typeinfo_float = {{ TYPE_TAG_FLOAT, sizeof(float), TYPEINFO_ALIGNOF(float) }};
-Type_Info_Float typeinfo_double = {{ TYPE_TAG_FLOAT, sizeof(double), TYPEINFO_ALIGNOF(double) }};
-Type_Info_Float typeinfo_long_double = {{ TYPE_TAG_FLOAT, sizeof(long double), TYPEINFO_ALIGNOF(long double) }};
+Type_Info_Void typeinfo_void = {{ TYPE_TAG_VOID, 0, 0, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }};
+Type_Info_Integer typeinfo_bool = {{ TYPE_TAG_INTEGER, sizeof(_Bool), TYPEINFO_ALIGNOF(_Bool), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Integer typeinfo_char = {{ TYPE_TAG_INTEGER, sizeof(char), TYPEINFO_ALIGNOF(char), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, (char)-1 < 0};
+Type_Info_Integer typeinfo_signed_char = {{ TYPE_TAG_INTEGER, sizeof(signed char), TYPEINFO_ALIGNOF(signed char), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 1};
+Type_Info_Integer typeinfo_unsigned_char = {{ TYPE_TAG_INTEGER, sizeof(unsigned char), TYPEINFO_ALIGNOF(unsigned char), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Integer typeinfo_short = {{ TYPE_TAG_INTEGER, sizeof(short), TYPEINFO_ALIGNOF(short), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 1};
+Type_Info_Integer typeinfo_unsigned_short = {{ TYPE_TAG_INTEGER, sizeof(unsigned short), TYPEINFO_ALIGNOF(unsigned short), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Integer typeinfo_int = {{ TYPE_TAG_INTEGER, sizeof(int), TYPEINFO_ALIGNOF(int), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 1};
+Type_Info_Integer typeinfo_unsigned_int = {{ TYPE_TAG_INTEGER, sizeof(unsigned int), TYPEINFO_ALIGNOF(unsigned int), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Integer typeinfo_long = {{ TYPE_TAG_INTEGER, sizeof(long), TYPEINFO_ALIGNOF(long), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 1};
+Type_Info_Integer typeinfo_unsigned_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned long), TYPEINFO_ALIGNOF(unsigned long), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Integer typeinfo_long_long = {{ TYPE_TAG_INTEGER, sizeof(long long), TYPEINFO_ALIGNOF(long long), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 1};
+Type_Info_Integer typeinfo_unsigned_long_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned long long), TYPEINFO_ALIGNOF(unsigned long long), TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD }, 0};
+Type_Info_Float typeinfo_float = {{ TYPE_TAG_FLOAT, sizeof(float), TYPEINFO_ALIGNOF(float), TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_IS_POD }};
+Type_Info_Float typeinfo_double = {{ TYPE_TAG_FLOAT, sizeof(double), TYPEINFO_ALIGNOF(double), TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_IS_POD }};
+Type_Info_Float typeinfo_long_double = {{ TYPE_TAG_FLOAT, sizeof(long double), TYPEINFO_ALIGNOF(long double), TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_IS_POD }};
+
+// const char[256]
+static Type_Info_Array typeinfo__array_0 = {{TYPE_TAG_ARRAY, 256, 1, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, 256, (Type_Info*)&typeinfo_char };
+
+// Bar *
+static Type_Info_Pointer typeinfo__pointer_1 = {{TYPE_TAG_POINTER, sizeof(void*), 8, TYPE_INFO_TRAIT_HAS_POINTERS}, (Type_Info*)&typeinfo_Bar, TYPE_INFO_QUALIFIER_NONE };
 
 // struct Foo
 // examples/print_types.h:24:9
 static Type_Info_Member members_Foo[] = {
-  { (char*[]){ "CStr", NULL }, "name", 0, (Type_Info*)&(Type_Info_Array){{TYPE_TAG_ARRAY, 256, 1}, 256, (Type_Info*)&typeinfo_char }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "test", 256, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "bar", 264, (Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), 8}, (Type_Info*)&typeinfo_Bar, TYPE_INFO_QUALIFIER_NONE }, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ "CStr", NULL }, "name", 0, (Type_Info*)&typeinfo__array_0, TYPE_INFO_QUALIFIER_NONE, 4, TYPE_INFO_ANNOTATION_BIT(TI_ANN_CStr), 0, 0 },
+  { (char*[]){ NULL }, "test", 256, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 4, 0, 0, 0 },
+  { (char*[]){ NULL }, "bar", 264, (Type_Info*)&typeinfo__pointer_1, TYPE_INFO_QUALIFIER_NONE, 3, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_Foo = {
-  { TYPE_TAG_STRUCT, 272, 8 },
+  { TYPE_TAG_STRUCT, 272, 8, TYPE_INFO_TRAIT_HAS_POINTERS | TYPE_INFO_TRAIT_HAS_PADDING },
   (char*[]){ NULL },
   "Foo",
   members_Foo,
-  sizeof(members_Foo)/sizeof(*members_Foo)
+  sizeof(members_Foo)/sizeof(*members_Foo),
+  { (uint32_t[]){ 0, 0, 0, 0, }, (uint32_t[]){ TYPE_INFO_INDEX_EMPTY, 1, 0, 2, }, 3 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 260}, {264, 8}}, 2,
+  (Type_Info_Pointer_Slot[]){{264, false, (Type_Info*)&typeinfo_Bar}}, 1,
+  0xa9bff7b50d8cee89ULL,
+  (Type_Info_Leaf[]){
+    {0, 0, 0, "name[0]", (Type_Info*)&typeinfo_char},
+    {1, 0, 0, "name[1]", (Type_Info*)&typeinfo_char},
+    {2, 0, 0, "name[2]", (Type_Info*)&typeinfo_char},
+    {3, 0, 0, "name[3]", (Type_Info*)&typeinfo_char},
+    {4, 0, 0, "name[4]", (Type_Info*)&typeinfo_char},
+    {5, 0, 0, "name[5]", (Type_Info*)&typeinfo_char},
+    {6, 0, 0, "name[6]", (Type_Info*)&typeinfo_char},
+    {7, 0, 0, "name[7]", (Type_Info*)&typeinfo_char},
+    {8, 0, 0, "name[8]", (Type_Info*)&typeinfo_char},
+    {9, 0, 0, "name[9]", (Type_Info*)&typeinfo_char},
+    {10, 0, 0, "name[10]", (Type_Info*)&typeinfo_char},
+    {11, 0, 0, "name[11]", (Type_Info*)&typeinfo_char},
+    {12, 0, 0, "name[12]", (Type_Info*)&typeinfo_char},
+    {13, 0, 0, "name[13]", (Type_Info*)&typeinfo_char},
+    {14, 0, 0, "name[14]", (Type_Info*)&typeinfo_char},
+    {15, 0, 0, "name[15]", (Type_Info*)&typeinfo_char},
+    {16, 0, 0, "name[16]", (Type_Info*)&typeinfo_char},
+    {17, 0, 0, "name[17]", (Type_Info*)&typeinfo_char},
+    {18, 0, 0, "name[18]", (Type_Info*)&typeinfo_char},
+    {19, 0, 0, "name[19]", (Type_Info*)&typeinfo_char},
+    {20, 0, 0, "name[20]", (Type_Info*)&typeinfo_char},
+    {21, 0, 0, "name[21]", (Type_Info*)&typeinfo_char},
+    {22, 0, 0, "name[22]", (Type_Info*)&typeinfo_char},
+    {23, 0, 0, "name[23]", (Type_Info*)&typeinfo_char},
+    {24, 0, 0, "name[24]", (Type_Info*)&typeinfo_char},
+    {25, 0, 0, "name[25]", (Type_Info*)&typeinfo_char},
+    {26, 0, 0, "name[26]", (Type_Info*)&typeinfo_char},
+    {27, 0, 0, "name[27]", (Type_Info*)&typeinfo_char},
+    {28, 0, 0, "name[28]", (Type_Info*)&typeinfo_char},
+    {29, 0, 0, "name[29]", (Type_Info*)&typeinfo_char},
+    {30, 0, 0, "name[30]", (Type_Info*)&typeinfo_char},
+    {31, 0, 0, "name[31]", (Type_Info*)&typeinfo_char},
+    {32, 0, 0, "name[32]", (Type_Info*)&typeinfo_char},
+    {33, 0, 0, "name[33]", (Type_Info*)&typeinfo_char},
+    {34, 0, 0, "name[34]", (Type_Info*)&typeinfo_char},
+    {35, 0, 0, "name[35]", (Type_Info*)&typeinfo_char},
+    {36, 0, 0, "name[36]", (Type_Info*)&typeinfo_char},
+    {37, 0, 0, "name[37]", (Type_Info*)&typeinfo_char},
+    {38, 0, 0, "name[38]", (Type_Info*)&typeinfo_char},
+    {39, 0, 0, "name[39]", (Type_Info*)&typeinfo_char},
+    {40, 0, 0, "name[40]", (Type_Info*)&typeinfo_char},
+    {41, 0, 0, "name[41]", (Type_Info*)&typeinfo_char},
+    {42, 0, 0, "name[42]", (Type_Info*)&typeinfo_char},
+    {43, 0, 0, "name[43]", (Type_Info*)&typeinfo_char},
+    {44, 0, 0, "name[44]", (Type_Info*)&typeinfo_char},
+    {45, 0, 0, "name[45]", (Type_Info*)&typeinfo_char},
+    {46, 0, 0, "name[46]", (Type_Info*)&typeinfo_char},
+    {47, 0, 0, "name[47]", (Type_Info*)&typeinfo_char},
+    {48, 0, 0, "name[48]", (Type_Info*)&typeinfo_char},
+    {49, 0, 0, "name[49]", (Type_Info*)&typeinfo_char},
+    {50, 0, 0, "name[50]", (Type_Info*)&typeinfo_char},
+    {51, 0, 0, "name[51]", (Type_Info*)&typeinfo_char},
+    {52, 0, 0, "name[52]", (Type_Info*)&typeinfo_char},
+    {53, 0, 0, "name[53]", (Type_Info*)&typeinfo_char},
+    {54, 0, 0, "name[54]", (Type_Info*)&typeinfo_char},
+    {55, 0, 0, "name[55]", (Type_Info*)&typeinfo_char},
+    {56, 0, 0, "name[56]", (Type_Info*)&typeinfo_char},
+    {57, 0, 0, "name[57]", (Type_Info*)&typeinfo_char},
+    {58, 0, 0, "name[58]", (Type_Info*)&typeinfo_char},
+    {59, 0, 0, "name[59]", (Type_Info*)&typeinfo_char},
+    {60, 0, 0, "name[60]", (Type_Info*)&typeinfo_char},
+    {61, 0, 0, "name[61]", (Type_Info*)&typeinfo_char},
+    {62, 0, 0, "name[62]", (Type_Info*)&typeinfo_char},
+    {63, 0, 0, "name[63]", (Type_Info*)&typeinfo_char},
+    {64, 0, 0, "name[64]", (Type_Info*)&typeinfo_char},
+    {65, 0, 0, "name[65]", (Type_Info*)&typeinfo_char},
+    {66, 0, 0, "name[66]", (Type_Info*)&typeinfo_char},
+    {67, 0, 0, "name[67]", (Type_Info*)&typeinfo_char},
+    {68, 0, 0, "name[68]", (Type_Info*)&typeinfo_char},
+    {69, 0, 0, "name[69]", (Type_Info*)&typeinfo_char},
+    {70, 0, 0, "name[70]", (Type_Info*)&typeinfo_char},
+    {71, 0, 0, "name[71]", (Type_Info*)&typeinfo_char},
+    {72, 0, 0, "name[72]", (Type_Info*)&typeinfo_char},
+    {73, 0, 0, "name[73]", (Type_Info*)&typeinfo_char},
+    {74, 0, 0, "name[74]", (Type_Info*)&typeinfo_char},
+    {75, 0, 0, "name[75]", (Type_Info*)&typeinfo_char},
+    {76, 0, 0, "name[76]", (Type_Info*)&typeinfo_char},
+    {77, 0, 0, "name[77]", (Type_Info*)&typeinfo_char},
+    {78, 0, 0, "name[78]", (Type_Info*)&typeinfo_char},
+    {79, 0, 0, "name[79]", (Type_Info*)&typeinfo_char},
+    {80, 0, 0, "name[80]", (Type_Info*)&typeinfo_char},
+    {81, 0, 0, "name[81]", (Type_Info*)&typeinfo_char},
+    {82, 0, 0, "name[82]", (Type_Info*)&typeinfo_char},
+    {83, 0, 0, "name[83]", (Type_Info*)&typeinfo_char},
+    {84, 0, 0, "name[84]", (Type_Info*)&typeinfo_char},
+    {85, 0, 0, "name[85]", (Type_Info*)&typeinfo_char},
+    {86, 0, 0, "name[86]", (Type_Info*)&typeinfo_char},
+    {87, 0, 0, "name[87]", (Type_Info*)&typeinfo_char},
+    {88, 0, 0, "name[88]", (Type_Info*)&typeinfo_char},
+    {89, 0, 0, "name[89]", (Type_Info*)&typeinfo_char},
+    {90, 0, 0, "name[90]", (Type_Info*)&typeinfo_char},
+    {91, 0, 0, "name[91]", (Type_Info*)&typeinfo_char},
+    {92, 0, 0, "name[92]", (Type_Info*)&typeinfo_char},
+    {93, 0, 0, "name[93]", (Type_Info*)&typeinfo_char},
+    {94, 0, 0, "name[94]", (Type_Info*)&typeinfo_char},
+    {95, 0, 0, "name[95]", (Type_Info*)&typeinfo_char},
+    {96, 0, 0, "name[96]", (Type_Info*)&typeinfo_char},
+    {97, 0, 0, "name[97]", (Type_Info*)&typeinfo_char},
+    {98, 0, 0, "name[98]", (Type_Info*)&typeinfo_char},
+    {99, 0, 0, "name[99]", (Type_Info*)&typeinfo_char},
+    {100, 0, 0, "name[100]", (Type_Info*)&typeinfo_char},
+    {101, 0, 0, "name[101]", (Type_Info*)&typeinfo_char},
+    {102, 0, 0, "name[102]", (Type_Info*)&typeinfo_char},
+    {103, 0, 0, "name[103]", (Type_Info*)&typeinfo_char},
+    {104, 0, 0, "name[104]", (Type_Info*)&typeinfo_char},
+    {105, 0, 0, "name[105]", (Type_Info*)&typeinfo_char},
+    {106, 0, 0, "name[106]", (Type_Info*)&typeinfo_char},
+    {107, 0, 0, "name[107]", (Type_Info*)&typeinfo_char},
+    {108, 0, 0, "name[108]", (Type_Info*)&typeinfo_char},
+    {109, 0, 0, "name[109]", (Type_Info*)&typeinfo_char},
+    {110, 0, 0, "name[110]", (Type_Info*)&typeinfo_char},
+    {111, 0, 0, "name[111]", (Type_Info*)&typeinfo_char},
+    {112, 0, 0, "name[112]", (Type_Info*)&typeinfo_char},
+    {113, 0, 0, "name[113]", (Type_Info*)&typeinfo_char},
+    {114, 0, 0, "name[114]", (Type_Info*)&typeinfo_char},
+    {115, 0, 0, "name[115]", (Type_Info*)&typeinfo_char},
+    {116, 0, 0, "name[116]", (Type_Info*)&typeinfo_char},
+    {117, 0, 0, "name[117]", (Type_Info*)&typeinfo_char},
+    {118, 0, 0, "name[118]", (Type_Info*)&typeinfo_char},
+    {119, 0, 0, "name[119]", (Type_Info*)&typeinfo_char},
+    {120, 0, 0, "name[120]", (Type_Info*)&typeinfo_char},
+    {121, 0, 0, "name[121]", (Type_Info*)&typeinfo_char},
+    {122, 0, 0, "name[122]", (Type_Info*)&typeinfo_char},
+    {123, 0, 0, "name[123]", (Type_Info*)&typeinfo_char},
+    {124, 0, 0, "name[124]", (Type_Info*)&typeinfo_char},
+    {125, 0, 0, "name[125]", (Type_Info*)&typeinfo_char},
+    {126, 0, 0, "name[126]", (Type_Info*)&typeinfo_char},
+    {127, 0, 0, "name[127]", (Type_Info*)&typeinfo_char},
+    {128, 0, 0, "name[128]", (Type_Info*)&typeinfo_char},
+    {129, 0, 0, "name[129]", (Type_Info*)&typeinfo_char},
+    {130, 0, 0, "name[130]", (Type_Info*)&typeinfo_char},
+    {131, 0, 0, "name[131]", (Type_Info*)&typeinfo_char},
+    {132, 0, 0, "name[132]", (Type_Info*)&typeinfo_char},
+    {133, 0, 0, "name[133]", (Type_Info*)&typeinfo_char},
+    {134, 0, 0, "name[134]", (Type_Info*)&typeinfo_char},
+    {135, 0, 0, "name[135]", (Type_Info*)&typeinfo_char},
+    {136, 0, 0, "name[136]", (Type_Info*)&typeinfo_char},
+    {137, 0, 0, "name[137]", (Type_Info*)&typeinfo_char},
+    {138, 0, 0, "name[138]", (Type_Info*)&typeinfo_char},
+    {139, 0, 0, "name[139]", (Type_Info*)&typeinfo_char},
+    {140, 0, 0, "name[140]", (Type_Info*)&typeinfo_char},
+    {141, 0, 0, "name[141]", (Type_Info*)&typeinfo_char},
+    {142, 0, 0, "name[142]", (Type_Info*)&typeinfo_char},
+    {143, 0, 0, "name[143]", (Type_Info*)&typeinfo_char},
+    {144, 0, 0, "name[144]", (Type_Info*)&typeinfo_char},
+    {145, 0, 0, "name[145]", (Type_Info*)&typeinfo_char},
+    {146, 0, 0, "name[146]", (Type_Info*)&typeinfo_char},
+    {147, 0, 0, "name[147]", (Type_Info*)&typeinfo_char},
+    {148, 0, 0, "name[148]", (Type_Info*)&typeinfo_char},
+    {149, 0, 0, "name[149]", (Type_Info*)&typeinfo_char},
+    {150, 0, 0, "name[150]", (Type_Info*)&typeinfo_char},
+    {151, 0, 0, "name[151]", (Type_Info*)&typeinfo_char},
+    {152, 0, 0, "name[152]", (Type_Info*)&typeinfo_char},
+    {153, 0, 0, "name[153]", (Type_Info*)&typeinfo_char},
+    {154, 0, 0, "name[154]", (Type_Info*)&typeinfo_char},
+    {155, 0, 0, "name[155]", (Type_Info*)&typeinfo_char},
+    {156, 0, 0, "name[156]", (Type_Info*)&typeinfo_char},
+    {157, 0, 0, "name[157]", (Type_Info*)&typeinfo_char},
+    {158, 0, 0, "name[158]", (Type_Info*)&typeinfo_char},
+    {159, 0, 0, "name[159]", (Type_Info*)&typeinfo_char},
+    {160, 0, 0, "name[160]", (Type_Info*)&typeinfo_char},
+    {161, 0, 0, "name[161]", (Type_Info*)&typeinfo_char},
+    {162, 0, 0, "name[162]", (Type_Info*)&typeinfo_char},
+    {163, 0, 0, "name[163]", (Type_Info*)&typeinfo_char},
+    {164, 0, 0, "name[164]", (Type_Info*)&typeinfo_char},
+    {165, 0, 0, "name[165]", (Type_Info*)&typeinfo_char},
+    {166, 0, 0, "name[166]", (Type_Info*)&typeinfo_char},
+    {167, 0, 0, "name[167]", (Type_Info*)&typeinfo_char},
+    {168, 0, 0, "name[168]", (Type_Info*)&typeinfo_char},
+    {169, 0, 0, "name[169]", (Type_Info*)&typeinfo_char},
+    {170, 0, 0, "name[170]", (Type_Info*)&typeinfo_char},
+    {171, 0, 0, "name[171]", (Type_Info*)&typeinfo_char},
+    {172, 0, 0, "name[172]", (Type_Info*)&typeinfo_char},
+    {173, 0, 0, "name[173]", (Type_Info*)&typeinfo_char},
+    {174, 0, 0, "name[174]", (Type_Info*)&typeinfo_char},
+    {175, 0, 0, "name[175]", (Type_Info*)&typeinfo_char},
+    {176, 0, 0, "name[176]", (Type_Info*)&typeinfo_char},
+    {177, 0, 0, "name[177]", (Type_Info*)&typeinfo_char},
+    {178, 0, 0, "name[178]", (Type_Info*)&typeinfo_char},
+    {179, 0, 0, "name[179]", (Type_Info*)&typeinfo_char},
+    {180, 0, 0, "name[180]", (Type_Info*)&typeinfo_char},
+    {181, 0, 0, "name[181]", (Type_Info*)&typeinfo_char},
+    {182, 0, 0, "name[182]", (Type_Info*)&typeinfo_char},
+    {183, 0, 0, "name[183]", (Type_Info*)&typeinfo_char},
+    {184, 0, 0, "name[184]", (Type_Info*)&typeinfo_char},
+    {185, 0, 0, "name[185]", (Type_Info*)&typeinfo_char},
+    {186, 0, 0, "name[186]", (Type_Info*)&typeinfo_char},
+    {187, 0, 0, "name[187]", (Type_Info*)&typeinfo_char},
+    {188, 0, 0, "name[188]", (Type_Info*)&typeinfo_char},
+    {189, 0, 0, "name[189]", (Type_Info*)&typeinfo_char},
+    {190, 0, 0, "name[190]", (Type_Info*)&typeinfo_char},
+    {191, 0, 0, "name[191]", (Type_Info*)&typeinfo_char},
+    {192, 0, 0, "name[192]", (Type_Info*)&typeinfo_char},
+    {193, 0, 0, "name[193]", (Type_Info*)&typeinfo_char},
+    {194, 0, 0, "name[194]", (Type_Info*)&typeinfo_char},
+    {195, 0, 0, "name[195]", (Type_Info*)&typeinfo_char},
+    {196, 0, 0, "name[196]", (Type_Info*)&typeinfo_char},
+    {197, 0, 0, "name[197]", (Type_Info*)&typeinfo_char},
+    {198, 0, 0, "name[198]", (Type_Info*)&typeinfo_char},
+    {199, 0, 0, "name[199]", (Type_Info*)&typeinfo_char},
+    {200, 0, 0, "name[200]", (Type_Info*)&typeinfo_char},
+    {201, 0, 0, "name[201]", (Type_Info*)&typeinfo_char},
+    {202, 0, 0, "name[202]", (Type_Info*)&typeinfo_char},
+    {203, 0, 0, "name[203]", (Type_Info*)&typeinfo_char},
+    {204, 0, 0, "name[204]", (Type_Info*)&typeinfo_char},
+    {205, 0, 0, "name[205]", (Type_Info*)&typeinfo_char},
+    {206, 0, 0, "name[206]", (Type_Info*)&typeinfo_char},
+    {207, 0, 0, "name[207]", (Type_Info*)&typeinfo_char},
+    {208, 0, 0, "name[208]", (Type_Info*)&typeinfo_char},
+    {209, 0, 0, "name[209]", (Type_Info*)&typeinfo_char},
+    {210, 0, 0, "name[210]", (Type_Info*)&typeinfo_char},
+    {211, 0, 0, "name[211]", (Type_Info*)&typeinfo_char},
+    {212, 0, 0, "name[212]", (Type_Info*)&typeinfo_char},
+    {213, 0, 0, "name[213]", (Type_Info*)&typeinfo_char},
+    {214, 0, 0, "name[214]", (Type_Info*)&typeinfo_char},
+    {215, 0, 0, "name[215]", (Type_Info*)&typeinfo_char},
+    {216, 0, 0, "name[216]", (Type_Info*)&typeinfo_char},
+    {217, 0, 0, "name[217]", (Type_Info*)&typeinfo_char},
+    {218, 0, 0, "name[218]", (Type_Info*)&typeinfo_char},
+    {219, 0, 0, "name[219]", (Type_Info*)&typeinfo_char},
+    {220, 0, 0, "name[220]", (Type_Info*)&typeinfo_char},
+    {221, 0, 0, "name[221]", (Type_Info*)&typeinfo_char},
+    {222, 0, 0, "name[222]", (Type_Info*)&typeinfo_char},
+    {223, 0, 0, "name[223]", (Type_Info*)&typeinfo_char},
+    {224, 0, 0, "name[224]", (Type_Info*)&typeinfo_char},
+    {225, 0, 0, "name[225]", (Type_Info*)&typeinfo_char},
+    {226, 0, 0, "name[226]", (Type_Info*)&typeinfo_char},
+    {227, 0, 0, "name[227]", (Type_Info*)&typeinfo_char},
+    {228, 0, 0, "name[228]", (Type_Info*)&typeinfo_char},
+    {229, 0, 0, "name[229]", (Type_Info*)&typeinfo_char},
+    {230, 0, 0, "name[230]", (Type_Info*)&typeinfo_char},
+    {231, 0, 0, "name[231]", (Type_Info*)&typeinfo_char},
+    {232, 0, 0, "name[232]", (Type_Info*)&typeinfo_char},
+    {233, 0, 0, "name[233]", (Type_Info*)&typeinfo_char},
+    {234, 0, 0, "name[234]", (Type_Info*)&typeinfo_char},
+    {235, 0, 0, "name[235]", (Type_Info*)&typeinfo_char},
+    {236, 0, 0, "name[236]", (Type_Info*)&typeinfo_char},
+    {237, 0, 0, "name[237]", (Type_Info*)&typeinfo_char},
+    {238, 0, 0, "name[238]", (Type_Info*)&typeinfo_char},
+    {239, 0, 0, "name[239]", (Type_Info*)&typeinfo_char},
+    {240, 0, 0, "name[240]", (Type_Info*)&typeinfo_char},
+    {241, 0, 0, "name[241]", (Type_Info*)&typeinfo_char},
+    {242, 0, 0, "name[242]", (Type_Info*)&typeinfo_char},
+    {243, 0, 0, "name[243]", (Type_Info*)&typeinfo_char},
+    {244, 0, 0, "name[244]", (Type_Info*)&typeinfo_char},
+    {245, 0, 0, "name[245]", (Type_Info*)&typeinfo_char},
+    {246, 0, 0, "name[246]", (Type_Info*)&typeinfo_char},
+    {247, 0, 0, "name[247]", (Type_Info*)&typeinfo_char},
+    {248, 0, 0, "name[248]", (Type_Info*)&typeinfo_char},
+    {249, 0, 0, "name[249]", (Type_Info*)&typeinfo_char},
+    {250, 0, 0, "name[250]", (Type_Info*)&typeinfo_char},
+    {251, 0, 0, "name[251]", (Type_Info*)&typeinfo_char},
+    {252, 0, 0, "name[252]", (Type_Info*)&typeinfo_char},
+    {253, 0, 0, "name[253]", (Type_Info*)&typeinfo_char},
+    {254, 0, 0, "name[254]", (Type_Info*)&typeinfo_char},
+    {255, 0, 0, "name[255]", (Type_Info*)&typeinfo_char},
+    {256, 0, 0, "test", (Type_Info*)&typeinfo_int},
+  }, 257
 };
 
 // enum Color
 // examples/print_types.h:30:9
 static Type_Info_Enum_Value values_Color[] = {
-  { (char*[]){ "Primary", "Secondary", NULL }, "COLOR_RED", 0 },
-  { (char*[]){ "Primary", NULL }, "COLOR_GREEN", 1 },
-  { (char*[]){ "Primary", NULL }, "COLOR_BLUE", 2 },
-  { (char*[]){ NULL }, "COLOR_YELLOW", 3 },
-  { (char*[]){ NULL }, "COLOR_CYAN", 4 },
-  { (char*[]){ NULL }, "COLOR_MAGENTA", 5 },
+  { (char*[]){ "Primary", "Secondary", NULL }, "COLOR_RED", 0, 9, TYPE_INFO_ANNOTATION_BIT(TI_ANN_Primary) | TYPE_INFO_ANNOTATION_BIT(TI_ANN_Secondary) },
+  { (char*[]){ "Primary", NULL }, "COLOR_GREEN", 1, 11, TYPE_INFO_ANNOTATION_BIT(TI_ANN_Primary) },
+  { (char*[]){ "Primary", NULL }, "COLOR_BLUE", 2, 10, TYPE_INFO_ANNOTATION_BIT(TI_ANN_Primary) },
+  { (char*[]){ NULL }, "COLOR_YELLOW", 3, 12, 0 },
+  { (char*[]){ NULL }, "COLOR_CYAN", 4, 10, 0 },
+  { (char*[]){ NULL }, "COLOR_MAGENTA", 5, 13, 0 },
 };
 Type_Info_Enum typeinfo_Color = {
-  { TYPE_TAG_ENUM, 4, 4 },
+  { TYPE_TAG_ENUM, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD },
   (char*[]){ NULL },
   "Color",
   values_Color,
-  sizeof(values_Color)/sizeof(*values_Color)
+  sizeof(values_Color)/sizeof(*values_Color),
+  0, (uint32_t[]){ 0, 1, 2, 3, 4, 5, }, 6, { NULL, NULL, 0 }, { (uint32_t[]){ 0, 1, 0, 0, 0, 7, 0, 0, }, (uint32_t[]){ 5, 4, 0, 3, 2, TYPE_INFO_INDEX_EMPTY, 1, TYPE_INFO_INDEX_EMPTY, }, 7 },
+  0,
+  0xb0e860eeb570ab23ULL,
+  false
 };
 
+// char[4]
+static Type_Info_Array typeinfo__array_2 = {{TYPE_TAG_ARRAY, 4, 1, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, 4, (Type_Info*)&typeinfo_char };
+
+// struct TestUnion::(unnamed at examples/print_types.h:43:5)
+static Type_Info_Struct typeinfo__struct_3 = {{TYPE_TAG_STRUCT, 8, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, (char*[]){ NULL }, "", (Type_Info_Member[]){
+  { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "y", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+}, 2, { (uint32_t[]){ 0, 0, }, (uint32_t[]){ 0, 1, }, 1 }, 0, NULL, (Type_Info_Byte_Range[]){{0, 8}}, 1, NULL, 0, 0xf3ad0fd01f56049dULL, NULL, 0 };
+
 // union TestUnion
 // examples/print_types.h:39:9
 static Type_Info_Member members_TestUnion[] = {
-  { (char*[]){ NULL }, "i", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "f", 0, (Type_Info*)&typeinfo_float, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "c", 0, (Type_Info*)&(Type_Info_Array){{TYPE_TAG_ARRAY, 4, 1}, 4, (Type_Info*)&typeinfo_char }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "anon_struct", 0, (Type_Info*)&(Type_Info_Struct){{TYPE_TAG_STRUCT, 8, 4}, (char*[]){ NULL }, "", (Type_Info_Member[]){
-    { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-    { (char*[]){ NULL }, "y", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-  }, 2 }, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ NULL }, "i", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "f", 0, (Type_Info*)&typeinfo_float, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "c", 0, (Type_Info*)&typeinfo__array_2, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "anon_struct", 0, (Type_Info*)&typeinfo__struct_3, TYPE_INFO_QUALIFIER_NONE, 11, 0, 0, 0 },
 };
 Type_Info_Union typeinfo_TestUnion = {
-  { TYPE_TAG_UNION, 8, 4 },
+  { TYPE_TAG_UNION, 8, 4, TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_UNIONS },
   (char*[]){ NULL },
   "TestUnion",
   members_TestUnion,
-  sizeof(members_TestUnion)/sizeof(*members_TestUnion)
+  sizeof(members_TestUnion)/sizeof(*members_TestUnion),
+  { (uint32_t[]){ 3, 0, 1, 0, }, (uint32_t[]){ 0, 1, 3, 2, }, 3 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 8}}, 1,
+  NULL, 0,
+  0x75b64cbe22d36178ULL,
+  NULL, 0
 };
 
+// enum TestAnonymousEnum::(unnamed at examples/print_types.h:50:5)
+static Type_Info_Enum typeinfo__enum_4 = {{TYPE_TAG_ENUM, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, (char*[]){ NULL }, "", (Type_Info_Enum_Value[]){
+  { (char*[]){ NULL }, "ANON_A", 0, 6, 0 },
+  { (char*[]){ NULL }, "ANON_B", 1, 6, 0 },
+  { (char*[]){ NULL }, "ANON_C", 2, 6, 0 },
+}, 3, 0, (uint32_t[]){ 0, 1, 2, }, 3, { NULL, NULL, 0 }, { (uint32_t[]){ 0, 0, 0, 2, }, (uint32_t[]){ 1, TYPE_INFO_INDEX_EMPTY, 2, 0, }, 3 }, 0, 0xfe285d8d58071ec2ULL, false };
+
 // struct TestAnonymousEnum
 // examples/print_types.h:49:9
 static Type_Info_Member members_TestAnonymousEnum[] = {
-  { (char*[]){ NULL }, "anon_enum_field", 0, (Type_Info*)&(Type_Info_Enum){{TYPE_TAG_ENUM, 4, 4}, (char*[]){ NULL }, "", (Type_Info_Enum_Value[]){
-    { (char*[]){ NULL }, "ANON_A", 0 },
-    { (char*[]){ NULL }, "ANON_B", 1 },
-    { (char*[]){ NULL }, "ANON_C", 2 },
-  }, 3 }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "other_field", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ NULL }, "anon_enum_field", 0, (Type_Info*)&typeinfo__enum_4, TYPE_INFO_QUALIFIER_NONE, 15, 0, 0, 0 },
+  { (char*[]){ NULL }, "other_field", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 11, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_TestAnonymousEnum = {
-  { TYPE_TAG_STRUCT, 8, 4 },
+  { TYPE_TAG_STRUCT, 8, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD },
   (char*[]){ NULL },
   "TestAnonymousEnum",
   members_TestAnonymousEnum,
-  sizeof(members_TestAnonymousEnum)/sizeof(*members_TestAnonymousEnum)
+  sizeof(members_TestAnonymousEnum)/sizeof(*members_TestAnonymousEnum),
+  { (uint32_t[]){ 3, 0, }, (uint32_t[]){ 1, 0, }, 1 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 8}}, 1,
+  NULL, 0,
+  0xba7dd97aad47c999ULL,
+  (Type_Info_Leaf[]){
+    {0, 0, 0, "anon_enum_field", (Type_Info*)&typeinfo__enum_4},
+    {4, 0, 0, "other_field", (Type_Info*)&typeinfo_int},
+  }, 2
 };
 
+// union TestUnnamedAnonymous::(anonymous at examples/print_types.h:57:9)
+static Type_Info_Union typeinfo__union_5 = {{TYPE_TAG_UNION, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_UNIONS}, (char*[]){ NULL }, "", (Type_Info_Member[]){
+  { (char*[]){ "X1", NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, TYPE_INFO_ANNOTATION_BIT(TI_ANN_X1), 0, 0 },
+  { (char*[]){ "Y1", NULL }, "y", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, TYPE_INFO_ANNOTATION_BIT(TI_ANN_Y1), 0, 0 },
+}, 2, { (uint32_t[]){ 0, 0, }, (uint32_t[]){ 0, 1, }, 1 }, 0, NULL, (Type_Info_Byte_Range[]){{0, 4}}, 1, NULL, 0, 0xf355ac9fd59090afULL, NULL, 0 };
+
+// struct TestUnnamedAnonymous::(anonymous at examples/print_types.h:56:5)
+static Type_Info_Struct typeinfo__struct_6 = {{TYPE_TAG_STRUCT, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_UNIONS}, (char*[]){ NULL }, "", (Type_Info_Member[]){
+  { (char*[]){ NULL }, "", 0, (Type_Info*)&typeinfo__union_5, TYPE_INFO_QUALIFIER_NONE, 0, 0, 0, 0 },
+}, 1, { (uint32_t[]){ 0, 0, }, (uint32_t[]){ 0, 0, }, 1 }, 0, NULL, (Type_Info_Byte_Range[]){{0, 4}}, 1, NULL, 0, 0x714fcd5465e0e111ULL, NULL, 0 };
+
 // struct TestUnnamedAnonymous
 // examples/print_types.h:54:9
 static Type_Info_Member members_TestUnnamedAnonymous[] = {
-  { (char*[]){ NULL }, "before", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "", 4, (Type_Info*)&(Type_Info_Struct){{TYPE_TAG_STRUCT, 4, 4}, (char*[]){ NULL }, "", (Type_Info_Member[]){
-    { (char*[]){ NULL }, "", 0, (Type_Info*)&(Type_Info_Union){{TYPE_TAG_UNION, 4, 4}, (char*[]){ NULL }, "", (Type_Info_Member[]){
-      { (char*[]){ "X1", NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-      { (char*[]){ "Y1", NULL }, "y", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-    }, 2 }, TYPE_INFO_QUALIFIER_NONE },
-  }, 1 }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "after", 8, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ NULL }, "before", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 6, 0, 0, 0 },
+  { (char*[]){ NULL }, "", 4, (Type_Info*)&typeinfo__struct_6, TYPE_INFO_QUALIFIER_NONE, 0, 0, 0, 0 },
+  { (char*[]){ NULL }, "after", 8, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 5, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_TestUnnamedAnonymous = {
-  { TYPE_TAG_STRUCT, 12, 4 },
+  { TYPE_TAG_STRUCT, 12, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_UNIONS },
   (char*[]){ NULL },
   "TestUnnamedAnonymous",
   members_TestUnnamedAnonymous,
-  sizeof(members_TestUnnamedAnonymous)/sizeof(*members_TestUnnamedAnonymous)
+  sizeof(members_TestUnnamedAnonymous)/sizeof(*members_TestUnnamedAnonymous),
+  { (uint32_t[]){ 0, 1, 0, 6, }, (uint32_t[]){ 2, 1, 0, 1, }, 3 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 12}}, 1,
+  NULL, 0,
+  0x0d8861695a3c099eULL,
+  (Type_Info_Leaf[]){
+    {0, 0, 0, "before", (Type_Info*)&typeinfo_int},
+    {8, 0, 0, "after", (Type_Info*)&typeinfo_int},
+  }, 2
 };
 
+// const char *
+static Type_Info_Pointer typeinfo__pointer_7 = {{TYPE_TAG_POINTER, sizeof(void*), 8, TYPE_INFO_TRAIT_HAS_POINTERS}, (Type_Info*)&typeinfo_char, TYPE_INFO_QUALIFIER_CONST };
+
+// char *
+static Type_Info_Pointer typeinfo__pointer_8 = {{TYPE_TAG_POINTER, sizeof(void*), 8, TYPE_INFO_TRAIT_HAS_POINTERS}, (Type_Info*)&typeinfo_char, TYPE_INFO_QUALIFIER_NONE };
+
 // struct TestQualifiers
 // examples/print_types.h:65:9
 static Type_Info_Member members_TestQualifiers[] = {
-  { (char*[]){ NULL }, "ci", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_CONST },
-  { (char*[]){ NULL }, "vi", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_VOLATILE },
-  { (char*[]){ NULL }, "cstr_ptr", 8, (Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), 8}, (Type_Info*)&typeinfo_char, TYPE_INFO_QUALIFIER_CONST }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "const_ptr", 16, (Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), 8}, (Type_Info*)&typeinfo_char, TYPE_INFO_QUALIFIER_NONE }, TYPE_INFO_QUALIFIER_CONST },
-  { (char*[]){ NULL }, "both", 24, (Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), 8}, (Type_Info*)&typeinfo_char, TYPE_INFO_QUALIFIER_CONST }, TYPE_INFO_QUALIFIER_CONST },
+  { (char*[]){ NULL }, "ci", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_CONST, 2, 0, 0, 0 },
+  { (char*[]){ NULL }, "vi", 4, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_VOLATILE, 2, 0, 0, 0 },
+  { (char*[]){ NULL }, "cstr_ptr", 8, (Type_Info*)&typeinfo__pointer_7, TYPE_INFO_QUALIFIER_NONE, 8, 0, 0, 0 },
+  { (char*[]){ NULL }, "const_ptr", 16, (Type_Info*)&typeinfo__pointer_8, TYPE_INFO_QUALIFIER_CONST, 9, 0, 0, 0 },
+  { (char*[]){ NULL }, "both", 24, (Type_Info*)&typeinfo__pointer_7, TYPE_INFO_QUALIFIER_CONST, 4, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_TestQualifiers = {
-  { TYPE_TAG_STRUCT, 32, 8 },
+  { TYPE_TAG_STRUCT, 32, 8, TYPE_INFO_TRAIT_HAS_POINTERS | TYPE_INFO_TRAIT_HAS_CONST },
   (char*[]){ NULL },
   "TestQualifiers",
   members_TestQualifiers,
-  sizeof(members_TestQualifiers)/sizeof(*members_TestQualifiers)
+  sizeof(members_TestQualifiers)/sizeof(*members_TestQualifiers),
+  { (uint32_t[]){ 0, 0, 0, 0, 0, 0, 0, 0, }, (uint32_t[]){ TYPE_INFO_INDEX_EMPTY, TYPE_INFO_INDEX_EMPTY, 2, TYPE_INFO_INDEX_EMPTY, 3, 1, 4, 0, }, 7 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 32}}, 1,
+  (Type_Info_Pointer_Slot[]){{8, false, (Type_Info*)&typeinfo_char}, {16, false, (Type_Info*)&typeinfo_char}, {24, false, (Type_Info*)&typeinfo_char}}, 3,
+  0x99a6c662ec2e3650ULL,
+  (Type_Info_Leaf[]){
+    {0, 0, 0, "ci", (Type_Info*)&typeinfo_int},
+    {4, 0, 0, "vi", (Type_Info*)&typeinfo_int},
+  }, 2
 };
 
+// Baz[3]
+static Type_Info_Array typeinfo__array_9 = {{TYPE_TAG_ARRAY, 48, 8, TYPE_INFO_TRAIT_HAS_POINTERS}, 3, (Type_Info*)&typeinfo_Baz };
+
+// struct Bar::(unnamed at examples/print_types.h:18:9)
+static Type_Info_Struct typeinfo__struct_10 = {{TYPE_TAG_STRUCT, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, (char*[]){ NULL }, "", (Type_Info_Member[]){
+  { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+}, 1, { (uint32_t[]){ 0, }, (uint32_t[]){ 0, }, 0 }, 0, NULL, (Type_Info_Byte_Range[]){{0, 4}}, 1, NULL, 0, 0xc15014442cd74c5eULL, NULL, 0 };
+
+// struct Bar::(unnamed at examples/print_types.h:17:5)
+static Type_Info_Struct typeinfo__struct_11 = {{TYPE_TAG_STRUCT, 4, 4, TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD}, (char*[]){ NULL }, "", (Type_Info_Member[]){
+  { (char*[]){ NULL }, "anon2", 0, (Type_Info*)&typeinfo__struct_10, TYPE_INFO_QUALIFIER_NONE, 5, 0, 0, 0 },
+}, 1, { (uint32_t[]){ 0, }, (uint32_t[]){ 0, }, 0 }, 0, NULL, (Type_Info_Byte_Range[]){{0, 4}}, 1, NULL, 0, 0x353779adcbfd26deULL, NULL, 0 };
+
 // struct Bar
 // examples/print_types.h:13:9
 static Type_Info_Member members_Bar[] = {
-  { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_unsigned_long, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "y", 8, (Type_Info*)&typeinfo_unsigned_long, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "baz", 16, (Type_Info*)&(Type_Info_Array){{TYPE_TAG_ARRAY, 48, 8}, 3, (Type_Info*)&typeinfo_Baz }, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "anon", 64, (Type_Info*)&(Type_Info_Struct){{TYPE_TAG_STRUCT, 4, 4}, (char*[]){ NULL }, "", (Type_Info_Member[]){
-    { (char*[]){ NULL }, "anon2", 0, (Type_Info*)&(Type_Info_Struct){{TYPE_TAG_STRUCT, 4, 4}, (char*[]){ NULL }, "", (Type_Info_Member[]){
-      { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_int, TYPE_INFO_QUALIFIER_NONE },
-    }, 1 }, TYPE_INFO_QUALIFIER_NONE },
-  }, 1 }, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ NULL }, "x", 0, (Type_Info*)&typeinfo_unsigned_long, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "y", 8, (Type_Info*)&typeinfo_unsigned_long, TYPE_INFO_QUALIFIER_NONE, 1, 0, 0, 0 },
+  { (char*[]){ NULL }, "baz", 16, (Type_Info*)&typeinfo__array_9, TYPE_INFO_QUALIFIER_NONE, 3, 0, 0, 0 },
+  { (char*[]){ NULL }, "anon", 64, (Type_Info*)&typeinfo__struct_11, TYPE_INFO_QUALIFIER_NONE, 4, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_Bar = {
-  { TYPE_TAG_STRUCT, 72, 8 },
+  { TYPE_TAG_STRUCT, 72, 8, TYPE_INFO_TRAIT_HAS_POINTERS | TYPE_INFO_TRAIT_HAS_PADDING },
   (char*[]){ NULL },
   "Bar",
   members_Bar,
-  sizeof(members_Bar)/sizeof(*members_Bar)
+  sizeof(members_Bar)/sizeof(*members_Bar),
+  { (uint32_t[]){ 0, 0, 6, 0, }, (uint32_t[]){ 2, 3, 0, 1, }, 3 },
+  0,
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 68}}, 1,
+  (Type_Info_Pointer_Slot[]){{24, false, (Type_Info*)&typeinfo_void}, {40, false, (Type_Info*)&typeinfo_void}, {56, false, (Type_Info*)&typeinfo_void}}, 3,
+  0x018cb973f1a6c97aULL,
+  NULL, 0
 };
 
+// void *
+static Type_Info_Pointer typeinfo__pointer_12 = {{TYPE_TAG_POINTER, sizeof(void*), 8, TYPE_INFO_TRAIT_HAS_POINTERS}, (Type_Info*)&typeinfo_void, TYPE_INFO_QUALIFIER_NONE };
+
 // struct Baz
 // examples/print_types.h:8:9
 static Type_Info_Member members_Baz[] = {
-  { (char*[]){ NULL }, "iptr", 0, (Type_Info*)&typeinfo_long, TYPE_INFO_QUALIFIER_NONE },
-  { (char*[]){ NULL }, "ptr", 8, (Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), 8}, (Type_Info*)&typeinfo_void, TYPE_INFO_QUALIFIER_NONE }, TYPE_INFO_QUALIFIER_NONE },
+  { (char*[]){ NULL }, "iptr", 0, (Type_Info*)&typeinfo_long, TYPE_INFO_QUALIFIER_NONE, 4, 0, 0, 0 },
+  { (char*[]){ NULL }, "ptr", 8, (Type_Info*)&typeinfo__pointer_12, TYPE_INFO_QUALIFIER_NONE, 3, 0, 0, 0 },
 };
 Type_Info_Struct typeinfo_Baz = {
-  { TYPE_TAG_STRUCT, 16, 8 },
+  { TYPE_TAG_STRUCT, 16, 8, TYPE_INFO_TRAIT_HAS_POINTERS },
   (char*[]){ "BazAnnotation", NULL },
   "Baz",
   members_Baz,
-  sizeof(members_Baz)/sizeof(*members_Baz)
+  sizeof(members_Baz)/sizeof(*members_Baz),
+  { (uint32_t[]){ 0, 1, }, (uint32_t[]){ 1, 0, }, 1 },
+  TYPE_INFO_ANNOTATION_BIT(TI_ANN_BazAnnotation),
+  NULL,
+  (Type_Info_Byte_Range[]){{0, 16}}, 1,
+  (Type_Info_Pointer_Slot[]){{8, false, (Type_Info*)&typeinfo_void}}, 1,
+  0x1eb48bbc9aa66cbbULL,
+  NULL, 0
 };
 
+// Registry of all the types above
+static Type_Info_Registry_Entry entries_typeinfo_registry[] = {
+  { "Foo", 3, (Type_Info*)&typeinfo_Foo },
+  { "Color", 5, (Type_Info*)&typeinfo_Color },
+  { "TestUnion", 9, (Type_Info*)&typeinfo_TestUnion },
+  { "TestAnonymousEnum", 17, (Type_Info*)&typeinfo_TestAnonymousEnum },
+  { "TestUnnamedAnonymous", 20, (Type_Info*)&typeinfo_TestUnnamedAnonymous },
+  { "TestQualifiers", 14, (Type_Info*)&typeinfo_TestQualifiers },
+  { "Bar", 3, (Type_Info*)&typeinfo_Bar },
+  { "Baz", 3, (Type_Info*)&typeinfo_Baz },
+};
+Type_Info_Registry typeinfo_registry = {
+  entries_typeinfo_registry,
+  sizeof(entries_typeinfo_registry)/sizeof(*entries_typeinfo_registry),
+  { (uint32_t[]){ 0, 0, 1, 0, 9, 0, 0, 68, }, (uint32_t[]){ 6, 7, 0, 4, 2, 5, 1, 3, }, 7 }
+};
@@ -21,12 +21,39 @@ extern Type_Info_Float typeinfo_double;
 extern Type_Info_Float typeinfo_long_double;
 
 extern Type_Info_Struct typeinfo_Foo; // examples/print_types.h:24:9
+#define TI_MAX_DEPTH_Foo 2
+#define TI_FINGERPRINT_Foo 0xa9bff7b50d8cee89ULL
 extern Type_Info_Enum typeinfo_Color; // examples/print_types.h:30:9 
+#define TI_FINGERPRINT_Color 0xb0e860eeb570ab23ULL
 extern Type_Info_Union typeinfo_TestUnion; // examples/print_types.h:39:9
+#define TI_MAX_DEPTH_TestUnion 2
+#define TI_FINGERPRINT_TestUnion 0x75b64cbe22d36178ULL
 extern Type_Info_Struct typeinfo_TestAnonymousEnum; // examples/print_types.h:49:9
+#define TI_MAX_DEPTH_TestAnonymousEnum 1
+#define TI_FINGERPRINT_TestAnonymousEnum 0xba7dd97aad47c999ULL
 extern Type_Info_Struct typeinfo_TestUnnamedAnonymous; // examples/print_types.h:54:9
+#define TI_MAX_DEPTH_TestUnnamedAnonymous 3
+#define TI_FINGERPRINT_TestUnnamedAnonymous 0x0d8861695a3c099eULL
 extern Type_Info_Struct typeinfo_TestQualifiers; // examples/print_types.h:65:9
+#define TI_MAX_DEPTH_TestQualifiers 1
+#define TI_FINGERPRINT_TestQualifiers 0x99a6c662ec2e3650ULL
 extern Type_Info_Struct typeinfo_Bar; // examples/print_types.h:13:9
+#define TI_MAX_DEPTH_Bar 3
+#define TI_FINGERPRINT_Bar 0x018cb973f1a6c97aULL
 extern Type_Info_Struct typeinfo_Baz; // examples/print_types.h:8:9
+#define TI_MAX_DEPTH_Baz 1
+#define TI_FINGERPRINT_Baz 0x1eb48bbc9aa66cbbULL
+
+extern Type_Info_Registry typeinfo_registry;
+
+// Annotation IDs, see `Type_Info_Annotation_Set`
+enum {
+    TI_ANN_CStr = 0,
+    TI_ANN_Primary = 1,
+    TI_ANN_Secondary = 2,
+    TI_ANN_X1 = 3,
+    TI_ANN_Y1 = 4,
+    TI_ANN_BazAnnotation = 5,
+};
 
 #endif // PRINT_TYPES_TYPEINFO_H_
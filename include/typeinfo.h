@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #ifdef RUNNING_TYPEINFO_METAPROGRAM
     #define TI_ROOT   __attribute__((annotate("__TypeInfoRoot")))
@@ -34,8 +35,22 @@ typedef enum {
     TYPE_TAG_STRUCT,
     TYPE_TAG_UNION,
     TYPE_TAG_ENUM,
+    TYPE_TAG_VECTOR,
 } Type_Info_Tag;
 
+#define TYPE_INFO_INDEX_EMPTY UINT32_MAX
+
+// Set of interned annotations. The metaprogram assigns an ID to each distinct annotation string it
+// encounters and emits it as an enum constant in the generated header (`TI_ANN_<annotation>` by
+// default, see `-annotation-prefix`). Only the first 64 annotations get a bit, the others are
+// only available through the `annotations` string arrays.
+typedef uint64_t Type_Info_Annotation_Set;
+
+#define TYPE_INFO_ANNOTATION_BIT(id) ((Type_Info_Annotation_Set)1 << (id))
+
+// Annotations the runtime looks for get the same ID in every generated file
+#define TYPE_INFO_ANNOTATION_CSTR 0  // `CStr`
+
 typedef enum {
     TYPE_INFO_QUALIFIER_NONE = 0,
     TYPE_INFO_QUALIFIER_CONST = 1 << 0,
@@ -43,12 +58,66 @@ typedef enum {
     TYPE_INFO_QUALIFIER_RESTRICT = 1 << 2,
 } Type_Info_Qualifier;
 
+// Properties of a type, computed by the metaprogram over all its members and elements, so that
+// generic code can choose a bulk path without walking the type
+typedef enum {
+    TYPE_INFO_TRAIT_NONE = 0,
+    TYPE_INFO_TRAIT_HAS_POINTERS = 1 << 0,
+    TYPE_INFO_TRAIT_HAS_PADDING = 1 << 1,  // Some bytes are not part of any member
+    TYPE_INFO_TRAIT_HAS_FLOATS = 1 << 2,
+    // Values are equal if and only if their bytes are: `ti_equal` and `ti_hash` work on the bytes
+    // of the value
+    TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE = 1 << 3,
+    // Plain data: no pointers nor flexible array members, a `memcpy` of `size` bytes makes a
+    // complete and independent copy. Without padding, the binary format is the bytes of the value.
+    TYPE_INFO_TRAIT_IS_POD = 1 << 4,
+    TYPE_INFO_TRAIT_HAS_FLEXIBLE_ARRAY = 1 << 5,
+    TYPE_INFO_TRAIT_HAS_UNIONS = 1 << 6,
+    TYPE_INFO_TRAIT_HAS_CONST = 1 << 7,  // Has `const` members or elements
+    TYPE_INFO_TRAIT_HAS_BITFIELDS = 1 << 8,
+} Type_Info_Trait;
+
 typedef struct {
     Type_Info_Tag tag;
     size_t size;
     size_t alignment;
+    uint32_t traits;  // Bitmask of `Type_Info_Trait`
 } Type_Info;
 
+// Perfect hash table generated by the metaprogram (hash and displace).
+// A key hashing to `h` can only be stored at `slots[ti_hash_mix(h ^ seeds[h & mask]) & mask]`, see
+// `ti_hash_index_get`. An index with `slots == NULL` is empty.
+typedef struct {
+    uint32_t* seeds;  // Per-bucket displacement, `mask + 1` entries
+    uint32_t* slots;  // Position in the indexed array, or TYPE_INFO_INDEX_EMPTY; `mask + 1` entries
+    uint32_t mask;    // Table size - 1. Table size is always a power of two
+} Type_Info_Hash_Index;
+
+// Compiled serialization program, see `ti_plan_get`
+typedef struct Type_Info_Plan Type_Info_Plan;
+
+// Range of bytes of a struct or union holding member data, i.e. not padding
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} Type_Info_Byte_Range;
+
+// Pointer stored in a struct, see `Type_Info_Struct`
+typedef struct {
+    uint32_t offset;
+    bool is_cstr;        // Annotated `CStr`: points to a NUL-terminated string
+    Type_Info* pointee;  // Type pointed to
+} Type_Info_Pointer_Slot;
+
+// Scalar reachable from a root struct, see `Type_Info_Struct`
+typedef struct {
+    uint32_t offset;      // From the start of the root
+    uint32_t bit_offset;  // For bitfields, as in `Type_Info_Member`
+    uint32_t bit_width;   // 0 for other leaves
+    const char* name;     // Path from the root, e.g. "items[2].position.x", see `ti_path_compile`
+    Type_Info* type;      // Integer, float, enum or vector
+} Type_Info_Leaf;
+
 typedef struct {
     Type_Info base;
 } Type_Info_Void;
@@ -75,6 +144,14 @@ typedef struct {
     Type_Info* element_type;
 } Type_Info_Array;
 
+// SIMD vector (`vector_size` or `ext_vector_type`) of integer or float lanes. `base.size` can be
+// larger than `num_lanes * lane_type->size`, e.g. 3 lanes are padded to 4: the lanes come first.
+typedef struct {
+    Type_Info base;
+    size_t num_lanes;
+    Type_Info* lane_type;
+} Type_Info_Vector;
+
 typedef struct {
     char** annotations;
     const char* name;
@@ -82,6 +159,13 @@ typedef struct {
     Type_Info* type;
     uint32_t qualifier_flags;  // Qualifiers applied to this struct or union member; Bitmask of
                                // `Type_Info_Qualifier`
+    size_t name_length;        // strlen(name)
+    Type_Info_Annotation_Set annotation_set;
+    // Bitfields only, see `ti_bitfield_get`: position of the first bit, counting from the least
+    // significant bit of the byte at `offset`, and number of bits. `bit_width` is 0 for other
+    // members.
+    uint32_t bit_offset;
+    uint32_t bit_width;
 } Type_Info_Member;
 
 typedef struct {
@@ -90,6 +174,26 @@ typedef struct {
     const char* name;
     Type_Info_Member* members;
     size_t members_count;
+    Type_Info_Hash_Index member_index;  // Perfect hash over member names, see `ti_find_member`
+    Type_Info_Annotation_Set annotation_set;
+    Type_Info_Plan* plan;  // Serialization plan, compiled on first use
+    // Sorted, non-adjacent ranges of bytes holding data, with nested structs, unions and arrays
+    // flattened. Bytes used by bitfields are included whole.
+    Type_Info_Byte_Range* data_ranges;
+    size_t data_ranges_count;
+    // Every pointer of the struct by increasing offset, with nested structs and arrays flattened.
+    // Pointers in unions and flexible arrays are not listed.
+    Type_Info_Pointer_Slot* pointers;
+    size_t pointers_count;
+    // Hash of the layout of the struct: member names, offsets, bitfield widths and types, with
+    // nested structs, unions and arrays included, and of every named type reachable through its
+    // pointers. Also `TI_FINGERPRINT_<Name>` in the generated header.
+    uint64_t fingerprint;
+    // `TI_ROOT` structs only: every scalar by offset, then bit offset for bitfields sharing a
+    // byte, with nested structs and arrays flattened. Pointers, unions and flexible arrays are
+    // left out.
+    Type_Info_Leaf* leaves;
+    size_t leaves_count;
 } Type_Info_Struct;
 
 typedef struct {
@@ -98,12 +202,24 @@ typedef struct {
     const char* name;
     Type_Info_Member* members;
     size_t members_count;
+    Type_Info_Hash_Index member_index;  // Perfect hash over member names, see `ti_find_member`
+    Type_Info_Annotation_Set annotation_set;
+    Type_Info_Plan* plan;  // Serialization plan, compiled on first use
+    Type_Info_Byte_Range* data_ranges;  // The bytes used by any member, see `Type_Info_Struct`
+    size_t data_ranges_count;
+    Type_Info_Pointer_Slot* pointers;  // Always empty: the active member is not known
+    size_t pointers_count;
+    uint64_t fingerprint;  // See `Type_Info_Struct`
+    Type_Info_Leaf* leaves;  // Always empty
+    size_t leaves_count;
 } Type_Info_Union;
 
 typedef struct {
     char** annotations;
     const char* name;
     long long value;
+    size_t name_length;  // strlen(name)
+    Type_Info_Annotation_Set annotation_set;
 } Type_Info_Enum_Value;
 
 typedef struct {
@@ -112,8 +228,257 @@ typedef struct {
     const char* name;
     Type_Info_Enum_Value* values;
     size_t values_count;
+    // Value -> `values` position lookup tables generated by the metaprogram, see `ti_enum_name`
+    long long min_value;
+    uint32_t* value_table;  // Dense enums: position of `min_value + i`, or TYPE_INFO_INDEX_EMPTY
+    size_t value_table_count;
+    Type_Info_Hash_Index value_index;  // Sparse enums: perfect hash over values
+    Type_Info_Hash_Index name_index;   // Perfect hash over names, see `ti_enum_parse`
+    Type_Info_Annotation_Set annotation_set;
+    uint64_t fingerprint;  // Hash of the size, names and values of the enum
+    bool is_signed;        // Whether the underlying integer type is signed
 } Type_Info_Enum;
 
+typedef struct {
+    const char* name;
+    size_t name_length;  // strlen(name)
+    Type_Info* type;
+} Type_Info_Registry_Entry;
+
+// Registry of all the named types emitted in a generated file, so that they can be looked up by
+// name at runtime. The metaprogram calls it `typeinfo_registry`, unless told otherwise with
+// `-registry <name>`.
+typedef struct {
+    Type_Info_Registry_Entry* entries;
+    size_t entries_count;
+    Type_Info_Hash_Index name_index;  // Perfect hash over type names
+} Type_Info_Registry;
+
+// Lookup helpers
+// These use the indices emitted by the metaprogram, falling back to a linear scan when a type info
+// has none (e.g. hand-written type infos).
+
+// FNV-1a. Must match `hash_bytes` in `typeinfo_metaprogram.c`
+static inline uint64_t ti_hash_bytes(const void* data, size_t len) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < len; i++) {
+        h ^= bytes[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// splitmix64 finalizer. Must match `hash_mix` in `typeinfo_metaprogram.c`
+static inline uint64_t ti_hash_mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+// Returns the position stored for hash `h`, or TYPE_INFO_INDEX_EMPTY. The caller still has to compare
+// the key, as keys not in the index may land on a used slot.
+static inline uint32_t ti_hash_index_get(const Type_Info_Hash_Index* index, uint64_t h) {
+    uint32_t seed = index->seeds[h & index->mask];
+    return index->slots[ti_hash_mix(h ^ seed) & index->mask];
+}
+
+// Finds the enumerator with the given value. If more enumerators share the same value, the first
+// declared one is returned.
+static inline Type_Info_Enum_Value* ti_enum_value(const Type_Info_Enum* e, long long value) {
+    uint32_t pos = TYPE_INFO_INDEX_EMPTY;
+    if(e->value_table) {
+        if(value >= e->min_value &&
+           (unsigned long long)value - (unsigned long long)e->min_value < e->value_table_count) {
+            pos = e->value_table[(unsigned long long)value - (unsigned long long)e->min_value];
+        }
+    } else if(e->value_index.slots) {
+        pos = ti_hash_index_get(&e->value_index, ti_hash_mix((uint64_t)value));
+    } else {
+        for(size_t i = 0; i < e->values_count; i++) {
+            if(e->values[i].value == value) return &e->values[i];
+        }
+    }
+    if(pos == TYPE_INFO_INDEX_EMPTY || e->values[pos].value != value) return NULL;
+    return &e->values[pos];
+}
+
+// Returns the name of the enumerator with the given value, or NULL if there is none
+static inline const char* ti_enum_name(const Type_Info_Enum* e, long long value) {
+    Type_Info_Enum_Value* v = ti_enum_value(e, value);
+    return v ? v->name : NULL;
+}
+
+// Finds the enumerator named by the `len` bytes at `name`, which need not be NUL-terminated
+static inline Type_Info_Enum_Value* ti_enum_value_named(const Type_Info_Enum* e, const char* name,
+                                                        size_t len) {
+    if(e->name_index.slots) {
+        uint32_t pos = ti_hash_index_get(&e->name_index, ti_hash_bytes(name, len));
+        if(pos == TYPE_INFO_INDEX_EMPTY || e->values[pos].name_length != len ||
+           memcmp(e->values[pos].name, name, len) != 0) {
+            return NULL;
+        }
+        return &e->values[pos];
+    }
+    for(size_t i = 0; i < e->values_count; i++) {
+        if(strlen(e->values[i].name) == len && memcmp(e->values[i].name, name, len) == 0) {
+            return &e->values[i];
+        }
+    }
+    return NULL;
+}
+
+// Parses the enumerator named by the `len` bytes at `name` into `out`. Returns false, leaving `out`
+// untouched, if there is no such enumerator.
+static inline bool ti_enum_parse(const Type_Info_Enum* e, const char* name, size_t len,
+                                 long long* out) {
+    Type_Info_Enum_Value* v = ti_enum_value_named(e, name, len);
+    if(!v) return false;
+    *out = v->value;
+    return true;
+}
+
+// Finds a member of a struct or union, named by the `len` bytes at `name` (which need not be
+// NUL-terminated). Like in C, members of anonymous structs and unions are found as if they were
+// members of `record`: use `ti_find_member_at` to also get their offset from the start of `record`,
+// as their `offset` is relative to the anonymous record containing them.
+static inline Type_Info_Member* ti_find_member_at(Type_Info* record, const char* name, size_t len,
+                                                  size_t* offset) {
+    Type_Info_Member* members;
+    size_t members_count;
+    Type_Info_Hash_Index* index;
+    switch(record->tag) {
+    case TYPE_TAG_STRUCT:
+        members = ((Type_Info_Struct*)record)->members;
+        members_count = ((Type_Info_Struct*)record)->members_count;
+        index = &((Type_Info_Struct*)record)->member_index;
+        break;
+    case TYPE_TAG_UNION:
+        members = ((Type_Info_Union*)record)->members;
+        members_count = ((Type_Info_Union*)record)->members_count;
+        index = &((Type_Info_Union*)record)->member_index;
+        break;
+    default:
+        return NULL;
+    }
+
+    if(len == 0) return NULL;
+
+    // The index maps names reachable through an anonymous member to the anonymous member itself
+    size_t first = 0, last = members_count;
+    if(index->slots) {
+        uint32_t pos = ti_hash_index_get(index, ti_hash_bytes(name, len));
+        if(pos == TYPE_INFO_INDEX_EMPTY) return NULL;
+        first = pos, last = pos + 1;
+    }
+
+    for(size_t i = first; i < last; i++) {
+        Type_Info_Member* m = &members[i];
+        if(m->name[0] == '\0') {
+            size_t inner_offset;
+            Type_Info_Member* inner = ti_find_member_at(m->type, name, len, &inner_offset);
+            if(inner) {
+                if(offset) *offset = m->offset + inner_offset;
+                return inner;
+            }
+        } else if((m->name_length ? m->name_length : strlen(m->name)) == len &&
+                  memcmp(m->name, name, len) == 0) {
+            if(offset) *offset = m->offset;
+            return m;
+        }
+    }
+
+    return NULL;
+}
+
+static inline Type_Info_Member* ti_find_member(Type_Info* record, const char* name, size_t len) {
+    return ti_find_member_at(record, name, len, NULL);
+}
+
+// Finds the type named by the `len` bytes at `name`, which need not be NUL-terminated
+static inline Type_Info* ti_registry_lookup(const Type_Info_Registry* registry, const char* name,
+                                            size_t len) {
+    if(registry->name_index.slots) {
+        uint32_t pos = ti_hash_index_get(&registry->name_index, ti_hash_bytes(name, len));
+        if(pos == TYPE_INFO_INDEX_EMPTY) return NULL;
+        Type_Info_Registry_Entry* entry = &registry->entries[pos];
+        if(entry->name_length != len || memcmp(entry->name, name, len) != 0) return NULL;
+        return entry->type;
+    }
+    for(size_t i = 0; i < registry->entries_count; i++) {
+        Type_Info_Registry_Entry* entry = &registry->entries[i];
+        if(entry->name_length == len && memcmp(entry->name, name, len) == 0) return entry->type;
+    }
+    return NULL;
+}
+
+// Tests for an annotation by its generated ID, e.g. `ti_has_annotation(m->annotation_set, TI_ANN_CStr)`
+static inline bool ti_has_annotation(Type_Info_Annotation_Set set, unsigned id) {
+    return id < 64 && (set & TYPE_INFO_ANNOTATION_BIT(id)) != 0;
+}
+
+// Bitfields
+// Bits are numbered as on little-endian ABIs: bit `i` of a member is bit `(bit_offset + i) % 8` of
+// the byte at `offset + (bit_offset + i) / 8`, so a bitfield spans `(bit_offset + bit_width + 7) / 8`
+// bytes. These work on the struct or union containing the member, use `ti_find_member_at` to get
+// the offset of members of anonymous records.
+
+// Reads `bit_width` bits starting at bit `bit_offset` of `bytes`, sign-extended to 64 bits if
+// `is_signed`
+static inline uint64_t ti_bits_get(const void* bytes, uint32_t bit_offset, uint32_t bit_width,
+                                   bool is_signed) {
+    const unsigned char* p = (const unsigned char*)bytes;
+    uint32_t end = bit_offset + bit_width;
+    uint64_t v = 0;
+    for(uint32_t i = 0; i < 8 && i * 8 < end; i++) v |= (uint64_t)p[i] << (i * 8);
+    v >>= bit_offset;
+    if(end > 64) v |= (uint64_t)p[8] << (64 - bit_offset);
+
+    if(bit_width >= 64) return v;
+    uint64_t mask = ((uint64_t)1 << bit_width) - 1;
+    v &= mask;
+    if(is_signed && bit_width > 0 && (v >> (bit_width - 1)) & 1) v |= ~mask;
+    return v;
+}
+
+// Writes the low `bit_width` bits of `value` starting at bit `bit_offset` of `bytes`, leaving the
+// other bits as they are
+static inline void ti_bits_set(void* bytes, uint32_t bit_offset, uint32_t bit_width,
+                               uint64_t value) {
+    unsigned char* p = (unsigned char*)bytes;
+    uint64_t mask = bit_width >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << bit_width) - 1;
+    value &= mask;
+    p[0] = (unsigned char)((p[0] & ~(mask << bit_offset)) | (value << bit_offset));
+    for(uint32_t i = 1; i * 8 < bit_offset + bit_width; i++) {
+        uint32_t shift = i * 8 - bit_offset;
+        p[i] = (unsigned char)((p[i] & ~(mask >> shift)) | (value >> shift));
+    }
+}
+
+// Reads the bitfield `m` of `record`, sign-extended to 64 bits if the type of `m` is signed
+static inline uint64_t ti_bitfield_get(const Type_Info_Member* m, const void* record) {
+    bool is_signed = false;
+    if(m->type->tag == TYPE_TAG_INTEGER) {
+        is_signed = ((const Type_Info_Integer*)m->type)->is_signed;
+    } else if(m->type->tag == TYPE_TAG_ENUM) {
+        is_signed = ((const Type_Info_Enum*)m->type)->is_signed;
+    }
+    return ti_bits_get((const char*)record + m->offset, m->bit_offset, m->bit_width, is_signed);
+}
+
+// Writes the low `bit_width` bits of `value` to the bitfield `m` of `record`
+static inline void ti_bitfield_set(const Type_Info_Member* m, void* record, uint64_t value) {
+    ti_bits_set((char*)record + m->offset, m->bit_offset, m->bit_width, value);
+}
+
+// Shorthands for the default registry. Require the generated header to be included.
+#define ti_lookup_type(name) ti_registry_lookup(&typeinfo_registry, name, strlen(name))
+#define ti_type_count()      (typeinfo_registry.entries_count)
+#define ti_type_at(i)        (typeinfo_registry.entries[i].type)
+
 // Struct describing any type.
 // It's composed by a typeinfo and a type-erased pointer to the value.
 typedef struct {
@@ -121,4 +486,3984 @@ typedef struct {
     Type_Info* type;
 } Type_Any;
 
+// Binary serialization
+// Values are written member by member in declaration order, without padding and in host byte
+// order. Unions are copied whole, as the active member is not known. Pointers are not followed:
+// they are skipped when serializing and set to NULL when deserializing. The serialized size of a
+// value only depends on its type.
+// `-emit-serializers` makes the metaprogram generate specialized `ti_serialize_<Name>` and
+// `ti_deserialize_<Name>` functions producing the same format.
+// These functions are defined in the `TYPEINFO_IMPL` section.
+
+size_t ti_serialized_size(const Type_Info* type);
+// Writes `ti_serialized_size(value.type)` bytes to `out`, returns the number of bytes written.
+// Structs and unions are (de)serialized through their plan, see `ti_plan_get`.
+size_t ti_serialize(Type_Any value, void* out);
+// Reads a value serialized by `ti_serialize`. Returns the number of bytes read, or 0 if `size` is
+// too small (in which case `out` is left untouched).
+size_t ti_deserialize(Type_Any out, const void* data, size_t size);
+
+// Serialization plans
+// A plan flattens a type into a linear program of bulk copies, with contiguous members and arrays of
+// scalars merged into a single copy and padding skipped, so that values can be (de)serialized
+// without walking the type info. This is what `ti_serialize` and `ti_deserialize` use for structs
+// and unions; it's useful on its own for types only known at runtime, where generated serializers
+// are not available.
+
+typedef enum {
+    TYPE_INFO_PLAN_COPY,  // Copy `size` bytes between the value and the serialized data
+    TYPE_INFO_PLAN_ZERO,  // Zero `size` bytes of the value when deserializing (pointers)
+    TYPE_INFO_PLAN_LOOP,  // Run the following `body_count` ops on each of `count` array elements
+    TYPE_INFO_PLAN_BITS,  // Copy `size` bytes of bitfields, clearing the bits not in `mask`
+} Type_Info_Plan_Op_Kind;
+
+typedef struct {
+    Type_Info_Plan_Op_Kind kind;
+    size_t value_offset;
+    size_t data_offset;
+    size_t size;        // For loops, the serialized size of an element
+    size_t count;       // Loops only
+    size_t stride;      // Loops only, the size of an element in the value
+    size_t body_count;  // Loops only. Offsets in the body are relative to the element
+    uint64_t mask;      // Bits only: bit `i` keeps bit `i % 8` of byte `i / 8`
+} Type_Info_Plan_Op;
+
+struct Type_Info_Plan {
+    size_t value_size;  // sizeof the type
+    size_t data_size;   // Serialized size of the type
+    size_t ops_count;
+    Type_Info_Plan_Op ops[];
+};
+
+// Returns the plan of a struct or union, compiling it on first use and caching it on the type info.
+// Returns NULL for other types, or if allocation fails. Threads may call it concurrently: each may
+// compile the plan on first use, but all get the one cached first. On compilers other than GCC,
+// Clang and MSVC, it is not synchronized: call it once before sharing a type info between threads.
+const Type_Info_Plan* ti_plan_get(Type_Info* type);
+// Compiles a plan for any type. Free it with `ti_plan_free`
+Type_Info_Plan* ti_plan_compile(const Type_Info* type);
+void ti_plan_free(Type_Info_Plan* plan);
+// (De)serializes an array of `count` values, laid out contiguously in memory and in the data
+size_t ti_plan_serialize(const Type_Info_Plan* plan, const void* values, size_t count, void* out);
+size_t ti_plan_deserialize(const Type_Info_Plan* plan, void* values, size_t count, const void* data,
+                           size_t size);
+
+// Growable byte buffer. Zero-initialize it before first use.
+typedef struct {
+    char* data;
+    size_t size, capacity;
+} Type_Info_Buffer;
+
+void ti_buffer_free(Type_Info_Buffer* buffer);
+
+// JSON
+// Structs and unions are written as objects (all the members of a union are written, as the active
+// one is not known), members of anonymous structs and unions as if they were members of the
+// enclosing record. Enums are written by name, or as a number if the value has no enumerator.
+// `char` arrays and pointers annotated with `CStr` are written as strings, other pointers are
+// followed, or written as `null` if NULL or pointing to `void`. NaN and infinities are written as
+// `null`, as JSON has no representation for them.
+
+#ifndef TI_JSON_MAX_DEPTH
+    #define TI_JSON_MAX_DEPTH 64  // Maximum number of pointers followed when encoding
+#endif
+
+// Appends the JSON encoding of `value` to `out`, keeping it NUL-terminated. Returns false, leaving
+// `out` as it was, if allocation fails or if more than `TI_JSON_MAX_DEPTH` pointers are followed
+// (e.g. on cycles).
+bool ti_json_encode(Type_Any value, Type_Info_Buffer* out);
+
+#ifndef TI_JSON_MAX_NESTING
+    #define TI_JSON_MAX_NESTING 128  // Maximum nesting of arrays and objects when decoding
+#endif
+
+// Decodes the `len` bytes of JSON at `json` into `out`, in place and without allocating. Accepts the
+// format written by `ti_json_encode`: object keys are looked up with `ti_find_member_at`, and
+// unknown keys are skipped. Members missing from an object and array elements past the end of a
+// JSON array are left untouched, as are non-pointer values set to `null`. Integers must be in the
+// range of their type, `true` and `false` are accepted as 1 and 0. Pointers set to `null` become
+// NULL, for other values the decoding continues into the pointee, which must already exist.
+// `CStr` strings must fit in their `char` array, and cannot be decoded into pointers.
+// Returns false on malformed JSON or values not matching the type, in which case `out` may be
+// partially written.
+bool ti_json_decode(const char* json, size_t len, Type_Any out);
+
+// Equality, hashing and ordering
+// Values are compared member by member, in declaration order. Floats compare by value, -0.0 being
+// equal to 0.0 and NaNs equal to each other and greater than any number. Pointers are followed, up
+// to `TI_MAX_POINTER_DEPTH` times, and `CStr` pointers compare as strings; pointers to `void`
+// compare by address. Unions compare as bytes, as the active member is not known. Padding is never
+// compared. For `TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE` types, members are not walked at all, and
+// structs without pointers nor floats only go through their `data_ranges`.
+
+#ifndef TI_MAX_POINTER_DEPTH
+    #define TI_MAX_POINTER_DEPTH 64  // Deeper pointers are compared by address
+#endif
+
+// Returns false if `a` and `b` have different types
+bool ti_equal(Type_Any a, Type_Any b);
+// Equal values have equal hashes
+uint64_t ti_hash(Type_Any value);
+// Returns <0, 0 or >0 as `a` is ordered before, equal to or after `b`, which must have the same
+// type. Integers and enums compare by value.
+int ti_compare(Type_Any a, Type_Any b);
+
+// Walking
+// `ti_walk` visits a value and everything inside it depth-first, in declaration order: the members
+// of structs, the elements of arrays and the values pointers point to. It keeps its stack on the
+// heap rather than recursing, and drops a struct or array when visiting its last member or element,
+// so following a linked list through its last member takes no stack at all. Entering a struct
+// prefetches what its pointers point to, so that the loads overlap with visiting the members
+// before them. Unions, vectors and pointers to `void` are not entered. Values are not remembered:
+// return `TYPE_INFO_WALK_SKIP` for values already seen to walk graphs with cycles.
+
+typedef enum {
+    TYPE_INFO_WALK_CONTINUE,  // Visit what is inside the value
+    TYPE_INFO_WALK_SKIP,      // Don't visit what is inside the value
+    TYPE_INFO_WALK_STOP,      // End the walk
+} Type_Info_Walk_Action;
+
+// Called for each value. `member` is the member holding it, NULL for the root, array elements and
+// pointees; the value of a bitfield is the byte at `member->offset`, read it with `ti_bits_get`.
+// `depth` is the number of structs, arrays and pointers entered to reach it.
+typedef Type_Info_Walk_Action (*Type_Info_Walk_Visitor)(Type_Any value,
+                                                        const Type_Info_Member* member,
+                                                        size_t depth, void* user);
+
+// Returns false if the visitor stopped the walk, or if out of memory
+bool ti_walk(Type_Any root, Type_Info_Walk_Visitor visitor, void* user);
+
+// Member paths
+// A path names values inside a type: members separated by dots, `[i]` for an element of an array or
+// a lane of a vector and `[*]` for all of them, e.g. "items[*].position.x". Members of anonymous
+// structs and unions are named as in C. Compiling a path resolves it once into offsets, so reading
+// it is an addition per value instead of a member lookup per segment. Paths can't go through
+// pointers, nor name bitfields.
+
+#ifndef TI_PATH_MAX_WILDCARDS
+    #define TI_PATH_MAX_WILDCARDS 4  // Maximum number of `[*]` in a path
+#endif
+
+// A `[*]` of a path. Wildcards over contiguous elements are merged, e.g. all of `short grid[2][3]`
+// is a single wildcard of 6 elements.
+typedef struct {
+    size_t stride;  // Bytes between consecutive elements
+    size_t count;
+} Type_Info_Path_Dim;
+
+typedef struct {
+    const Type_Info* type;  // Type of the values named
+    size_t offset;          // Of the first value named
+    size_t count;           // Values named: the product of the `dims` counts, 1 without wildcards
+    size_t dims_count;      // Wildcards, outermost first
+    Type_Info_Path_Dim dims[TI_PATH_MAX_WILDCARDS];
+} Type_Info_Path;
+
+// Resolves the NUL-terminated `path` in `root`. Returns false, leaving `out` as it was, if the
+// path is malformed, names something missing, indexes out of bounds or has more than
+// `TI_PATH_MAX_WILDCARDS` wildcards.
+bool ti_path_compile(Type_Info* root, const char* path, Type_Info_Path* out);
+// Copies the `count` values named by `path` in `root` next to each other into `out`, in the order
+// of `ti_path_at`, with a single copy for each run of contiguous values. Returns `path->count`.
+size_t ti_path_gather(const Type_Info_Path* path, const void* root, void* out);
+
+// Returns the address of the value named by `path` in `root`. With wildcards, returns the `i`-th
+// value named, `i` going from 0 to `path->count`, the last wildcard varying fastest.
+static inline void* ti_path_at(const Type_Info_Path* path, const void* root, size_t i) {
+    char* p = (char*)root + path->offset;
+    if(path->dims_count == 1) return p + i * path->dims[0].stride;
+    for(size_t d = path->dims_count; d-- > 0;) {
+        p += (i % path->dims[d].count) * path->dims[d].stride;
+        i /= path->dims[d].count;
+    }
+    return p;
+}
+
+// Deep copy
+// Available when extlib.h is included before this header. Pointers are found through the
+// `pointers` of structs (see `Type_Info_Pointer_Slot`) and assumed to point to a single value, at
+// the start of its allocation. `CStr` strings are followed too; pointers to `void` and pointers in
+// unions or flexible arrays are not. A value pointed to more than once is visited once, so shared
+// values and cycles are preserved.
+#ifdef EXTLIB_H
+// Copies `src` and everything reachable from it into `arena`, and returns the copy of `src`.
+// Values without pointers are copied with a single `memcpy`. Pointers that are not followed keep
+// pointing to the original values. Returns NULL if out of memory.
+void* ti_clone(Type_Any src, Ext_Arena* arena);
+// Frees everything reachable from `value` with `allocator`, but not `value` itself. Returns false,
+// without freeing anything, if out of memory.
+bool ti_destroy(Type_Any value, Ext_Allocator* allocator);
+// Moves the values reachable from `root` that were allocated in `from` into `to`, packed in
+// breadth-first order, and rewrites the pointers to them. Pointers to values outside of `from` are
+// left as is and not followed. Afterwards `from` can be reset, as long as nothing else in it is
+// used. Returns the new address of `root`, which is only moved if it is in `from`, or NULL if out
+// of memory.
+void* ti_relocate(Type_Any root, Ext_Arena* from, Ext_Arena* to);
+#endif  // EXTLIB_H
+
+// Snapshots
+// A snapshot is a file holding a value and everything reachable from it, like `ti_clone` would
+// copy it, with pointers stored as offsets from the pointer itself. Mapping it into memory is
+// immediate: pages are only read when accessed. Pointers not followed are stored as NULL, except
+// in unions. Snapshots are only valid for the platform that wrote them, and are checked against
+// the fingerprint of the root type.
+
+// Returns false on error
+bool ti_snapshot_write(Type_Any root, const char* path);
+// Maps a snapshot read-only, and returns its root value. Returns NULL on error, or if the root is
+// not of type `expected`.
+void* ti_snapshot_map(const char* path, const Type_Info* expected);
+// Unmaps a snapshot, given its root value
+void ti_snapshot_unmap(void* root);
+
+// Reads a pointer of a value in a snapshot
+static inline void* ti_snapshot_ptr(const void* field) {
+    intptr_t offset;
+    memcpy(&offset, field, sizeof(offset));
+    return offset ? (char*)field + offset : NULL;
+}
+
+// Schema migration
+// A migration converts values of an old version of a type into the current one, e.g. to upgrade
+// stored records after the struct that wrote them changed. Members of structs are matched by name,
+// looking through anonymous structs and unions like `ti_find_member`. Matching members are copied,
+// integers and enums are sign-extended or truncated, floats converted between sizes and integers
+// converted to floats, also from and to bitfields. Members that are new, or whose type changed in
+// any other way, are zeroed.
+// Arrays migrate their common elements and zero the others. Unions and pointees must be unchanged,
+// as compared by fingerprint. Padding of the new value is left untouched.
+
+typedef enum {
+    TYPE_INFO_MIGRATE_COPY,          // Copy `size` bytes
+    TYPE_INFO_MIGRATE_ZERO,          // Zero `size` bytes
+    TYPE_INFO_MIGRATE_INT,           // Convert an integer of `from_size` bytes to `size` bytes
+    TYPE_INFO_MIGRATE_FLOAT,         // Convert a float of `from_size` bytes to `size` bytes
+    TYPE_INFO_MIGRATE_INT_TO_FLOAT,  // Convert an integer of `from_size` bytes to a float
+    TYPE_INFO_MIGRATE_LOOP,  // Run the following `body_count` ops on each of `count` array elements
+} Type_Info_Migration_Op_Kind;
+
+typedef struct {
+    Type_Info_Migration_Op_Kind kind;
+    size_t to_offset;
+    size_t from_offset;
+    size_t size;        // Bytes written. For loops, the size of an element in the new value
+    size_t from_size;   // Conversions only. For loops, the size of an element in the old value
+    bool from_signed;   // Integer conversions only
+    size_t count;       // Loops only
+    size_t body_count;  // Loops only. Offsets in the body are relative to the element
+    // Conversions from and to bitfields, and zeroing of bitfields: the bits at the offsets, as in
+    // `Type_Info_Member`. Widths are 0 for other members.
+    uint32_t bit_offset;
+    uint32_t bit_width;
+    uint32_t from_bit_offset;
+    uint32_t from_bit_width;
+} Type_Info_Migration_Op;
+
+typedef struct {
+    uint64_t from_fingerprint;  // See `ti_migration_get`
+    uint64_t to_fingerprint;
+    size_t from_size;  // sizeof the old type
+    size_t to_size;    // sizeof the new type
+    size_t ops_count;
+    Type_Info_Migration_Op ops[];
+} Type_Info_Migration;
+
+// Returns the migration from `from` to `to`, compiling it on first use. Migrations are cached by
+// the fingerprints of the two types (by their address for types without one, e.g. scalars), so an
+// old type info rebuilt at runtime finds the migration compiled for an identical one. Returns NULL
+// if out of memory. This is not synchronized.
+const Type_Info_Migration* ti_migration_get(const Type_Info* from, const Type_Info* to);
+// Frees the migrations cached by `ti_migration_get`
+void ti_migration_cache_clear(void);
+// Compiles a migration without caching it. Free it with `ti_migration_free`
+Type_Info_Migration* ti_migration_compile(const Type_Info* from, const Type_Info* to);
+void ti_migration_free(Type_Info_Migration* migration);
+// Migrates an array of `count` old values at `from` into `to`, which must not overlap
+void ti_migrate(const Type_Info_Migration* migration, void* to, const void* from, size_t count);
+
+// Streaming decoding
+// A `Type_Info_Stream` decodes a value from data arriving in chunks of any size, e.g. from a
+// socket, writing it into the output as the data arrives. Instead of recursing, it keeps a stack of
+// frames for the structs, unions and arrays being decoded; `ti_max_depth` (or
+// `TI_MAX_DEPTH_<Name>` in the generated header) gives the number of frames needed for a type.
+// Decoding JSON into existing pointees needs additional frames for what they point to.
+
+typedef enum {
+    TYPE_INFO_STREAM_BINARY,  // The format of `ti_serialize`
+    TYPE_INFO_STREAM_JSON,    // JSON, decoded like `ti_json_decode`
+} Type_Info_Stream_Format;
+
+typedef enum {
+    TYPE_INFO_STREAM_NEED_MORE,  // The value is not complete yet, feed more data
+    TYPE_INFO_STREAM_DONE,
+    TYPE_INFO_STREAM_ERROR,
+} Type_Info_Stream_Status;
+
+// A struct, union or array being decoded
+typedef struct {
+    const Type_Info* type;
+    char* value;
+    size_t member_index;  // Next member of a struct or union
+    size_t array_index;   // Next element of an array
+} Type_Info_Stream_Frame;
+
+#ifndef TI_STREAM_TOKEN_MAX
+    #define TI_STREAM_TOKEN_MAX 256  // Maximum length of JSON keys, enumerator names and numbers
+#endif
+
+typedef struct {
+    Type_Info_Stream_Format format;
+    Type_Info_Stream_Status status;
+    Type_Info_Stream_Frame* frames;
+    size_t frames_count;
+    size_t frames_capacity;
+
+    // Binary: the scalar being copied
+    char* leaf;
+    size_t leaf_remaining;
+
+    // JSON
+    int state;
+    int string_kind;
+    size_t nesting;  // Containers open, the innermost ones past `frames_count` are skipped
+    uint64_t objects[(TI_JSON_MAX_NESTING + 63) / 64];  // Bit set when a container is an object
+    const Type_Info* target;  // Type of the next value, NULL when skipping it
+    char* target_value;
+    bool target_cstr;
+    // Bitfield targets are decoded into `bitfield_value`, then stored to the record
+    const Type_Info_Member* target_bitfield;
+    char* target_record;
+    uint64_t bitfield_value;
+    char* string;  // Destination of the string being decoded
+    size_t string_len, string_cap;
+    char escape[12];  // Escape sequence split between chunks
+    size_t escape_len;
+    char token[TI_STREAM_TOKEN_MAX];
+    size_t token_len;
+} Type_Info_Stream;
+
+// Number of frames needed to decode a type: its nesting of structs, unions and arrays
+size_t ti_max_depth(const Type_Info* type);
+// Starts decoding into `out`, using `frames` as the stack
+void ti_stream_init(Type_Info_Stream* stream, Type_Info_Stream_Format format, Type_Any out,
+                    Type_Info_Stream_Frame* frames, size_t frames_capacity);
+// Decodes the next chunk of data. `consumed`, if not NULL, is set to the number of bytes used: on
+// completion, the bytes after the value are left for the next one. Feeding 0 bytes marks the end of
+// the input, completing a top-level JSON number, or failing if the value is incomplete.
+Type_Info_Stream_Status ti_stream_feed(Type_Info_Stream* stream, const void* data, size_t size,
+                                       size_t* consumed);
+
 #endif  // TYPEINFO_H_
+
+#ifdef TYPEINFO_IMPL
+#ifndef TYPEINFO_IMPL_H_
+#define TYPEINFO_IMPL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define TI__HAS_MMAP
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+#if !defined(TI_MALLOC) || !defined(TI_REALLOC) || !defined(TI_FREE)
+    #define TI_MALLOC(size)       malloc(size)
+    #define TI_REALLOC(ptr, size) realloc(ptr, size)
+    #define TI_FREE(ptr)          free(ptr)
+#endif
+
+// -----------------------------------------------------------------------------
+// SECTION: Binary serialization
+//
+
+// Arrays and vectors: returns the type of their elements and sets `count`. Vectors are handled as
+// arrays of their lanes, leaving out the padding lanes.
+static const Type_Info* ti__elements(const Type_Info* type, size_t* count) {
+    if(type->tag == TYPE_TAG_VECTOR) {
+        const Type_Info_Vector* v = (const Type_Info_Vector*)type;
+        *count = v->num_lanes;
+        return v->lane_type;
+    }
+    const Type_Info_Array* a = (const Type_Info_Array*)type;
+    *count = a->num_elements;
+    return a->element_type;
+}
+
+// Reads an integer of `size` bytes, sign-extended to 64 bits if `is_signed`
+static uint64_t ti__load_int(const char* p, size_t size, bool is_signed) {
+    switch(size) {
+    case 1: {
+        uint8_t v;
+        memcpy(&v, p, sizeof(v));
+        return is_signed ? (uint64_t)(int64_t)(int8_t)v : v;
+    }
+    case 2: {
+        uint16_t v;
+        memcpy(&v, p, sizeof(v));
+        return is_signed ? (uint64_t)(int64_t)(int16_t)v : v;
+    }
+    case 4: {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return is_signed ? (uint64_t)(int64_t)(int32_t)v : v;
+    }
+    default: {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    }
+}
+
+// Writes the low `size` bytes of `v`
+static void ti__store_int(char* p, size_t size, uint64_t v) {
+    switch(size) {
+    case 1: {
+        uint8_t x = (uint8_t)v;
+        memcpy(p, &x, sizeof(x));
+    } break;
+    case 2: {
+        uint16_t x = (uint16_t)v;
+        memcpy(p, &x, sizeof(x));
+    } break;
+    case 4: {
+        uint32_t x = (uint32_t)v;
+        memcpy(p, &x, sizeof(x));
+    } break;
+    default:
+        memcpy(p, &v, sizeof(v));
+        break;
+    }
+}
+
+static bool ti__is_signed(const Type_Info* type) {
+    if(type->tag == TYPE_TAG_INTEGER) return ((const Type_Info_Integer*)type)->is_signed;
+    return type->tag == TYPE_TAG_ENUM && ((const Type_Info_Enum*)type)->is_signed;
+}
+
+// Reads a bitfield into `out`, as a value of the type of the member
+static const char* ti__bitfield_load(const Type_Info_Member* m, const char* record, uint64_t* out) {
+    ti__store_int((char*)out, m->type->size, ti_bitfield_get(m, record));
+    return (const char*)out;
+}
+
+// Writes a value of the type of the member to a bitfield. Returns false if it doesn't fit.
+static bool ti__bitfield_store(const Type_Info_Member* m, char* record, const uint64_t* in) {
+    uint64_t v = ti__load_int((const char*)in, m->type->size, ti__is_signed(m->type));
+    ti_bitfield_set(m, record, v);
+    return ti_bitfield_get(m, record) == v;
+}
+
+// Bitfields sharing bytes are serialized together, as the bytes they span with the bits of other
+// members cleared. Finds the bitfields sharing bytes with `members[first]`, returns the index of the
+// member following them and sets `size` to the bytes they span from `members[first].offset`.
+// Bit `i` of `mask` is set if bit `i % 8` of byte `i / 8` is used, past 8 bytes the bytes are
+// copied whole. Same as `push_bitfield_op` in `typeinfo_metaprogram.c`.
+static size_t ti__bitfield_run(const Type_Info_Member* members, size_t count, size_t first,
+                               size_t* size, uint64_t* mask) {
+    size_t start = members[first].offset, end = start;
+    *mask = 0;
+    size_t i = first;
+    for(; i < count && members[i].bit_width > 0 && (i == first || members[i].offset < end); i++) {
+        const Type_Info_Member* m = &members[i];
+        size_t m_end = m->offset + (m->bit_offset + m->bit_width + 7) / 8;
+        if(m_end > end) end = m_end;
+        size_t low = (m->offset - start) * 8 + m->bit_offset;
+        if(low + m->bit_width <= 64) {
+            uint64_t bits = m->bit_width >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << m->bit_width) - 1;
+            *mask |= bits << low;
+        }
+    }
+    *size = end - start;
+    if(*size > 8) *mask = ~(uint64_t)0;
+    return i;
+}
+
+// Whether a bitfield run uses all of its bytes, and can be copied as is
+static bool ti__bitfield_run_full(size_t size, uint64_t mask) {
+    return size >= 8 ? mask == ~(uint64_t)0 : mask == ((uint64_t)1 << (size * 8)) - 1;
+}
+
+static void ti__serialize_bits(char* out, const char* value, size_t size, uint64_t mask) {
+    for(size_t i = 0; i < size; i++) {
+        out[i] = (char)(value[i] & (i < 8 ? (char)(mask >> (i * 8)) : (char)0xFF));
+    }
+}
+
+// Types serialized as their bytes, with a single copy
+static bool ti__is_raw_serializable(const Type_Info* type) {
+    return (type->traits & (TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_PADDING)) ==
+           TYPE_INFO_TRAIT_IS_POD;
+}
+
+size_t ti_serialized_size(const Type_Info* type) {
+    if(ti__is_raw_serializable(type)) return type->size;
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+    case TYPE_TAG_POINTER:
+        return 0;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_FLOAT:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        return type->size;
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        return count * ti_serialized_size(elem);
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        size_t size = 0;
+        for(size_t i = 0; i < s->members_count;) {
+            if(s->members[i].bit_width > 0) {
+                size_t run;
+                uint64_t mask;
+                i = ti__bitfield_run(s->members, s->members_count, i, &run, &mask);
+                size += run;
+            } else {
+                size += ti_serialized_size(s->members[i++].type);
+            }
+        }
+        return size;
+    }
+    }
+    return 0;
+}
+
+static size_t ti__serialize(const Type_Info* type, const char* value, char* out) {
+    if(ti__is_raw_serializable(type)) {
+        memcpy(out, value, type->size);
+        return type->size;
+    }
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+    case TYPE_TAG_POINTER:
+        return 0;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_FLOAT:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        memcpy(out, value, type->size);
+        return type->size;
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        Type_Info_Tag elem_tag = elem->tag;
+        if(elem_tag == TYPE_TAG_INTEGER || elem_tag == TYPE_TAG_FLOAT || elem_tag == TYPE_TAG_ENUM) {
+            size_t size = count * elem->size;
+            memcpy(out, value, size);
+            return size;
+        }
+        size_t written = 0;
+        for(size_t i = 0; i < count; i++) {
+            written += ti__serialize(elem, value + i * elem->size, out + written);
+        }
+        return written;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        size_t written = 0;
+        for(size_t i = 0; i < s->members_count;) {
+            const Type_Info_Member* m = &s->members[i];
+            if(m->bit_width > 0) {
+                size_t run;
+                uint64_t mask;
+                i = ti__bitfield_run(s->members, s->members_count, i, &run, &mask);
+                ti__serialize_bits(out + written, value + m->offset, run, mask);
+                written += run;
+            } else {
+                written += ti__serialize(m->type, value + m->offset, out + written);
+                i++;
+            }
+        }
+        return written;
+    }
+    }
+    return 0;
+}
+
+static size_t ti__deserialize(const Type_Info* type, char* value, const char* data) {
+    if(ti__is_raw_serializable(type)) {
+        memcpy(value, data, type->size);
+        return type->size;
+    }
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return 0;
+    case TYPE_TAG_POINTER:
+        memset(value, 0, type->size);
+        return 0;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_FLOAT:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        memcpy(value, data, type->size);
+        return type->size;
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        Type_Info_Tag elem_tag = elem->tag;
+        if(elem_tag == TYPE_TAG_INTEGER || elem_tag == TYPE_TAG_FLOAT || elem_tag == TYPE_TAG_ENUM) {
+            size_t size = count * elem->size;
+            memcpy(value, data, size);
+            return size;
+        }
+        size_t read = 0;
+        for(size_t i = 0; i < count; i++) {
+            read += ti__deserialize(elem, value + i * elem->size, data + read);
+        }
+        return read;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        size_t read = 0;
+        for(size_t i = 0; i < s->members_count;) {
+            const Type_Info_Member* m = &s->members[i];
+            if(m->bit_width > 0) {
+                size_t run;
+                uint64_t mask;
+                i = ti__bitfield_run(s->members, s->members_count, i, &run, &mask);
+                memcpy(value + m->offset, data + read, run);
+                read += run;
+            } else {
+                read += ti__deserialize(m->type, value + m->offset, data + read);
+                i++;
+            }
+        }
+        return read;
+    }
+    }
+    return 0;
+}
+
+size_t ti_serialize(Type_Any value, void* out) {
+    if(ti__is_raw_serializable(value.type)) {
+        memcpy(out, value.value, value.type->size);
+        return value.type->size;
+    }
+    const Type_Info_Plan* plan = ti_plan_get(value.type);
+    if(plan) return ti_plan_serialize(plan, value.value, 1, out);
+    return ti__serialize(value.type, (const char*)value.value, (char*)out);
+}
+
+size_t ti_deserialize(Type_Any out, const void* data, size_t size) {
+    if(ti__is_raw_serializable(out.type)) {
+        if(size < out.type->size) return 0;
+        memcpy(out.value, data, out.type->size);
+        return out.type->size;
+    }
+    const Type_Info_Plan* plan = ti_plan_get(out.type);
+    if(plan) return ti_plan_deserialize(plan, out.value, 1, data, size);
+    if(size < ti_serialized_size(out.type)) return 0;
+    return ti__deserialize(out.type, (char*)out.value, (const char*)data);
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Serialization plans
+//
+
+typedef struct {
+    Type_Info_Plan_Op* items;
+    size_t size, capacity;
+    bool barrier;  // Don't merge the next op with the last one, it's the end of a loop body
+    bool failed;
+} Ti__Plan_Builder;
+
+static void ti__plan_push(Ti__Plan_Builder* b, Type_Info_Plan_Op op) {
+    if(!b->barrier && b->size > 0 && op.kind != TYPE_INFO_PLAN_LOOP &&
+       op.kind != TYPE_INFO_PLAN_BITS) {
+        Type_Info_Plan_Op* last = &b->items[b->size - 1];
+        if(last->kind == op.kind && last->value_offset + last->size == op.value_offset &&
+           (op.kind == TYPE_INFO_PLAN_ZERO || last->data_offset + last->size == op.data_offset)) {
+            last->size += op.size;
+            return;
+        }
+    }
+    b->barrier = false;
+
+    if(b->size == b->capacity) {
+        size_t capacity = b->capacity ? b->capacity * 2 : 16;
+        Type_Info_Plan_Op* items = TI_REALLOC(b->items, capacity * sizeof(*items));
+        if(!items) {
+            b->failed = true;
+            return;
+        }
+        b->items = items, b->capacity = capacity;
+    }
+    b->items[b->size++] = op;
+}
+
+// Same flattening as `collect_serializer_ops` in `typeinfo_metaprogram.c`
+static void ti__plan_compile(Ti__Plan_Builder* b, const Type_Info* type, size_t value_offset,
+                             size_t* data_offset) {
+    if(ti__is_raw_serializable(type) && type->size > 0) {
+        Type_Info_Plan_Op op = {
+            TYPE_INFO_PLAN_COPY, value_offset, *data_offset, type->size, 0, 0, 0, 0};
+        ti__plan_push(b, op);
+        *data_offset += type->size;
+        return;
+    }
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return;
+    case TYPE_TAG_POINTER: {
+        Type_Info_Plan_Op op = {
+            TYPE_INFO_PLAN_ZERO, value_offset, *data_offset, type->size, 0, 0, 0, 0};
+        ti__plan_push(b, op);
+        return;
+    }
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_FLOAT:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION: {
+        Type_Info_Plan_Op op = {
+            TYPE_INFO_PLAN_COPY, value_offset, *data_offset, type->size, 0, 0, 0, 0};
+        ti__plan_push(b, op);
+        *data_offset += type->size;
+        return;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->members_count;) {
+            const Type_Info_Member* m = &s->members[i];
+            if(m->bit_width > 0) {
+                size_t run;
+                uint64_t mask;
+                i = ti__bitfield_run(s->members, s->members_count, i, &run, &mask);
+                Type_Info_Plan_Op op = {TYPE_INFO_PLAN_BITS, value_offset + m->offset, *data_offset,
+                                        run, 0, 0, 0, mask};
+                if(ti__bitfield_run_full(run, mask)) op.kind = TYPE_INFO_PLAN_COPY, op.mask = 0;
+                ti__plan_push(b, op);
+                *data_offset += run;
+            } else {
+                ti__plan_compile(b, m->type, value_offset + m->offset, data_offset);
+                i++;
+            }
+        }
+        return;
+    }
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        size_t elem_size = elem->size;
+        if(count == 0) return;
+
+        Ti__Plan_Builder body = {0};
+        size_t elem_data_size = 0;
+        ti__plan_compile(&body, elem, 0, &elem_data_size);
+        if(body.failed) b->failed = true;
+
+        if(body.size == 1 &&
+           (body.items[0].kind == TYPE_INFO_PLAN_COPY || body.items[0].kind == TYPE_INFO_PLAN_ZERO) &&
+           body.items[0].size == elem_size) {
+            // Elements without padding: the whole array is a single op
+            Type_Info_Plan_Op op = {body.items[0].kind, value_offset, *data_offset,
+                                    count * elem_size, 0, 0, 0, 0};
+            ti__plan_push(b, op);
+        } else if(body.size > 0) {
+            Type_Info_Plan_Op loop = {TYPE_INFO_PLAN_LOOP, value_offset, *data_offset,
+                                      elem_data_size, count, elem_size, body.size, 0};
+            ti__plan_push(b, loop);
+            for(size_t i = 0; i < body.size; i++) {
+                b->barrier = true;  // Keep the body ops as they are
+                ti__plan_push(b, body.items[i]);
+            }
+            b->barrier = true;
+        }
+        *data_offset += count * elem_data_size;
+        TI_FREE(body.items);
+        return;
+    }
+    }
+}
+
+Type_Info_Plan* ti_plan_compile(const Type_Info* type) {
+    Ti__Plan_Builder b = {0};
+    size_t data_size = 0;
+    ti__plan_compile(&b, type, 0, &data_size);
+
+    Type_Info_Plan* plan = NULL;
+    if(!b.failed) plan = TI_MALLOC(sizeof(*plan) + b.size * sizeof(*b.items));
+    if(plan) {
+        plan->value_size = type->size;
+        plan->data_size = data_size;
+        plan->ops_count = b.size;
+        if(b.size) memcpy(plan->ops, b.items, b.size * sizeof(*b.items));
+    }
+    TI_FREE(b.items);
+    return plan;
+}
+
+void ti_plan_free(Type_Info_Plan* plan) {
+    TI_FREE(plan);
+}
+
+// The plan cached on a type info is published with a compare-and-swap, so that concurrent first
+// uses agree on a single plan. Without atomics, `ti_plan_get` is not synchronized.
+#if defined(__GNUC__) || defined(__clang__)
+static Type_Info_Plan* ti__plan_load(Type_Info_Plan** cached) {
+    return __atomic_load_n(cached, __ATOMIC_ACQUIRE);
+}
+
+// Stores `plan` in `*cached` if empty, returns the plan stored
+static Type_Info_Plan* ti__plan_publish(Type_Info_Plan** cached, Type_Info_Plan* plan) {
+    Type_Info_Plan* expected = NULL;
+    if(__atomic_compare_exchange_n(cached, &expected, plan, false, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE)) {
+        return plan;
+    }
+    return expected;
+}
+#elif defined(_MSC_VER)
+static Type_Info_Plan* ti__plan_load(Type_Info_Plan** cached) {
+    return (Type_Info_Plan*)_InterlockedCompareExchangePointer((void* volatile*)cached, NULL, NULL);
+}
+
+static Type_Info_Plan* ti__plan_publish(Type_Info_Plan** cached, Type_Info_Plan* plan) {
+    void* previous = _InterlockedCompareExchangePointer((void* volatile*)cached, plan, NULL);
+    return previous ? (Type_Info_Plan*)previous : plan;
+}
+#else
+static Type_Info_Plan* ti__plan_load(Type_Info_Plan** cached) {
+    return *cached;
+}
+
+static Type_Info_Plan* ti__plan_publish(Type_Info_Plan** cached, Type_Info_Plan* plan) {
+    if(!*cached) *cached = plan;
+    return *cached;
+}
+#endif
+
+const Type_Info_Plan* ti_plan_get(Type_Info* type) {
+    Type_Info_Plan** cached;
+    switch(type->tag) {
+    case TYPE_TAG_STRUCT:
+        cached = &((Type_Info_Struct*)type)->plan;
+        break;
+    case TYPE_TAG_UNION:
+        cached = &((Type_Info_Union*)type)->plan;
+        break;
+    default:
+        return NULL;
+    }
+    Type_Info_Plan* plan = ti__plan_load(cached);
+    if(plan) return plan;
+    plan = ti_plan_compile(type);
+    if(!plan) return NULL;
+    // Another thread may have published its plan meanwhile: keep the first one
+    Type_Info_Plan* published = ti__plan_publish(cached, plan);
+    if(published != plan) ti_plan_free(plan);
+    return published;
+}
+
+static void ti__plan_serialize(const Type_Info_Plan_Op* ops, size_t ops_count, const char* value,
+                               char* out) {
+    for(size_t i = 0; i < ops_count; i++) {
+        const Type_Info_Plan_Op* op = &ops[i];
+        switch(op->kind) {
+        case TYPE_INFO_PLAN_COPY:
+            memcpy(out + op->data_offset, value + op->value_offset, op->size);
+            break;
+        case TYPE_INFO_PLAN_ZERO:
+            break;
+        case TYPE_INFO_PLAN_BITS:
+            ti__serialize_bits(out + op->data_offset, value + op->value_offset, op->size, op->mask);
+            break;
+        case TYPE_INFO_PLAN_LOOP:
+            for(size_t e = 0; e < op->count; e++) {
+                ti__plan_serialize(op + 1, op->body_count, value + op->value_offset + e * op->stride,
+                                   out + op->data_offset + e * op->size);
+            }
+            i += op->body_count;
+            break;
+        }
+    }
+}
+
+static void ti__plan_deserialize(const Type_Info_Plan_Op* ops, size_t ops_count, char* value,
+                                 const char* data) {
+    for(size_t i = 0; i < ops_count; i++) {
+        const Type_Info_Plan_Op* op = &ops[i];
+        switch(op->kind) {
+        case TYPE_INFO_PLAN_COPY:
+        case TYPE_INFO_PLAN_BITS:  // The serialized bits not in the mask are 0
+            memcpy(value + op->value_offset, data + op->data_offset, op->size);
+            break;
+        case TYPE_INFO_PLAN_ZERO:
+            memset(value + op->value_offset, 0, op->size);
+            break;
+        case TYPE_INFO_PLAN_LOOP:
+            for(size_t e = 0; e < op->count; e++) {
+                ti__plan_deserialize(op + 1, op->body_count,
+                                     value + op->value_offset + e * op->stride,
+                                     data + op->data_offset + e * op->size);
+            }
+            i += op->body_count;
+            break;
+        }
+    }
+}
+
+size_t ti_plan_serialize(const Type_Info_Plan* plan, const void* values, size_t count, void* out) {
+    const char* value = (const char*)values;
+    char* data = (char*)out;
+    // A type made of a single copy is serialized as-is
+    if(plan->ops_count == 1 && plan->ops[0].kind == TYPE_INFO_PLAN_COPY &&
+       plan->ops[0].size == plan->value_size) {
+        memcpy(data, value, count * plan->value_size);
+        return count * plan->data_size;
+    }
+    for(size_t i = 0; i < count; i++) {
+        ti__plan_serialize(plan->ops, plan->ops_count, value, data);
+        value += plan->value_size;
+        data += plan->data_size;
+    }
+    return count * plan->data_size;
+}
+
+size_t ti_plan_deserialize(const Type_Info_Plan* plan, void* values, size_t count, const void* data,
+                           size_t size) {
+    if(plan->data_size && size / plan->data_size < count) return 0;
+    char* value = (char*)values;
+    const char* in = (const char*)data;
+    if(plan->ops_count == 1 && plan->ops[0].kind == TYPE_INFO_PLAN_COPY &&
+       plan->ops[0].size == plan->value_size) {
+        memcpy(value, in, count * plan->value_size);
+        return count * plan->data_size;
+    }
+    for(size_t i = 0; i < count; i++) {
+        ti__plan_deserialize(plan->ops, plan->ops_count, value, in);
+        value += plan->value_size;
+        in += plan->data_size;
+    }
+    return count * plan->data_size;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Buffer
+//
+
+// Makes room for `n` more bytes, plus the NUL terminator
+static bool ti__buffer_reserve(Type_Info_Buffer* b, size_t n) {
+    if(b->capacity - b->size > n) return true;
+    size_t capacity = b->capacity ? b->capacity : 256;
+    while(capacity - b->size <= n) capacity *= 2;
+    char* data = (char*)TI_REALLOC(b->data, capacity);
+    if(!data) return false;
+    b->data = data, b->capacity = capacity;
+    return true;
+}
+
+void ti_buffer_free(Type_Info_Buffer* buffer) {
+    TI_FREE(buffer->data);
+    buffer->data = NULL;
+    buffer->size = buffer->capacity = 0;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Number formatting
+//
+
+static const char ti__digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Writes at most 20 characters
+static char* ti__write_u64(char* p, uint64_t v) {
+    char tmp[20];
+    char* end = tmp + sizeof(tmp);
+    char* t = end;
+    while(v >= 100) {
+        unsigned i = (unsigned)(v % 100) * 2;
+        v /= 100;
+        t -= 2;
+        t[0] = ti__digit_pairs[i], t[1] = ti__digit_pairs[i + 1];
+    }
+    if(v >= 10) {
+        unsigned i = (unsigned)v * 2;
+        t -= 2;
+        t[0] = ti__digit_pairs[i], t[1] = ti__digit_pairs[i + 1];
+    } else {
+        *--t = (char)('0' + v);
+    }
+    memcpy(p, t, (size_t)(end - t));
+    return p + (end - t);
+}
+
+// Writes at most 20 characters
+static char* ti__write_i64(char* p, int64_t v) {
+    uint64_t u = (uint64_t)v;
+    if(v < 0) {
+        *p++ = '-';
+        u = 0 - u;
+    }
+    return ti__write_u64(p, u);
+}
+
+// Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers").
+// Produces the shortest, or very close to the shortest, digits that round-trip.
+
+typedef struct {
+    uint64_t f;
+    int e;
+} Ti__Diy_Fp;
+
+// 10^k for k = -348, -340, ..., 340, normalized
+static const uint64_t ti__cached_powers_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+
+static const int16_t ti__cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static const uint32_t ti__pow10[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+};
+
+static Ti__Diy_Fp ti__diy_fp_mul(Ti__Diy_Fp x, Ti__Diy_Fp y) {
+    const uint64_t m32 = 0xFFFFFFFFu;
+    uint64_t a = x.f >> 32, b = x.f & m32, c = y.f >> 32, d = y.f & m32;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+    tmp += 1u << 31;  // Round
+    Ti__Diy_Fp r = {ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+    return r;
+}
+
+static Ti__Diy_Fp ti__diy_fp_normalize(Ti__Diy_Fp x) {
+#if defined(__GNUC__) || defined(__clang__)
+    int shift = __builtin_clzll(x.f);
+    x.f <<= shift;
+    x.e -= shift;
+#else
+    while(!(x.f & (1ULL << 63))) {
+        x.f <<= 1;
+        x.e--;
+    }
+#endif
+    return x;
+}
+
+// Returns c = 10^-k such that the exponent of `c * 2^e` falls in [-60, -32]
+static Ti__Diy_Fp ti__cached_power(int e, int* k) {
+    double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = (int)dk;
+    if(dk - ik > 0.0) ik++;
+    int index = (ik >> 3) + 1;
+    *k = -(-348 + index * 8);
+    Ti__Diy_Fp c = {ti__cached_powers_f[index], ti__cached_powers_e[index]};
+    return c;
+}
+
+static void ti__grisu_round(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa,
+                            uint64_t wp_w) {
+    while(rest < wp_w && delta - rest >= ten_kappa &&
+          (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int ti__count_digits(uint32_t n) {
+    int digits = 1;
+    while(digits < 10 && n >= ti__pow10[digits]) digits++;
+    return digits;
+}
+
+static int ti__digit_gen(Ti__Diy_Fp w, Ti__Diy_Fp mp, uint64_t delta, char* buffer, int* k) {
+    Ti__Diy_Fp one = {1ULL << -mp.e, mp.e};
+    uint64_t wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> -one.e);
+    uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = ti__count_digits(p1);
+    int len = 0;
+
+    while(kappa > 0) {
+        uint32_t div = ti__pow10[kappa - 1];
+        uint32_t d = p1 / div;
+        p1 %= div;
+        if(d || len) buffer[len++] = (char)('0' + d);
+        kappa--;
+        uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+        if(rest <= delta) {
+            *k += kappa;
+            ti__grisu_round(buffer, len, delta, rest, (uint64_t)ti__pow10[kappa] << -one.e, wp_w);
+            return len;
+        }
+    }
+
+    for(;;) {
+        p2 *= 10;
+        delta *= 10;
+        char d = (char)(p2 >> -one.e);
+        if(d || len) buffer[len++] = (char)('0' + d);
+        p2 &= one.f - 1;
+        kappa--;
+        if(p2 < delta) {
+            *k += kappa;
+            int index = -kappa;
+            ti__grisu_round(buffer, len, delta, p2, one.f, wp_w * (index < 10 ? ti__pow10[index] : 0));
+            return len;
+        }
+    }
+}
+
+// Writes the digits of a positive, finite `value` to `buffer`, returns their count. The value is
+// `buffer * 10^k`. With `single` the digits are the shortest for the `float` nearest to `value`.
+static int ti__grisu2(double value, bool single, char* buffer, int* k) {
+    uint64_t f, hidden;
+    int e;
+    if(single) {
+        float fv = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &fv, sizeof(bits));
+        int biased = (int)((bits >> 23) & 0xFF);
+        hidden = 1ULL << 23;
+        f = bits & (hidden - 1);
+        if(biased) f += hidden, e = biased - 150;
+        else e = -149;
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        int biased = (int)((bits >> 52) & 0x7FF);
+        hidden = 1ULL << 52;
+        f = bits & (hidden - 1);
+        if(biased) f += hidden, e = biased - 1075;
+        else e = -1074;
+    }
+
+    Ti__Diy_Fp v = {f, e};
+    Ti__Diy_Fp plus = {(f << 1) + 1, e - 1};
+    Ti__Diy_Fp minus = {(f << 1) - 1, e - 1};
+    if(f == hidden) minus.f = (f << 2) - 1, minus.e = e - 2;  // The lower boundary is closer
+    plus = ti__diy_fp_normalize(plus);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    Ti__Diy_Fp c_mk = ti__cached_power(plus.e, k);
+    Ti__Diy_Fp w = ti__diy_fp_mul(ti__diy_fp_normalize(v), c_mk);
+    Ti__Diy_Fp wp = ti__diy_fp_mul(plus, c_mk);
+    Ti__Diy_Fp wm = ti__diy_fp_mul(minus, c_mk);
+    wm.f++;
+    wp.f--;
+    return ti__digit_gen(w, wp, wp.f - wm.f, buffer, k);
+}
+
+static char* ti__write_exponent(char* p, int k) {
+    if(k < 0) {
+        *p++ = '-';
+        k = -k;
+    }
+    if(k >= 100) {
+        *p++ = (char)('0' + k / 100);
+        k %= 100;
+        *p++ = (char)('0' + k / 10);
+    } else if(k >= 10) {
+        *p++ = (char)('0' + k / 10);
+    }
+    *p++ = (char)('0' + k % 10);
+    return p;
+}
+
+// Formats `len` digits times 10^k: 1234e7 -> 12340000000.0, 1234e-2 -> 12.34, 1234e-6 -> 0.001234,
+// 1e30 -> 1e30, 1234e30 -> 1.234e33
+static char* ti__prettify(char* buffer, int len, int k) {
+    int kk = len + k;  // 10^(kk - 1) <= value < 10^kk
+    if(k >= 0 && kk <= 21) {
+        for(int i = len; i < kk; i++) buffer[i] = '0';
+        buffer[kk] = '.';
+        buffer[kk + 1] = '0';
+        return buffer + kk + 2;
+    } else if(kk > 0 && kk <= 21) {
+        memmove(&buffer[kk + 1], &buffer[kk], (size_t)(len - kk));
+        buffer[kk] = '.';
+        return buffer + len + 1;
+    } else if(kk > -6 && kk <= 0) {
+        int offset = 2 - kk;
+        memmove(&buffer[offset], &buffer[0], (size_t)len);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        for(int i = 2; i < offset; i++) buffer[i] = '0';
+        return buffer + len + offset;
+    } else if(len == 1) {
+        buffer[1] = 'e';
+        return ti__write_exponent(&buffer[2], kk - 1);
+    } else {
+        memmove(&buffer[2], &buffer[1], (size_t)(len - 1));
+        buffer[1] = '.';
+        buffer[len + 1] = 'e';
+        return ti__write_exponent(&buffer[len + 2], kk - 1);
+    }
+}
+
+// Writes at most 32 characters
+static char* ti__write_double(char* p, double value, bool single) {
+    if(value != value || value - value != 0) {  // NaN or infinity
+        memcpy(p, "null", 4);
+        return p + 4;
+    }
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    if(bits >> 63) {
+        *p++ = '-';
+        value = -value;
+    }
+    if(value == 0) {
+        memcpy(p, "0.0", 3);
+        return p + 3;
+    }
+    int k;
+    int len = ti__grisu2(value, single, p, &k);
+    return ti__prettify(p, len, k);
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: JSON encoding
+//
+
+#define TI__BYTES(b) (0x0101010101010101ULL * (b))
+
+// True if any of the 8 bytes in `x` is a control character, '"' or '\\'
+static inline bool ti__json_needs_escape(uint64_t x) {
+    uint64_t quote = x ^ TI__BYTES('"');
+    uint64_t backslash = x ^ TI__BYTES('\\');
+    uint64_t t = (x - TI__BYTES(0x20)) & ~x;
+    t |= (quote - TI__BYTES(1)) & ~quote;
+    t |= (backslash - TI__BYTES(1)) & ~backslash;
+    return (t & TI__BYTES(0x80)) != 0;
+}
+
+static bool ti__json_write_string(Type_Info_Buffer* b, const char* s, size_t len) {
+    if(!ti__buffer_reserve(b, len * 6 + 2)) return false;
+    char* p = b->data + b->size;
+    *p++ = '"';
+
+    // Bytes that need no escaping are copied in runs, skipping over them 8 at a time
+    size_t i = 0, run = 0;
+    while(i < len) {
+        if(len - i >= 8) {
+            uint64_t x;
+            memcpy(&x, s + i, sizeof(x));
+            if(!ti__json_needs_escape(x)) {
+                i += 8;
+                continue;
+            }
+        }
+
+        unsigned char c = (unsigned char)s[i];
+        if(c >= 0x20 && c != '"' && c != '\\') {
+            i++;
+            continue;
+        }
+
+        memcpy(p, s + run, i - run);
+        p += i - run;
+        *p++ = '\\';
+        switch(c) {
+        case '"':
+            *p++ = '"';
+            break;
+        case '\\':
+            *p++ = '\\';
+            break;
+        case '\b':
+            *p++ = 'b';
+            break;
+        case '\f':
+            *p++ = 'f';
+            break;
+        case '\n':
+            *p++ = 'n';
+            break;
+        case '\r':
+            *p++ = 'r';
+            break;
+        case '\t':
+            *p++ = 't';
+            break;
+        default:
+            memcpy(p, "u00", 3);
+            p[3] = "0123456789abcdef"[c >> 4];
+            p[4] = "0123456789abcdef"[c & 0xF];
+            p += 5;
+            break;
+        }
+        run = ++i;
+    }
+    memcpy(p, s + run, len - run);
+    p += len - run;
+
+    *p++ = '"';
+    b->size = (size_t)(p - b->data);
+    return true;
+}
+
+static bool ti__json_write_raw(Type_Info_Buffer* b, const char* s, size_t len) {
+    if(!ti__buffer_reserve(b, len)) return false;
+    memcpy(b->data + b->size, s, len);
+    b->size += len;
+    return true;
+}
+
+// `char` arrays and pointers annotated with `CStr`
+static bool ti__is_cstr_member(const Type_Info_Member* m) {
+    const Type_Info* inner;
+    if(m->type->tag == TYPE_TAG_ARRAY) inner = ((const Type_Info_Array*)m->type)->element_type;
+    else if(m->type->tag == TYPE_TAG_POINTER) inner = ((const Type_Info_Pointer*)m->type)->pointer_to;
+    else return false;
+    if(!inner || inner->tag != TYPE_TAG_INTEGER || inner->size != 1) return false;
+    if(m->annotation_set) {
+        return (m->annotation_set & TYPE_INFO_ANNOTATION_BIT(TYPE_INFO_ANNOTATION_CSTR)) != 0;
+    }
+    // Hand-built members may only have the strings
+    for(char** it = m->annotations; it && *it; it++) {
+        if(strcmp(*it, "CStr") == 0) return true;
+    }
+    return false;
+}
+
+static long long ti__read_enum(const Type_Info* type, const char* value) {
+    switch(type->size) {
+    case 1: {
+        int8_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    case 2: {
+        int16_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    case 8: {
+        int64_t v;
+        memcpy(&v, value, sizeof(v));
+        return (long long)v;
+    }
+    default: {
+        int32_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    }
+}
+
+static bool ti__json_encode(Type_Info_Buffer* b, const Type_Info* type, const char* value, int depth);
+
+static bool ti__json_encode_members(Type_Info_Buffer* b, const Type_Info_Member* members,
+                                    size_t members_count, const char* value, bool* first,
+                                    int depth) {
+    for(size_t i = 0; i < members_count; i++) {
+        const Type_Info_Member* m = &members[i];
+        const char* field = value + m->offset;
+        uint64_t bits;
+        if(m->bit_width > 0) field = ti__bitfield_load(m, value, &bits);
+
+        if(m->name[0] == '\0') {
+            if(m->type->tag == TYPE_TAG_STRUCT) {
+                const Type_Info_Struct* s = (const Type_Info_Struct*)m->type;
+                if(!ti__json_encode_members(b, s->members, s->members_count, field, first, depth)) {
+                    return false;
+                }
+            } else if(m->type->tag == TYPE_TAG_UNION) {
+                const Type_Info_Union* u = (const Type_Info_Union*)m->type;
+                if(!ti__json_encode_members(b, u->members, u->members_count, field, first, depth)) {
+                    return false;
+                }
+            }
+            continue;
+        }
+
+        size_t name_length = m->name_length ? m->name_length : strlen(m->name);
+        if(!ti__buffer_reserve(b, name_length + 4)) return false;
+        char* p = b->data + b->size;
+        if(!*first) *p++ = ',';
+        *first = false;
+        *p++ = '"';
+        memcpy(p, m->name, name_length);
+        p += name_length;
+        *p++ = '"';
+        *p++ = ':';
+        b->size = (size_t)(p - b->data);
+
+        if(ti__is_cstr_member(m)) {
+            if(m->type->tag == TYPE_TAG_ARRAY) {
+                size_t n = ((const Type_Info_Array*)m->type)->num_elements;
+                const char* nul = (const char*)memchr(field, '\0', n);
+                if(!ti__json_write_string(b, field, nul ? (size_t)(nul - field) : n)) return false;
+            } else {
+                const char* str;
+                memcpy(&str, field, sizeof(str));
+                if(!(str ? ti__json_write_string(b, str, strlen(str))
+                         : ti__json_write_raw(b, "null", 4))) {
+                    return false;
+                }
+            }
+        } else if(!ti__json_encode(b, m->type, field, depth)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ti__json_encode(Type_Info_Buffer* b, const Type_Info* type, const char* value,
+                            int depth) {
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return ti__json_write_raw(b, "null", 4);
+
+    case TYPE_TAG_INTEGER: {
+        if(!ti__buffer_reserve(b, 20)) return false;
+        char* p = b->data + b->size;
+        bool is_signed = ((const Type_Info_Integer*)type)->is_signed;
+        switch(type->size) {
+        case 1: {
+            uint8_t v;
+            memcpy(&v, value, sizeof(v));
+            p = is_signed ? ti__write_i64(p, (int8_t)v) : ti__write_u64(p, v);
+        } break;
+        case 2: {
+            uint16_t v;
+            memcpy(&v, value, sizeof(v));
+            p = is_signed ? ti__write_i64(p, (int16_t)v) : ti__write_u64(p, v);
+        } break;
+        case 4: {
+            uint32_t v;
+            memcpy(&v, value, sizeof(v));
+            p = is_signed ? ti__write_i64(p, (int32_t)v) : ti__write_u64(p, v);
+        } break;
+        default: {
+            uint64_t v;
+            memcpy(&v, value, sizeof(v));
+            p = is_signed ? ti__write_i64(p, (int64_t)v) : ti__write_u64(p, v);
+        } break;
+        }
+        b->size = (size_t)(p - b->data);
+        return true;
+    }
+
+    case TYPE_TAG_FLOAT: {
+        if(!ti__buffer_reserve(b, 32)) return false;
+        char* p = b->data + b->size;
+        if(type->size == sizeof(float)) {
+            float v;
+            memcpy(&v, value, sizeof(v));
+            p = ti__write_double(p, v, true);
+        } else if(type->size == sizeof(double)) {
+            double v;
+            memcpy(&v, value, sizeof(v));
+            p = ti__write_double(p, v, false);
+        } else {
+            long double v;
+            memcpy(&v, value, sizeof(v));
+            p = ti__write_double(p, (double)v, false);
+        }
+        b->size = (size_t)(p - b->data);
+        return true;
+    }
+
+    case TYPE_TAG_ENUM: {
+        long long v = ti__read_enum(type, value);
+        const Type_Info_Enum_Value* ev = ti_enum_value((const Type_Info_Enum*)type, v);
+        if(ev) {
+            size_t name_length = ev->name_length ? ev->name_length : strlen(ev->name);
+            if(!ti__buffer_reserve(b, name_length + 2)) return false;
+            char* p = b->data + b->size;
+            *p++ = '"';
+            memcpy(p, ev->name, name_length);
+            p += name_length;
+            *p++ = '"';
+            b->size = (size_t)(p - b->data);
+            return true;
+        }
+        if(!ti__buffer_reserve(b, 20)) return false;
+        b->size = (size_t)(ti__write_i64(b->data + b->size, v) - b->data);
+        return true;
+    }
+
+    case TYPE_TAG_POINTER: {
+        const Type_Info* pointee = ((const Type_Info_Pointer*)type)->pointer_to;
+        const char* p;
+        memcpy(&p, value, sizeof(p));
+        if(!p || !pointee || pointee->tag == TYPE_TAG_VOID) return ti__json_write_raw(b, "null", 4);
+        if(depth >= TI_JSON_MAX_DEPTH) return false;
+        return ti__json_encode(b, pointee, p, depth + 1);
+    }
+
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        if(!ti__json_write_raw(b, "[", 1)) return false;
+        for(size_t i = 0; i < count; i++) {
+            if(i > 0 && !ti__json_write_raw(b, ",", 1)) return false;
+            if(!ti__json_encode(b, elem, value + i * elem->size, depth)) return false;
+        }
+        return ti__json_write_raw(b, "]", 1);
+    }
+
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION: {
+        const Type_Info_Member* members;
+        size_t members_count;
+        if(type->tag == TYPE_TAG_STRUCT) {
+            members = ((const Type_Info_Struct*)type)->members;
+            members_count = ((const Type_Info_Struct*)type)->members_count;
+        } else {
+            members = ((const Type_Info_Union*)type)->members;
+            members_count = ((const Type_Info_Union*)type)->members_count;
+        }
+        bool first = true;
+        if(!ti__json_write_raw(b, "{", 1)) return false;
+        if(!ti__json_encode_members(b, members, members_count, value, &first, depth)) return false;
+        return ti__json_write_raw(b, "}", 1);
+    }
+    }
+    return false;
+}
+
+bool ti_json_encode(Type_Any value, Type_Info_Buffer* out) {
+    size_t size = out->size;
+    if(!ti__json_encode(out, value.type, (const char*)value.value, 0)) {
+        out->size = size;
+        if(out->data) out->data[size] = '\0';
+        return false;
+    }
+    out->data[out->size] = '\0';
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: JSON decoding
+//
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int nesting;
+} Ti__Json_Parser;
+
+static void ti__json_skip_ws(Ti__Json_Parser* ps) {
+    while(ps->p < ps->end &&
+          (*ps->p == ' ' || *ps->p == '\n' || *ps->p == '\r' || *ps->p == '\t')) {
+        ps->p++;
+    }
+}
+
+static bool ti__json_consume(Ti__Json_Parser* ps, char c) {
+    ti__json_skip_ws(ps);
+    if(ps->p < ps->end && *ps->p == c) {
+        ps->p++;
+        return true;
+    }
+    return false;
+}
+
+static bool ti__json_consume_literal(Ti__Json_Parser* ps, const char* literal, size_t len) {
+    if((size_t)(ps->end - ps->p) < len || memcmp(ps->p, literal, len) != 0) return false;
+    ps->p += len;
+    return true;
+}
+
+// Scans a string, leaving `*str` pointing to its raw (still escaped) contents
+static bool ti__json_scan_string(Ti__Json_Parser* ps, const char** str, size_t* len,
+                                 bool* escaped) {
+    if(!ti__json_consume(ps, '"')) return false;
+    const char* start = ps->p;
+    *escaped = false;
+    while(ps->p < ps->end) {
+        // Skip 8 plain bytes at a time
+        if(ps->end - ps->p >= 8) {
+            uint64_t x;
+            memcpy(&x, ps->p, sizeof(x));
+            if(!ti__json_needs_escape(x)) {
+                ps->p += 8;
+                continue;
+            }
+        }
+        unsigned char c = (unsigned char)*ps->p;
+        if(c == '"') {
+            *str = start;
+            *len = (size_t)(ps->p - start);
+            ps->p++;
+            return true;
+        } else if(c == '\\') {
+            *escaped = true;
+            ps->p += 2;
+        } else if(c < 0x20) {
+            return false;
+        } else {
+            ps->p++;
+        }
+    }
+    return false;
+}
+
+static int ti__json_hex4(const char* p) {
+    int v = 0;
+    for(int i = 0; i < 4; i++) {
+        char c = p[i];
+        v <<= 4;
+        if(c >= '0' && c <= '9') v |= c - '0';
+        else if(c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else if(c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+// Unescapes the raw contents of a string into `dst`, returns false if it doesn't fit in `cap` bytes
+static bool ti__json_unescape(const char* src, size_t len, char* dst, size_t cap, size_t* out_len) {
+    const char* end = src + len;
+    size_t n = 0;
+    while(src < end) {
+        const char* backslash = (const char*)memchr(src, '\\', (size_t)(end - src));
+        size_t run = backslash ? (size_t)(backslash - src) : (size_t)(end - src);
+        if(run > cap - n) return false;
+        memcpy(dst + n, src, run);
+        n += run;
+        src += run;
+        if(!backslash) break;
+
+        if(end - src < 2) return false;
+        char c = src[1];
+        src += 2;
+        char simple;
+        switch(c) {
+        case '"':
+        case '\\':
+        case '/':
+            simple = c;
+            break;
+        case 'b':
+            simple = '\b';
+            break;
+        case 'f':
+            simple = '\f';
+            break;
+        case 'n':
+            simple = '\n';
+            break;
+        case 'r':
+            simple = '\r';
+            break;
+        case 't':
+            simple = '\t';
+            break;
+        case 'u': {
+            if(end - src < 4) return false;
+            long cp = ti__json_hex4(src);
+            if(cp < 0) return false;
+            src += 4;
+            if(cp >= 0xD800 && cp <= 0xDBFF) {  // Surrogate pair
+                if(end - src < 6 || src[0] != '\\' || src[1] != 'u') return false;
+                int low = ti__json_hex4(src + 2);
+                if(low < 0xDC00 || low > 0xDFFF) return false;
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                src += 6;
+            } else if(cp >= 0xDC00 && cp <= 0xDFFF) {
+                return false;
+            }
+
+            char utf8[4];
+            size_t utf8_len;
+            if(cp < 0x80) {
+                utf8[0] = (char)cp, utf8_len = 1;
+            } else if(cp < 0x800) {
+                utf8[0] = (char)(0xC0 | (cp >> 6));
+                utf8[1] = (char)(0x80 | (cp & 0x3F));
+                utf8_len = 2;
+            } else if(cp < 0x10000) {
+                utf8[0] = (char)(0xE0 | (cp >> 12));
+                utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                utf8[2] = (char)(0x80 | (cp & 0x3F));
+                utf8_len = 3;
+            } else {
+                utf8[0] = (char)(0xF0 | (cp >> 18));
+                utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+                utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                utf8[3] = (char)(0x80 | (cp & 0x3F));
+                utf8_len = 4;
+            }
+            if(utf8_len > cap - n) return false;
+            memcpy(dst + n, utf8, utf8_len);
+            n += utf8_len;
+            continue;
+        }
+        default:
+            return false;
+        }
+        if(n == cap) return false;
+        dst[n++] = simple;
+    }
+    *out_len = n;
+    return true;
+}
+
+typedef struct {
+    const char* start;
+    size_t len;
+    bool negative;
+    bool is_integer;  // No fraction nor exponent
+    bool overflow;    // The digits don't fit in `mantissa`
+    uint64_t mantissa;
+    int exponent;  // Decimal exponent, including the fraction digits
+} Ti__Json_Number;
+
+static bool ti__json_scan_number(Ti__Json_Parser* ps, Ti__Json_Number* n) {
+    ti__json_skip_ws(ps);
+    const char* p = ps->p;
+    const char* end = ps->end;
+    memset(n, 0, sizeof(*n));
+    n->start = p;
+    n->is_integer = true;
+
+    if(p < end && *p == '-') n->negative = true, p++;
+    if(p == end || *p < '0' || *p > '9') return false;
+    if(*p == '0') {
+        p++;
+    } else {
+        while(p < end && *p >= '0' && *p <= '9') {
+            unsigned d = (unsigned)(*p++ - '0');
+            if(n->mantissa > (UINT64_MAX - d) / 10) n->overflow = true, n->exponent++;
+            else n->mantissa = n->mantissa * 10 + d;
+        }
+    }
+    if(p < end && *p == '.') {
+        p++;
+        n->is_integer = false;
+        if(p == end || *p < '0' || *p > '9') return false;
+        while(p < end && *p >= '0' && *p <= '9') {
+            unsigned d = (unsigned)(*p++ - '0');
+            if(n->mantissa > (UINT64_MAX - d) / 10) {
+                n->overflow = true;
+            } else {
+                n->mantissa = n->mantissa * 10 + d;
+                n->exponent--;
+            }
+        }
+    }
+    if(p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        n->is_integer = false;
+        bool negative_exp = false;
+        if(p < end && (*p == '+' || *p == '-')) negative_exp = *p++ == '-';
+        if(p == end || *p < '0' || *p > '9') return false;
+        int e = 0;
+        while(p < end && *p >= '0' && *p <= '9') {
+            if(e < 100000) e = e * 10 + (*p - '0');
+            p++;
+        }
+        n->exponent += negative_exp ? -e : e;
+    }
+
+    n->len = (size_t)(p - n->start);
+    ps->p = p;
+    return true;
+}
+
+static bool ti__json_number_to_double(const Ti__Json_Number* n, double* out) {
+    // Exact when both the mantissa and the power of ten are exactly representable
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                   1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    if(!n->overflow && n->mantissa <= (1ULL << 53) && n->exponent >= -22 && n->exponent <= 22) {
+        double v = (double)n->mantissa;
+        v = n->exponent < 0 ? v / pow10[-n->exponent] : v * pow10[n->exponent];
+        *out = n->negative ? -v : v;
+        return true;
+    }
+
+    char buf[128];
+    if(n->len >= sizeof(buf)) return false;
+    memcpy(buf, n->start, n->len);
+    buf[n->len] = '\0';
+    *out = strtod(buf, NULL);
+    return true;
+}
+
+static bool ti__json_skip_value(Ti__Json_Parser* ps) {
+    ti__json_skip_ws(ps);
+    if(ps->p == ps->end) return false;
+    switch(*ps->p) {
+    case '"': {
+        const char* str;
+        size_t len;
+        bool escaped;
+        return ti__json_scan_string(ps, &str, &len, &escaped);
+    }
+    case '{':
+    case '[': {
+        char close = *ps->p == '{' ? '}' : ']';
+        bool object = close == '}';
+        if(++ps->nesting > TI_JSON_MAX_NESTING) return false;
+        ps->p++;
+        if(!ti__json_consume(ps, close)) {
+            do {
+                if(object) {
+                    const char* key;
+                    size_t len;
+                    bool escaped;
+                    if(!ti__json_scan_string(ps, &key, &len, &escaped)) return false;
+                    if(!ti__json_consume(ps, ':')) return false;
+                }
+                if(!ti__json_skip_value(ps)) return false;
+            } while(ti__json_consume(ps, ','));
+            if(!ti__json_consume(ps, close)) return false;
+        }
+        ps->nesting--;
+        return true;
+    }
+    case 't':
+        return ti__json_consume_literal(ps, "true", 4);
+    case 'f':
+        return ti__json_consume_literal(ps, "false", 5);
+    case 'n':
+        return ti__json_consume_literal(ps, "null", 4);
+    default: {
+        Ti__Json_Number n;
+        return ti__json_scan_number(ps, &n);
+    }
+    }
+}
+
+static bool ti__json_decode(Ti__Json_Parser* ps, const Type_Info* type, char* value);
+
+static bool ti__json_decode_integer(Ti__Json_Parser* ps, const Type_Info* type, char* value) {
+    bool is_signed = ((const Type_Info_Integer*)type)->is_signed;
+    uint64_t magnitude;
+    bool negative = false;
+    if(ti__json_consume_literal(ps, "true", 4)) {
+        magnitude = 1;
+    } else if(ti__json_consume_literal(ps, "false", 5)) {
+        magnitude = 0;
+    } else {
+        Ti__Json_Number n;
+        if(!ti__json_scan_number(ps, &n) || !n.is_integer || n.overflow) return false;
+        magnitude = n.mantissa;
+        negative = n.negative && magnitude != 0;
+    }
+
+    size_t bits = type->size * 8;
+    uint64_t max = bits >= 64 ? UINT64_MAX : (1ULL << bits) - 1;
+    uint64_t u;
+    if(is_signed) {
+        uint64_t max_positive = max >> 1;
+        if(negative ? magnitude > max_positive + 1 : magnitude > max_positive) return false;
+        u = negative ? 0 - magnitude : magnitude;
+    } else {
+        if(negative || magnitude > max) return false;
+        u = magnitude;
+    }
+
+    switch(type->size) {
+    case 1: {
+        uint8_t v = (uint8_t)u;
+        memcpy(value, &v, sizeof(v));
+    } break;
+    case 2: {
+        uint16_t v = (uint16_t)u;
+        memcpy(value, &v, sizeof(v));
+    } break;
+    case 4: {
+        uint32_t v = (uint32_t)u;
+        memcpy(value, &v, sizeof(v));
+    } break;
+    case 8:
+        memcpy(value, &u, sizeof(u));
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+static void ti__write_enum(const Type_Info* type, char* value, long long v) {
+    switch(type->size) {
+    case 1: {
+        int8_t x = (int8_t)v;
+        memcpy(value, &x, sizeof(x));
+    } break;
+    case 2: {
+        int16_t x = (int16_t)v;
+        memcpy(value, &x, sizeof(x));
+    } break;
+    case 8: {
+        int64_t x = (int64_t)v;
+        memcpy(value, &x, sizeof(x));
+    } break;
+    default: {
+        int32_t x = (int32_t)v;
+        memcpy(value, &x, sizeof(x));
+    } break;
+    }
+}
+
+static bool ti__json_decode_enum(Ti__Json_Parser* ps, const Type_Info* type, char* value) {
+    const Type_Info_Enum* e = (const Type_Info_Enum*)type;
+    long long v;
+    ti__json_skip_ws(ps);
+    if(ps->p < ps->end && *ps->p == '"') {
+        const char* name;
+        size_t len;
+        bool escaped;
+        if(!ti__json_scan_string(ps, &name, &len, &escaped) || escaped) return false;
+        if(!ti_enum_parse(e, name, len, &v)) return false;
+    } else {
+        Ti__Json_Number n;
+        if(!ti__json_scan_number(ps, &n) || !n.is_integer || n.overflow ||
+           n.mantissa > (uint64_t)INT64_MAX) {
+            return false;
+        }
+        v = n.negative ? -(long long)n.mantissa : (long long)n.mantissa;
+    }
+    ti__write_enum(type, value, v);
+    return true;
+}
+
+static bool ti__json_decode_cstr(Ti__Json_Parser* ps, const Type_Info_Member* m, char* field) {
+    ti__json_skip_ws(ps);
+    if(m->type->tag == TYPE_TAG_POINTER) {
+        // No storage to decode into
+        if(!ti__json_consume_literal(ps, "null", 4)) return false;
+        memset(field, 0, m->type->size);
+        return true;
+    }
+
+    const char* str;
+    size_t len;
+    bool escaped;
+    if(ti__json_consume_literal(ps, "null", 4)) return true;
+    if(!ti__json_scan_string(ps, &str, &len, &escaped)) return false;
+
+    size_t cap = ((const Type_Info_Array*)m->type)->num_elements;
+    if(cap == 0) return false;
+    if(escaped) {
+        if(!ti__json_unescape(str, len, field, cap - 1, &len)) return false;
+    } else {
+        if(len > cap - 1) return false;
+        memcpy(field, str, len);
+    }
+    field[len] = '\0';
+    return true;
+}
+
+static bool ti__json_decode_record(Ti__Json_Parser* ps, const Type_Info* type, char* value) {
+    if(!ti__json_consume(ps, '{')) return false;
+    if(++ps->nesting > TI_JSON_MAX_NESTING) return false;
+    if(!ti__json_consume(ps, '}')) {
+        do {
+            const char* key;
+            size_t len;
+            bool escaped;
+            if(!ti__json_scan_string(ps, &key, &len, &escaped)) return false;
+            char unescaped[256];
+            if(escaped) {
+                if(!ti__json_unescape(key, len, unescaped, sizeof(unescaped), &len)) return false;
+                key = unescaped;
+            }
+            if(!ti__json_consume(ps, ':')) return false;
+
+            size_t offset;
+            Type_Info_Member* m = ti_find_member_at((Type_Info*)type, key, len, &offset);
+            if(!m) {
+                if(!ti__json_skip_value(ps)) return false;
+            } else if(m->bit_width > 0) {
+                // Decoded as a value of its type, which must fit in the bitfield
+                char* record = value + offset - m->offset;
+                uint64_t bits;
+                ti__bitfield_load(m, record, &bits);
+                if(!ti__json_decode(ps, m->type, (char*)&bits) ||
+                   !ti__bitfield_store(m, record, &bits)) {
+                    return false;
+                }
+            } else if(ti__is_cstr_member(m)) {
+                if(!ti__json_decode_cstr(ps, m, value + offset)) return false;
+            } else {
+                if(!ti__json_decode(ps, m->type, value + offset)) return false;
+            }
+        } while(ti__json_consume(ps, ','));
+        if(!ti__json_consume(ps, '}')) return false;
+    }
+    ps->nesting--;
+    return true;
+}
+
+static bool ti__json_decode(Ti__Json_Parser* ps, const Type_Info* type, char* value) {
+    ti__json_skip_ws(ps);
+    if(ps->p == ps->end) return false;
+
+    if(*ps->p == 'n' && type->tag != TYPE_TAG_POINTER) {
+        return ti__json_consume_literal(ps, "null", 4);
+    }
+
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return ti__json_skip_value(ps);
+
+    case TYPE_TAG_INTEGER:
+        return ti__json_decode_integer(ps, type, value);
+
+    case TYPE_TAG_FLOAT: {
+        Ti__Json_Number n;
+        double v;
+        if(!ti__json_scan_number(ps, &n) || !ti__json_number_to_double(&n, &v)) return false;
+        if(type->size == sizeof(float)) {
+            float f = (float)v;
+            memcpy(value, &f, sizeof(f));
+        } else if(type->size == sizeof(double)) {
+            memcpy(value, &v, sizeof(v));
+        } else {
+            long double ld = v;
+            memcpy(value, &ld, sizeof(ld));
+        }
+        return true;
+    }
+
+    case TYPE_TAG_ENUM:
+        return ti__json_decode_enum(ps, type, value);
+
+    case TYPE_TAG_POINTER: {
+        if(ti__json_consume_literal(ps, "null", 4)) {
+            memset(value, 0, type->size);
+            return true;
+        }
+        const Type_Info* pointee = ((const Type_Info_Pointer*)type)->pointer_to;
+        char* p;
+        memcpy(&p, value, sizeof(p));
+        if(!p || !pointee || pointee->tag == TYPE_TAG_VOID) return false;
+        return ti__json_decode(ps, pointee, p);
+    }
+
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        if(!ti__json_consume(ps, '[')) return false;
+        if(++ps->nesting > TI_JSON_MAX_NESTING) return false;
+        if(!ti__json_consume(ps, ']')) {
+            size_t i = 0;
+            do {
+                if(i == count) return false;
+                if(!ti__json_decode(ps, elem, value + i * elem->size)) return false;
+                i++;
+            } while(ti__json_consume(ps, ','));
+            if(!ti__json_consume(ps, ']')) return false;
+        }
+        ps->nesting--;
+        return true;
+    }
+
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION:
+        return ti__json_decode_record(ps, type, value);
+    }
+    return false;
+}
+
+bool ti_json_decode(const char* json, size_t len, Type_Any out) {
+    Ti__Json_Parser ps = {json, json + len, 0};
+    if(!ti__json_decode(&ps, out.type, (char*)out.value)) return false;
+    ti__json_skip_ws(&ps);
+    return ps.p == ps.end;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Equality, hashing and ordering
+//
+
+static bool ti__is_trivially_comparable(const Type_Info* type) {
+    return (type->traits & TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE) != 0;
+}
+
+// Records compared as the bytes of their `data_ranges`. Bitfields may leave bits of their bytes
+// unused, so structs with bitfields compare member by member unless trivially comparable. So do
+// hand-built structs without `data_ranges`, whose traits can't be trusted either.
+static bool ti__is_byte_comparable(const Type_Info* type) {
+    if(type->tag != TYPE_TAG_UNION && type->tag != TYPE_TAG_STRUCT) return false;
+    if(((const Type_Info_Struct*)type)->data_ranges_count == 0) return false;
+    return type->tag == TYPE_TAG_UNION ||
+           !(type->traits & (TYPE_INFO_TRAIT_HAS_POINTERS | TYPE_INFO_TRAIT_HAS_FLOATS |
+                             TYPE_INFO_TRAIT_HAS_BITFIELDS));
+}
+
+// Returns the offset of the first byte differing between `a` and `b` in the data ranges of a
+// record, or `type->size` if there is none. A union without `data_ranges` compares all its bytes.
+static size_t ti__first_difference(const Type_Info* type, const char* a, const char* b) {
+    const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+    if(s->data_ranges_count == 0) {
+        size_t j = 0;
+        while(j < type->size && a[j] == b[j]) j++;
+        return j;
+    }
+    for(size_t i = 0; i < s->data_ranges_count; i++) {
+        const Type_Info_Byte_Range* r = &s->data_ranges[i];
+        if(memcmp(a + r->offset, b + r->offset, r->size) == 0) continue;
+        size_t j = r->offset;
+        while(a[j] == b[j]) j++;
+        return j;
+    }
+    return type->size;
+}
+
+static long double ti__read_float(const Type_Info* type, const char* value) {
+    if(type->size == sizeof(float)) {
+        float f;
+        memcpy(&f, value, sizeof(f));
+        return f;
+    } else if(type->size == sizeof(double)) {
+        double d;
+        memcpy(&d, value, sizeof(d));
+        return d;
+    }
+    long double ld;
+    memcpy(&ld, value, sizeof(ld));
+    return ld;
+}
+
+static int ti__compare_floats(long double a, long double b) {
+    if(a != a || b != b) return (a != a) - (b != b);  // NaNs last
+    return (a > b) - (a < b);
+}
+
+static const char* ti__read_pointer(const char* value) {
+    const char* p;
+    memcpy(&p, value, sizeof(p));
+    return p;
+}
+
+// Whether the pointee is compared instead of the address
+static bool ti__follow_pointer(const Type_Info* type, int depth) {
+    const Type_Info* pointee = ((const Type_Info_Pointer*)type)->pointer_to;
+    return pointee && pointee->tag != TYPE_TAG_VOID && depth < TI_MAX_POINTER_DEPTH;
+}
+
+// Bulk hash, 8 bytes at a time
+static uint64_t ti__hash_bulk(uint64_t h, const char* data, size_t len) {
+    const uint64_t k = 0x9E3779B97F4A7C15ULL;
+    for(; len >= 8; data += 8, len -= 8) {
+        uint64_t w;
+        memcpy(&w, data, sizeof(w));
+        h = (h ^ w) * k;
+        h ^= h >> 32;
+    }
+    if(len > 0) {
+        uint64_t w = 0;
+        memcpy(&w, data, len);
+        h = (h ^ w ^ ((uint64_t)len << 56)) * k;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+static bool ti__equal(const Type_Info* type, const char* a, const char* b, int depth);
+static uint64_t ti__hash(const Type_Info* type, const char* value, uint64_t h, int depth);
+static int ti__compare(const Type_Info* type, const char* a, const char* b, int depth);
+
+static bool ti__equal_members(const Type_Info_Struct* s, const char* a, const char* b, int depth) {
+    for(size_t i = 0; i < s->members_count; i++) {
+        const Type_Info_Member* m = &s->members[i];
+        if(m->bit_width > 0) {
+            if(ti_bitfield_get(m, a) != ti_bitfield_get(m, b)) return false;
+        } else if(m->type->tag == TYPE_TAG_POINTER && ti__is_cstr_member(m)) {
+            const char* sa = ti__read_pointer(a + m->offset);
+            const char* sb = ti__read_pointer(b + m->offset);
+            if(sa != sb && (!sa || !sb || strcmp(sa, sb) != 0)) return false;
+        } else if(!ti__equal(m->type, a + m->offset, b + m->offset, depth)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool ti__equal(const Type_Info* type, const char* a, const char* b, int depth) {
+    if(ti__is_trivially_comparable(type)) return memcmp(a, b, type->size) == 0;
+
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return true;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_ENUM:
+        return memcmp(a, b, type->size) == 0;
+    case TYPE_TAG_UNION:
+        return ti__first_difference(type, a, b) == type->size;
+    case TYPE_TAG_FLOAT:
+        return ti__compare_floats(ti__read_float(type, a), ti__read_float(type, b)) == 0;
+    case TYPE_TAG_POINTER: {
+        const char* pa = ti__read_pointer(a);
+        const char* pb = ti__read_pointer(b);
+        if(pa == pb) return true;
+        if(!pa || !pb || !ti__follow_pointer(type, depth)) return false;
+        return ti__equal(((const Type_Info_Pointer*)type)->pointer_to, pa, pb, depth + 1);
+    }
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        for(size_t i = 0; i < count; i++) {
+            if(!ti__equal(elem, a + i * elem->size, b + i * elem->size, depth)) return false;
+        }
+        return true;
+    }
+    case TYPE_TAG_STRUCT:
+        if(ti__is_byte_comparable(type)) return ti__first_difference(type, a, b) == type->size;
+        return ti__equal_members((const Type_Info_Struct*)type, a, b, depth);
+    }
+    return false;
+}
+
+static uint64_t ti__hash(const Type_Info* type, const char* value, uint64_t h, int depth) {
+    if(ti__is_trivially_comparable(type)) return ti__hash_bulk(h, value, type->size);
+    if(ti__is_byte_comparable(type)) {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->data_ranges_count; i++) {
+            h = ti__hash_bulk(h, value + s->data_ranges[i].offset, s->data_ranges[i].size);
+        }
+        return h;
+    }
+
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return h;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        return ti__hash_bulk(h, value, type->size);
+    case TYPE_TAG_FLOAT: {
+        // Hash the value as a double, so that values comparing equal hash the same
+        long double ld = ti__read_float(type, value);
+        uint64_t bits = 0;  // 0.0 and -0.0
+        if(ld != ld) {
+            bits = 0x7FF8000000000000ULL;  // All NaNs
+        } else if(ld != 0) {
+            double d = (double)ld;
+            memcpy(&bits, &d, sizeof(bits));
+        }
+        return ti__hash_bulk(h, (const char*)&bits, sizeof(bits));
+    }
+    case TYPE_TAG_POINTER: {
+        const char* p = ti__read_pointer(value);
+        if(!p) return ti__hash_bulk(h, "", 1);
+        if(!ti__follow_pointer(type, depth)) return ti__hash_bulk(h, value, sizeof(p));
+        return ti__hash(((const Type_Info_Pointer*)type)->pointer_to, p, h, depth + 1);
+    }
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        for(size_t i = 0; i < count; i++) h = ti__hash(elem, value + i * elem->size, h, depth);
+        return h;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->members_count; i++) {
+            const Type_Info_Member* m = &s->members[i];
+            if(m->bit_width > 0) {
+                uint64_t bits = ti_bitfield_get(m, value);
+                h = ti__hash_bulk(h, (const char*)&bits, sizeof(bits));
+            } else if(m->type->tag == TYPE_TAG_POINTER && ti__is_cstr_member(m)) {
+                const char* str = ti__read_pointer(value + m->offset);
+                h = str ? ti__hash_bulk(h, str, strlen(str) + 1) : ti__hash_bulk(h, "", 1);
+            } else {
+                h = ti__hash(m->type, value + m->offset, h, depth);
+            }
+        }
+        return h;
+    }
+    }
+    return h;
+}
+
+static uint64_t ti__read_unsigned(const Type_Info* type, const char* value) {
+    switch(type->size) {
+    case 1: {
+        uint8_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    case 2: {
+        uint16_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    case 4: {
+        uint32_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    default: {
+        uint64_t v;
+        memcpy(&v, value, sizeof(v));
+        return v;
+    }
+    }
+}
+
+static int ti__compare_scalars(const Type_Info* type, const char* a, const char* b) {
+    switch(type->tag) {
+    case TYPE_TAG_INTEGER:
+        if(((const Type_Info_Integer*)type)->is_signed) {
+            long long va = ti__read_enum(type, a), vb = ti__read_enum(type, b);
+            return (va > vb) - (va < vb);
+        } else {
+            uint64_t va = ti__read_unsigned(type, a), vb = ti__read_unsigned(type, b);
+            return (va > vb) - (va < vb);
+        }
+    case TYPE_TAG_ENUM: {
+        long long va = ti__read_enum(type, a), vb = ti__read_enum(type, b);
+        return (va > vb) - (va < vb);
+    }
+    case TYPE_TAG_UNION: {
+        size_t i = ti__first_difference(type, a, b);
+        if(i == type->size) return 0;
+        return (unsigned char)a[i] > (unsigned char)b[i] ? 1 : -1;
+    }
+    default: {
+        int c = memcmp(a, b, type->size);
+        return (c > 0) - (c < 0);
+    }
+    }
+}
+
+// Compares values of types compared as bytes: finds the first differing byte, and only compares
+// the scalar containing it, as all the scalars before it are equal
+static int ti__compare_bytes(const Type_Info* type, const char* a, const char* b) {
+    size_t i = 0;
+    if(type->tag == TYPE_TAG_STRUCT || type->tag == TYPE_TAG_UNION) {
+        i = ti__first_difference(type, a, b);
+    } else {
+        while(i + 8 <= type->size && memcmp(a + i, b + i, 8) == 0) i += 8;
+        while(i < type->size && a[i] == b[i]) i++;
+    }
+    if(i == type->size) return 0;
+
+    for(;;) {
+        if(type->tag == TYPE_TAG_ARRAY || type->tag == TYPE_TAG_VECTOR) {
+            size_t count;
+            const Type_Info* elem = ti__elements(type, &count);
+            size_t index = i / elem->size;
+            a += index * elem->size, b += index * elem->size, i -= index * elem->size;
+            type = elem;
+        } else if(type->tag == TYPE_TAG_STRUCT) {
+            const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+            const Type_Info_Member* m = NULL;
+            for(size_t j = 0; j < s->members_count && s->members[j].offset <= i; j++) {
+                m = &s->members[j];
+            }
+            if(!m) return ti__compare_scalars(type, a, b);
+            a += m->offset, b += m->offset, i -= m->offset;
+            type = m->type;
+        } else {
+            return ti__compare_scalars(type, a, b);
+        }
+    }
+}
+
+static int ti__compare(const Type_Info* type, const char* a, const char* b, int depth) {
+    // The first differing byte can't tell which bitfield differs first
+    if(type->tag != TYPE_TAG_UNION && !(type->traits & TYPE_INFO_TRAIT_HAS_BITFIELDS) &&
+       (ti__is_trivially_comparable(type) || ti__is_byte_comparable(type))) {
+        return ti__compare_bytes(type, a, b);
+    }
+
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return 0;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        return ti__compare_scalars(type, a, b);
+    case TYPE_TAG_FLOAT:
+        return ti__compare_floats(ti__read_float(type, a), ti__read_float(type, b));
+    case TYPE_TAG_POINTER: {
+        const char* pa = ti__read_pointer(a);
+        const char* pb = ti__read_pointer(b);
+        if(pa == pb) return 0;
+        if(!pa || !pb) return pa ? 1 : -1;  // NULL first
+        if(!ti__follow_pointer(type, depth)) return (uintptr_t)pa > (uintptr_t)pb ? 1 : -1;
+        return ti__compare(((const Type_Info_Pointer*)type)->pointer_to, pa, pb, depth + 1);
+    }
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        for(size_t i = 0; i < count; i++) {
+            int c = ti__compare(elem, a + i * elem->size, b + i * elem->size, depth);
+            if(c != 0) return c;
+        }
+        return 0;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->members_count; i++) {
+            const Type_Info_Member* m = &s->members[i];
+            int c;
+            if(m->bit_width > 0) {
+                uint64_t bits_a, bits_b;
+                c = ti__compare(m->type, ti__bitfield_load(m, a, &bits_a),
+                                ti__bitfield_load(m, b, &bits_b), depth);
+            } else if(m->type->tag == TYPE_TAG_POINTER && ti__is_cstr_member(m)) {
+                const char* sa = ti__read_pointer(a + m->offset);
+                const char* sb = ti__read_pointer(b + m->offset);
+                if(sa == sb) c = 0;
+                else if(!sa || !sb) c = sa ? 1 : -1;
+                else c = strcmp(sa, sb);
+            } else {
+                c = ti__compare(m->type, a + m->offset, b + m->offset, depth);
+            }
+            if(c != 0) return (c > 0) - (c < 0);
+        }
+        return 0;
+    }
+    }
+    return 0;
+}
+
+bool ti_equal(Type_Any a, Type_Any b) {
+    if(a.type != b.type) return false;
+    return ti__equal(a.type, (const char*)a.value, (const char*)b.value, 0);
+}
+
+uint64_t ti_hash(Type_Any value) {
+    return ti_hash_mix(ti__hash(value.type, (const char*)value.value, 0xCBF29CE484222325ULL, 0));
+}
+
+int ti_compare(Type_Any a, Type_Any b) {
+    return ti__compare(a.type, (const char*)a.value, (const char*)b.value, 0);
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Walking
+//
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define TI__PREFETCH(p) __builtin_prefetch(p)
+#else
+    #define TI__PREFETCH(p) ((void)(p))
+#endif
+
+// Elements of arrays of pointers prefetched ahead of the one visited
+#define TI__WALK_PREFETCH_DISTANCE 8
+
+// A struct or array whose members or elements are being visited
+typedef struct {
+    const Type_Info* type;
+    char* value;
+    size_t next;   // Index of the next member or element
+    size_t count;  // Members or elements
+    size_t depth;  // Of the members or elements
+} Ti__Walk_Frame;
+
+// Prefetches the values pointed to by a struct, or by the first elements of an array of pointers
+static void ti__walk_prefetch(const Type_Info* type, const char* value, size_t count) {
+    if(type->tag == TYPE_TAG_STRUCT) {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->pointers_count; i++) {
+            const char* p = ti__read_pointer(value + s->pointers[i].offset);
+            if(p) TI__PREFETCH(p);
+        }
+        return;
+    }
+    size_t n;
+    const Type_Info* elem = ti__elements(type, &n);
+    if(elem->tag != TYPE_TAG_POINTER) return;
+    for(size_t i = 0; i < count && i < TI__WALK_PREFETCH_DISTANCE; i++) {
+        const char* p = ti__read_pointer(value + i * elem->size);
+        if(p) TI__PREFETCH(p);
+    }
+}
+
+bool ti_walk(Type_Any root, Type_Info_Walk_Visitor visitor, void* user) {
+    Ti__Walk_Frame* frames = NULL;
+    size_t frames_count = 0, frames_capacity = 0;
+    const Type_Info* type = root.type;
+    char* value = (char*)root.value;
+    const Type_Info_Member* member = NULL;
+    size_t depth = 0;
+    bool ok = true;
+
+    for(;;) {
+        Type_Info_Walk_Action action = visitor((Type_Any){value, (Type_Info*)type}, member, depth,
+                                               user);
+        if(action == TYPE_INFO_WALK_STOP) {
+            ok = false;
+            break;
+        }
+        if(action == TYPE_INFO_WALK_CONTINUE && (!member || member->bit_width == 0)) {
+            if(type->tag == TYPE_TAG_POINTER) {
+                const Type_Info* pointee = ((const Type_Info_Pointer*)type)->pointer_to;
+                char* p = (char*)ti__read_pointer(value);
+                if(p && pointee && pointee->tag != TYPE_TAG_VOID) {
+                    // The pointee is visited next, without a frame
+                    type = pointee, value = p, member = NULL, depth++;
+                    continue;
+                }
+            } else if(type->tag == TYPE_TAG_STRUCT || type->tag == TYPE_TAG_ARRAY) {
+                size_t count;
+                if(type->tag == TYPE_TAG_STRUCT) {
+                    count = ((const Type_Info_Struct*)type)->members_count;
+                } else {
+                    ti__elements(type, &count);
+                }
+                if(count > 0) {
+                    if(frames_count == frames_capacity) {
+                        size_t capacity = frames_capacity ? frames_capacity * 2 : 16;
+                        Ti__Walk_Frame* grown = TI_REALLOC(frames, capacity * sizeof(*frames));
+                        if(!grown) {
+                            ok = false;
+                            break;
+                        }
+                        frames = grown, frames_capacity = capacity;
+                    }
+                    ti__walk_prefetch(type, value, count);
+                    frames[frames_count++] = (Ti__Walk_Frame){type, value, 0, count, depth + 1};
+                }
+            }
+        }
+
+        if(frames_count == 0) break;
+        Ti__Walk_Frame* f = &frames[frames_count - 1];
+        size_t i = f->next++;
+        depth = f->depth;
+        if(f->type->tag == TYPE_TAG_STRUCT) {
+            member = &((const Type_Info_Struct*)f->type)->members[i];
+            type = member->type;
+            value = f->value + member->offset;
+        } else {
+            size_t count;
+            member = NULL;
+            type = ti__elements(f->type, &count);
+            value = f->value + i * type->size;
+            if(type->tag == TYPE_TAG_POINTER && i + TI__WALK_PREFETCH_DISTANCE < f->count) {
+                const char* p =
+                    ti__read_pointer(value + TI__WALK_PREFETCH_DISTANCE * type->size);
+                if(p) TI__PREFETCH(p);
+            }
+        }
+        if(f->next == f->count) frames_count--;  // Done with it before visiting its last value
+    }
+    TI_FREE(frames);
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Member paths
+//
+
+bool ti_path_compile(Type_Info* root, const char* path, Type_Info_Path* out) {
+    Type_Info_Path r = {root, 0, 1, 0, {{0, 0}}};
+    const char* p = path;
+    while(*p) {
+        if(*p == '[') {
+            if(r.type->tag != TYPE_TAG_ARRAY && r.type->tag != TYPE_TAG_VECTOR) return false;
+            size_t count;
+            const Type_Info* elem = ti__elements(r.type, &count);
+            p++;
+            if(*p == '*') {
+                Type_Info_Path_Dim* last = r.dims_count ? &r.dims[r.dims_count - 1] : NULL;
+                if(last && last->stride == count * elem->size) {
+                    // The elements of the previous wildcard are these: continue it
+                    last->stride = elem->size;
+                    last->count *= count;
+                } else if(r.dims_count < TI_PATH_MAX_WILDCARDS) {
+                    r.dims[r.dims_count++] = (Type_Info_Path_Dim){elem->size, count};
+                } else {
+                    return false;
+                }
+                r.count *= count;
+                p++;
+            } else {
+                if(*p < '0' || *p > '9') return false;
+                size_t index = 0;
+                for(; *p >= '0' && *p <= '9'; p++) {
+                    index = index * 10 + (size_t)(*p - '0');
+                    if(index >= count) return false;
+                }
+                r.offset += index * elem->size;
+            }
+            if(*p++ != ']') return false;
+            r.type = elem;
+        } else {
+            if(p != path && *p++ != '.') return false;
+            const char* name = p;
+            while(*p && *p != '.' && *p != '[') p++;
+            if(p == name) return false;
+            if(r.type->tag != TYPE_TAG_STRUCT && r.type->tag != TYPE_TAG_UNION) return false;
+            size_t offset;
+            const Type_Info_Member* m =
+                ti_find_member_at((Type_Info*)r.type, name, (size_t)(p - name), &offset);
+            if(!m || m->bit_width > 0) return false;
+            r.offset += offset;
+            r.type = m->type;
+        }
+    }
+    *out = r;
+    return true;
+}
+
+size_t ti_path_gather(const Type_Info_Path* path, const void* root, void* out) {
+    size_t size = path->type->size;
+    const char* base = (const char*)root + path->offset;
+    char* dst = (char*)out;
+    if(path->dims_count == 0) {
+        memcpy(dst, base, size);
+        return 1;
+    }
+    if(path->count == 0) return 0;
+
+    // Copies the innermost wildcard for each combination of the outer ones
+    const Type_Info_Path_Dim* inner = &path->dims[path->dims_count - 1];
+    size_t index[TI_PATH_MAX_WILDCARDS] = {0};
+    for(;;) {
+        const char* p = base;
+        for(size_t d = 0; d + 1 < path->dims_count; d++) p += index[d] * path->dims[d].stride;
+        if(inner->stride == size) {
+            memcpy(dst, p, inner->count * size);
+            dst += inner->count * size;
+        } else {
+            for(size_t i = 0; i < inner->count; i++, dst += size) {
+                memcpy(dst, p + i * inner->stride, size);
+            }
+        }
+
+        size_t d = path->dims_count - 1;
+        while(d > 0 && ++index[d - 1] == path->dims[d - 1].count) index[--d] = 0;
+        if(d == 0) break;
+    }
+    return path->count;
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Object graphs
+//
+
+typedef struct {
+    const void* src;
+    const Type_Info* type;  // NULL for `CStr` strings and when collecting
+    char* dst;              // The copy, when copying
+    size_t offset;          // In the snapshot, when laying out
+    size_t size;
+} Ti__Visited_Entry;
+
+// Open addressing table of the values already visited, keyed by address and type
+typedef struct {
+    Ti__Visited_Entry* entries;
+    size_t count, capacity;
+} Ti__Visited;
+
+// A value whose pointers are still to be followed
+typedef struct {
+    char* value;
+    const Type_Info* type;
+} Ti__Graph_Node;
+
+// Range of addresses, e.g. the memory in use in an arena page
+typedef struct {
+    const char* start;
+    const char* end;
+} Ti__Address_Range;
+
+typedef enum {
+    TI__GRAPH_COPY,     // Copy the values reached with `alloc`, pointing to the copies
+    TI__GRAPH_COLLECT,  // Only record the values reached
+    TI__GRAPH_LAYOUT,   // Give the values reached an offset in a snapshot
+    TI__GRAPH_SWIZZLE,  // Replace the pointers of values laid out in `snapshot` with offsets
+} Ti__Graph_Mode;
+
+typedef struct {
+    Ti__Graph_Mode mode;
+    void* (*alloc)(void* ctx, size_t size);
+    void* alloc_ctx;
+    // When not NULL, only pointers into these ranges, sorted by address, are followed
+    Ti__Address_Range* from;
+    size_t from_count;
+    size_t layout_size;  // End of the values laid out so far
+    char* snapshot;
+    Ti__Visited visited;
+    Ti__Graph_Node* nodes;  // Queue of values to visit, from `nodes_head` to `nodes_count`
+    size_t nodes_head, nodes_count, nodes_capacity;
+} Ti__Graph;
+
+static size_t ti__visited_slot(const Ti__Visited* v, const void* src, const Type_Info* type) {
+    size_t mask = v->capacity - 1;
+    size_t i = (size_t)ti_hash_mix((uint64_t)(uintptr_t)src ^ (uint64_t)(uintptr_t)type) & mask;
+    while(v->entries[i].src && (v->entries[i].src != src || v->entries[i].type != type)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// Returns the entry of `src`, adding it with a zero `size` if it was not visited yet. Returns NULL
+// if out of memory.
+static Ti__Visited_Entry* ti__visit(Ti__Visited* v, const void* src, const Type_Info* type) {
+    if(v->capacity > 0) {
+        Ti__Visited_Entry* e = &v->entries[ti__visited_slot(v, src, type)];
+        if(e->src) return e;
+    }
+    if((v->count + 1) * 2 > v->capacity) {
+        size_t capacity = v->capacity ? v->capacity * 2 : 64;
+        Ti__Visited grown = {(Ti__Visited_Entry*)TI_MALLOC(capacity * sizeof(Ti__Visited_Entry)),
+                             v->count, capacity};
+        if(!grown.entries) return NULL;
+        memset(grown.entries, 0, capacity * sizeof(Ti__Visited_Entry));
+        for(size_t i = 0; i < v->capacity; i++) {
+            const Ti__Visited_Entry* e = &v->entries[i];
+            if(e->src) grown.entries[ti__visited_slot(&grown, e->src, e->type)] = *e;
+        }
+        TI_FREE(v->entries);
+        *v = grown;
+    }
+    Ti__Visited_Entry* e = &v->entries[ti__visited_slot(v, src, type)];
+    e->src = src, e->type = type;
+    v->count++;
+    return e;
+}
+
+static bool ti__graph_push(Ti__Graph* g, char* value, const Type_Info* type) {
+    if(g->nodes_head == g->nodes_count) g->nodes_head = g->nodes_count = 0;
+    if(g->nodes_count == g->nodes_capacity) {
+        size_t capacity = g->nodes_capacity ? g->nodes_capacity * 2 : 64;
+        Ti__Graph_Node* nodes =
+            (Ti__Graph_Node*)TI_REALLOC(g->nodes, capacity * sizeof(Ti__Graph_Node));
+        if(!nodes) return false;
+        g->nodes = nodes, g->nodes_capacity = capacity;
+    }
+    g->nodes[g->nodes_count++] = (Ti__Graph_Node){value, type};
+    return true;
+}
+
+static bool ti__graph_in_from(const Ti__Graph* g, const char* p) {
+    size_t lo = 0, hi = g->from_count;
+    while(lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if(p < g->from[mid].start) hi = mid;
+        else if(p >= g->from[mid].end) lo = mid + 1;
+        else return true;
+    }
+    return false;
+}
+
+// Visits the value pointed to by the pointer stored at `field`
+static bool ti__graph_follow(Ti__Graph* g, char* field, bool is_cstr, const Type_Info* pointee) {
+    char* src = (char*)ti__read_pointer(field);
+    if(!src) return true;
+    if(!pointee || pointee->tag == TYPE_TAG_VOID || pointee->size == 0 ||
+       (g->from && !ti__graph_in_from(g, src))) {
+        // Not followed. Addresses are meaningless in a snapshot.
+        if(g->mode == TI__GRAPH_SWIZZLE) memset(field, 0, sizeof(void*));
+        return true;
+    }
+
+    const Type_Info* key = is_cstr || g->mode == TI__GRAPH_COLLECT ? NULL : pointee;
+    Ti__Visited_Entry* e = ti__visit(&g->visited, src, key);
+    if(!e) return false;
+    if(g->mode == TI__GRAPH_SWIZZLE) {
+        intptr_t offset = (intptr_t)e->offset - (intptr_t)(field - g->snapshot);
+        memcpy(field, &offset, sizeof(offset));
+        return true;
+    }
+    if(e->size == 0) {
+        e->size = is_cstr ? strlen(src) + 1 : pointee->size;
+        char* value = src;
+        if(g->mode == TI__GRAPH_COPY) {
+            value = (char*)g->alloc(g->alloc_ctx, e->size);
+            if(!value) return false;
+            memcpy(value, src, e->size);
+            e->dst = value;
+        } else if(g->mode == TI__GRAPH_LAYOUT) {
+            size_t alignment = is_cstr ? 1 : pointee->alignment;
+            e->offset = (g->layout_size + alignment - 1) / alignment * alignment;
+            g->layout_size = e->offset + e->size;
+        }
+        if(!is_cstr && (pointee->traits & TYPE_INFO_TRAIT_HAS_POINTERS) &&
+           !ti__graph_push(g, value, pointee)) {
+            return false;
+        }
+    }
+    if(g->mode == TI__GRAPH_COPY) memcpy(field, &e->dst, sizeof(e->dst));
+    return true;
+}
+
+// Follows the pointers of a value
+static bool ti__graph_visit(Ti__Graph* g, char* value, const Type_Info* type) {
+    switch(type->tag) {
+    case TYPE_TAG_POINTER:
+        return ti__graph_follow(g, value, false, ((const Type_Info_Pointer*)type)->pointer_to);
+    case TYPE_TAG_ARRAY: {
+        const Type_Info_Array* arr = (const Type_Info_Array*)type;
+        if(!(arr->element_type->traits & TYPE_INFO_TRAIT_HAS_POINTERS)) return true;
+        for(size_t i = 0; i < arr->num_elements; i++) {
+            if(!ti__graph_push(g, value + i * arr->element_type->size, arr->element_type)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    case TYPE_TAG_STRUCT: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        for(size_t i = 0; i < s->pointers_count; i++) {
+            const Type_Info_Pointer_Slot* slot = &s->pointers[i];
+            if(!ti__graph_follow(g, value + slot->offset, slot->is_cstr, slot->pointee)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    default:
+        return true;
+    }
+}
+
+// Visits everything reachable from `root` in breadth-first order. `root` must be in `visited`
+// already.
+static bool ti__graph_walk(Ti__Graph* g, char* root, const Type_Info* type) {
+    if(!(type->traits & TYPE_INFO_TRAIT_HAS_POINTERS)) return true;
+    if(!ti__graph_push(g, root, type)) return false;
+    while(g->nodes_head < g->nodes_count) {
+        Ti__Graph_Node node = g->nodes[g->nodes_head++];
+        if(!ti__graph_visit(g, node.value, node.type)) return false;
+    }
+    return true;
+}
+
+static void ti__graph_free(Ti__Graph* g) {
+    TI_FREE(g->from);
+    TI_FREE(g->visited.entries);
+    TI_FREE(g->nodes);
+}
+
+#ifdef EXTLIB_H
+
+static void* ti__arena_alloc(void* arena, size_t size) {
+    return ext_arena_alloc((Ext_Arena*)arena, size);
+}
+
+// Copies `root` with `g->alloc`, unless `in_place`, then everything reachable from it. Returns the
+// copy of `root`, or NULL if out of memory.
+static void* ti__graph_copy(Ti__Graph* g, Type_Any root, bool in_place) {
+    size_t size = root.type->size ? root.type->size : 1;
+    char* dst = in_place ? (char*)root.value : (char*)g->alloc(g->alloc_ctx, size);
+    Ti__Visited_Entry* e = dst ? ti__visit(&g->visited, root.value, root.type) : NULL;
+    if(!e) return NULL;
+    if(!in_place) memcpy(dst, root.value, root.type->size);
+    e->dst = dst, e->size = size;
+    return ti__graph_walk(g, dst, root.type) ? dst : NULL;
+}
+
+static int ti__compare_address_ranges(const void* a, const void* b) {
+    const char* sa = ((const Ti__Address_Range*)a)->start;
+    const char* sb = ((const Ti__Address_Range*)b)->start;
+    return (sa > sb) - (sa < sb);
+}
+
+// Only follow pointers into the memory in use in `from`
+static bool ti__graph_set_from(Ti__Graph* g, const Ext_Arena* from) {
+    size_t count = 0;
+    for(const Ext_ArenaPage* p = from->first_page; p; p = p == from->last_page ? NULL : p->next) {
+        count++;
+    }
+    g->from = (Ti__Address_Range*)TI_MALLOC((count ? count : 1) * sizeof(Ti__Address_Range));
+    if(!g->from) return false;
+    for(const Ext_ArenaPage* p = from->first_page; p; p = p == from->last_page ? NULL : p->next) {
+        g->from[g->from_count++] = (Ti__Address_Range){p->data, p->data + p->pos};
+    }
+    qsort(g->from, g->from_count, sizeof(Ti__Address_Range), ti__compare_address_ranges);
+    return true;
+}
+
+void* ti_clone(Type_Any src, Ext_Arena* arena) {
+    Ti__Graph g = {.mode = TI__GRAPH_COPY, .alloc = ti__arena_alloc, .alloc_ctx = arena};
+    void* dst = ti__graph_copy(&g, src, false);
+    ti__graph_free(&g);
+    return dst;
+}
+
+bool ti_destroy(Type_Any value, Ext_Allocator* allocator) {
+    Ti__Graph g = {.mode = TI__GRAPH_COLLECT};
+    // Not freed, even if pointed to
+    Ti__Visited_Entry* root = ti__visit(&g.visited, value.value, NULL);
+    bool ok = root != NULL;
+    if(ok) {
+        root->size = SIZE_MAX;
+        ok = ti__graph_walk(&g, (char*)value.value, value.type);
+    }
+    for(size_t i = 0; ok && i < g.visited.capacity; i++) {
+        const Ti__Visited_Entry* e = &g.visited.entries[i];
+        if(e->src && e->src != value.value) allocator->free(allocator, (void*)e->src, e->size);
+    }
+    ti__graph_free(&g);
+    return ok;
+}
+
+void* ti_relocate(Type_Any root, Ext_Arena* from, Ext_Arena* to) {
+    Ti__Graph g = {.mode = TI__GRAPH_COPY, .alloc = ti__arena_alloc, .alloc_ctx = to};
+    void* dst = NULL;
+    if(ti__graph_set_from(&g, from)) {
+        dst = ti__graph_copy(&g, root, !ti__graph_in_from(&g, (const char*)root.value));
+    }
+    ti__graph_free(&g);
+    return dst;
+}
+
+#endif  // EXTLIB_H
+
+// -----------------------------------------------------------------------------
+// SECTION: Snapshots
+//
+
+#define TI__SNAPSHOT_MAGIC "TISNAP01"
+// Offset of the root value, fixed so that `ti_snapshot_unmap` can find the start of the mapping
+#define TI__SNAPSHOT_ROOT 64
+
+typedef struct {
+    char magic[8];
+    uint64_t size;  // Of the whole snapshot
+    uint64_t type_check;
+} Ti__Snapshot_Header;
+
+// Identifies the layout of the values of a snapshot. Fingerprints cover everything reachable from
+// a record; other roots also check what they point to or hold.
+static uint64_t ti__snapshot_type_check(const Type_Info* type) {
+    uint64_t fields[4] = {type->tag, type->size, type->alignment, 0};
+    switch(type->tag) {
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION:
+        return ((const Type_Info_Struct*)type)->fingerprint;
+    case TYPE_TAG_ENUM:
+        return ((const Type_Info_Enum*)type)->fingerprint;
+    case TYPE_TAG_POINTER: {
+        const Type_Info* pointee = ((const Type_Info_Pointer*)type)->pointer_to;
+        if(pointee) fields[3] = ti__snapshot_type_check(pointee);
+    } break;
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        fields[3] = ti__snapshot_type_check(ti__elements(type, &count));
+    } break;
+    default:
+        break;
+    }
+    return ti_hash_mix(ti__hash_bulk(0xCBF29CE484222325ULL, (const char*)fields, sizeof(fields)));
+}
+
+bool ti_snapshot_write(Type_Any root, const char* path) {
+    if(root.type->alignment > TI__SNAPSHOT_ROOT) return false;
+    Ti__Graph g = {.mode = TI__GRAPH_LAYOUT, .layout_size = TI__SNAPSHOT_ROOT + root.type->size};
+    Ti__Visited_Entry* e = ti__visit(&g.visited, root.value, root.type);
+    if(e) e->offset = TI__SNAPSHOT_ROOT, e->size = root.type->size;
+    bool ok = e && ti__graph_walk(&g, (char*)root.value, root.type);
+
+    // Copy the values at their offset, then replace their pointers
+    char* snapshot = ok ? (char*)TI_MALLOC(g.layout_size) : NULL;
+    ok = snapshot != NULL;
+    if(ok) {
+        memset(snapshot, 0, g.layout_size);
+        Ti__Snapshot_Header header = {TI__SNAPSHOT_MAGIC, g.layout_size,
+                                      ti__snapshot_type_check(root.type)};
+        memcpy(snapshot, &header, sizeof(header));
+        for(size_t i = 0; i < g.visited.capacity; i++) {
+            const Ti__Visited_Entry* v = &g.visited.entries[i];
+            if(v->src) memcpy(snapshot + v->offset, v->src, v->size);
+        }
+        g.mode = TI__GRAPH_SWIZZLE, g.snapshot = snapshot;
+        for(size_t i = 0; ok && i < g.visited.capacity; i++) {
+            const Ti__Visited_Entry* v = &g.visited.entries[i];
+            if(v->src && v->type) ok = ti__graph_walk(&g, snapshot + v->offset, v->type);
+        }
+    }
+
+    FILE* file = ok ? fopen(path, "wb") : NULL;
+    if(file) {
+        ok = fwrite(snapshot, 1, g.layout_size, file) == g.layout_size;
+        ok = fclose(file) == 0 && ok;
+    } else {
+        ok = false;
+    }
+    TI_FREE(snapshot);
+    ti__graph_free(&g);
+    return ok;
+}
+
+void* ti_snapshot_map(const char* path, const Type_Info* expected) {
+    char* snapshot = NULL;
+    size_t size = 0;
+#ifdef TI__HAS_MMAP
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return NULL;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && (size_t)st.st_size >= TI__SNAPSHOT_ROOT) {
+        size = (size_t)st.st_size;
+        snapshot = (char*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(snapshot == (char*)MAP_FAILED) snapshot = NULL;
+    }
+    close(fd);
+#else
+    FILE* file = fopen(path, "rb");
+    if(!file) return NULL;
+    if(fseek(file, 0, SEEK_END) == 0) {
+        long end = ftell(file);
+        if(end >= TI__SNAPSHOT_ROOT && fseek(file, 0, SEEK_SET) == 0) {
+            size = (size_t)end;
+            snapshot = (char*)TI_MALLOC(size);
+            if(snapshot && fread(snapshot, 1, size, file) != size) {
+                TI_FREE(snapshot);
+                snapshot = NULL;
+            }
+        }
+    }
+    fclose(file);
+#endif
+    if(!snapshot) return NULL;
+
+    Ti__Snapshot_Header header;
+    memcpy(&header, snapshot, sizeof(header));
+    if(memcmp(header.magic, TI__SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+       header.size != size || header.type_check != ti__snapshot_type_check(expected) ||
+       TI__SNAPSHOT_ROOT + expected->size > size) {
+        // Not `ti_snapshot_unmap`, which trusts the size in the header
+#ifdef TI__HAS_MMAP
+        munmap(snapshot, size);
+#else
+        TI_FREE(snapshot);
+#endif
+        return NULL;
+    }
+    return snapshot + TI__SNAPSHOT_ROOT;
+}
+
+void ti_snapshot_unmap(void* root) {
+    if(!root) return;
+    char* snapshot = (char*)root - TI__SNAPSHOT_ROOT;
+#ifdef TI__HAS_MMAP
+    Ti__Snapshot_Header header;
+    memcpy(&header, snapshot, sizeof(header));
+    munmap(snapshot, header.size);
+#else
+    TI_FREE(snapshot);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Schema migration
+//
+
+typedef struct {
+    Type_Info_Migration_Op* items;
+    size_t size, capacity;
+    bool barrier;  // Don't merge the next op with the last one, it's the end of a loop body
+    bool failed;
+} Ti__Migration_Builder;
+
+static void ti__migration_push(Ti__Migration_Builder* b, Type_Info_Migration_Op op) {
+    if(op.size == 0) return;
+    if(!b->barrier && b->size > 0 && op.bit_width == 0 &&
+       (op.kind == TYPE_INFO_MIGRATE_COPY || op.kind == TYPE_INFO_MIGRATE_ZERO)) {
+        Type_Info_Migration_Op* last = &b->items[b->size - 1];
+        if(last->kind == op.kind && last->bit_width == 0 &&
+           last->to_offset + last->size == op.to_offset &&
+           (op.kind == TYPE_INFO_MIGRATE_ZERO || last->from_offset + last->size == op.from_offset)) {
+            last->size += op.size;
+            return;
+        }
+    }
+    b->barrier = false;
+
+    if(b->size == b->capacity) {
+        size_t capacity = b->capacity ? b->capacity * 2 : 16;
+        Type_Info_Migration_Op* items = TI_REALLOC(b->items, capacity * sizeof(*items));
+        if(!items) {
+            b->failed = true;
+            return;
+        }
+        b->items = items, b->capacity = capacity;
+    }
+    b->items[b->size++] = op;
+}
+
+// Fingerprint of records and enums, address of other types
+static uint64_t ti__migration_key(const Type_Info* type) {
+    uint64_t fingerprint = 0;
+    switch(type->tag) {
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION:
+        fingerprint = ((const Type_Info_Struct*)type)->fingerprint;
+        break;
+    case TYPE_TAG_ENUM:
+        fingerprint = ((const Type_Info_Enum*)type)->fingerprint;
+        break;
+    default:
+        break;
+    }
+    return fingerprint ? fingerprint : (uint64_t)(uintptr_t)type;
+}
+
+// Whether values of `from` can be copied as they are into `to`
+static bool ti__migration_same(const Type_Info* from, const Type_Info* to) {
+    if(from == to) return true;
+    if(from->tag != to->tag || from->size != to->size) return false;
+    switch(to->tag) {
+    case TYPE_TAG_VOID:
+    case TYPE_TAG_FLOAT:
+        return true;
+    case TYPE_TAG_INTEGER:
+        return ((const Type_Info_Integer*)from)->is_signed ==
+               ((const Type_Info_Integer*)to)->is_signed;
+    case TYPE_TAG_POINTER:
+        return ti__migration_same(((const Type_Info_Pointer*)from)->pointer_to,
+                                  ((const Type_Info_Pointer*)to)->pointer_to);
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t from_count, to_count;
+        const Type_Info* from_elem = ti__elements(from, &from_count);
+        const Type_Info* to_elem = ti__elements(to, &to_count);
+        return from_count == to_count && ti__migration_same(from_elem, to_elem);
+    }
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION:
+    case TYPE_TAG_ENUM:
+        return ti__migration_key(from) == ti__migration_key(to);
+    }
+    return false;
+}
+
+// Integers and enums of a size the conversions handle
+static bool ti__migration_is_integer(const Type_Info* type) {
+    if(type->tag != TYPE_TAG_INTEGER && type->tag != TYPE_TAG_ENUM) return false;
+    return type->size == 1 || type->size == 2 || type->size == 4 || type->size == 8;
+}
+
+static bool ti__migration_is_float(const Type_Info* type) {
+    return type->tag == TYPE_TAG_FLOAT &&
+           (type->size == sizeof(float) || type->size == sizeof(double) ||
+            type->size == sizeof(long double));
+}
+
+static void ti__migration_compile(Ti__Migration_Builder* b, const Type_Info* from,
+                                  size_t from_offset, const Type_Info* to, size_t to_offset);
+
+// Members of which one is a bitfield: integers are converted, anything else zeroed
+static void ti__migration_compile_bits(Ti__Migration_Builder* b, const Type_Info_Member* from,
+                                       size_t from_offset, const Type_Info_Member* to,
+                                       size_t to_offset) {
+    Type_Info_Migration_Op op = {TYPE_INFO_MIGRATE_ZERO, to_offset, from_offset, to->type->size,
+                                 0, false, 0, 0, to->bit_offset, to->bit_width, 0, 0};
+    if(from && ti__migration_is_integer(from->type)) {
+        if(ti__migration_is_integer(to->type)) op.kind = TYPE_INFO_MIGRATE_INT;
+        else if(ti__migration_is_float(to->type)) op.kind = TYPE_INFO_MIGRATE_INT_TO_FLOAT;
+    }
+    if(op.kind != TYPE_INFO_MIGRATE_ZERO) {
+        op.from_size = from->type->size;
+        op.from_signed = ti__is_signed(from->type);
+        op.from_bit_offset = from->bit_offset;
+        op.from_bit_width = from->bit_width;
+    }
+    ti__migration_push(b, op);
+}
+
+// Matches the members of `to` by name in `from`, which is the record to look them up in: the
+// enclosing one for members of anonymous structs
+static void ti__migration_compile_record(Ti__Migration_Builder* b, const Type_Info* from,
+                                         size_t from_offset, const Type_Info* to,
+                                         size_t to_offset) {
+    const Type_Info_Struct* s = (const Type_Info_Struct*)to;
+    for(size_t i = 0; i < s->members_count; i++) {
+        const Type_Info_Member* m = &s->members[i];
+        Type_Info_Migration_Op zero = {TYPE_INFO_MIGRATE_ZERO, to_offset + m->offset, 0,
+                                       m->type->size, 0, false, 0, 0, 0, 0, 0, 0};
+        if(m->name[0] == '\0' && m->type->tag == TYPE_TAG_STRUCT) {
+            ti__migration_compile_record(b, from, from_offset, m->type, to_offset + m->offset);
+        } else if(m->name[0] == '\0') {
+            // Anonymous unions have no name to match: look for an unchanged one
+            const Type_Info_Struct* f = (const Type_Info_Struct*)from;
+            const Type_Info_Member* match = NULL;
+            for(size_t j = 0; j < f->members_count && !match; j++) {
+                const Type_Info_Member* candidate = &f->members[j];
+                if(candidate->name[0] == '\0' && ti__migration_same(candidate->type, m->type)) {
+                    match = candidate;
+                }
+            }
+            if(match) {
+                ti__migration_compile(b, match->type, from_offset + match->offset, m->type,
+                                      to_offset + m->offset);
+            } else {
+                ti__migration_push(b, zero);
+            }
+        } else {
+            size_t len = m->name_length ? m->name_length : strlen(m->name);
+            size_t offset = 0;
+            const Type_Info_Member* match = ti_find_member_at((Type_Info*)from, m->name, len,
+                                                              &offset);
+            if(m->bit_width > 0 || (match && match->bit_width > 0)) {
+                ti__migration_compile_bits(b, match, from_offset + offset, m,
+                                           to_offset + m->offset);
+            } else if(match) {
+                ti__migration_compile(b, match->type, from_offset + offset, m->type,
+                                      to_offset + m->offset);
+            } else {
+                ti__migration_push(b, zero);
+            }
+        }
+    }
+}
+
+static void ti__migration_compile_array(Ti__Migration_Builder* b, const Type_Info* from,
+                                        size_t from_offset, const Type_Info* to, size_t to_offset) {
+    size_t from_count, to_count;
+    const Type_Info* from_type = ti__elements(from, &from_count);
+    const Type_Info* to_type = ti__elements(to, &to_count);
+    size_t count = from_count < to_count ? from_count : to_count;
+    size_t from_elem = from_type->size, to_elem = to_type->size;
+
+    if(count > 0) {
+        Ti__Migration_Builder body = {0};
+        ti__migration_compile(&body, from_type, 0, to_type, 0);
+        if(body.failed) b->failed = true;
+
+        Type_Info_Migration_Op* op = body.size == 1 ? &body.items[0] : NULL;
+        if(op && op->size == to_elem && op->bit_width == 0 &&
+           (op->kind == TYPE_INFO_MIGRATE_ZERO ||
+            (op->kind == TYPE_INFO_MIGRATE_COPY && from_elem == to_elem))) {
+            // Elements copied or zeroed whole: the common elements are a single op
+            Type_Info_Migration_Op all = {
+                op->kind, to_offset, from_offset, count * to_elem, 0, false, 0, 0, 0, 0, 0, 0};
+            ti__migration_push(b, all);
+        } else if(body.size > 0) {
+            Type_Info_Migration_Op loop = {TYPE_INFO_MIGRATE_LOOP, to_offset, from_offset, to_elem,
+                                           from_elem, false, count, body.size, 0, 0, 0, 0};
+            ti__migration_push(b, loop);
+            for(size_t i = 0; i < body.size; i++) {
+                b->barrier = true;  // Keep the body ops as they are
+                ti__migration_push(b, body.items[i]);
+            }
+            b->barrier = true;
+        }
+        TI_FREE(body.items);
+    }
+
+    Type_Info_Migration_Op rest = {TYPE_INFO_MIGRATE_ZERO, to_offset + count * to_elem, 0,
+                                   (to_count - count) * to_elem, 0, false, 0, 0, 0, 0, 0, 0};
+    ti__migration_push(b, rest);
+}
+
+static void ti__migration_compile(Ti__Migration_Builder* b, const Type_Info* from,
+                                  size_t from_offset, const Type_Info* to, size_t to_offset) {
+    Type_Info_Migration_Op op = {TYPE_INFO_MIGRATE_ZERO, to_offset, from_offset, to->size,
+                                 from->size, false, 0, 0, 0, 0, 0, 0};
+    if(ti__migration_same(from, to)) {
+        op.kind = TYPE_INFO_MIGRATE_COPY;
+    } else if(ti__migration_is_integer(from) && ti__migration_is_integer(to)) {
+        op.kind = from->size == to->size ? TYPE_INFO_MIGRATE_COPY : TYPE_INFO_MIGRATE_INT;
+        op.from_signed = ti__is_signed(from);
+    } else if(ti__migration_is_float(from) && ti__migration_is_float(to)) {
+        op.kind = TYPE_INFO_MIGRATE_FLOAT;
+    } else if(ti__migration_is_integer(from) && ti__migration_is_float(to)) {
+        op.kind = TYPE_INFO_MIGRATE_INT_TO_FLOAT;
+        op.from_signed = ti__is_signed(from);
+    } else if(from->tag == TYPE_TAG_STRUCT && to->tag == TYPE_TAG_STRUCT) {
+        ti__migration_compile_record(b, from, from_offset, to, to_offset);
+        return;
+    } else if((from->tag == TYPE_TAG_ARRAY || from->tag == TYPE_TAG_VECTOR) &&
+              (to->tag == TYPE_TAG_ARRAY || to->tag == TYPE_TAG_VECTOR)) {
+        ti__migration_compile_array(b, from, from_offset, to, to_offset);
+        return;
+    }
+    if(op.kind == TYPE_INFO_MIGRATE_COPY || op.kind == TYPE_INFO_MIGRATE_ZERO) op.from_size = 0;
+    ti__migration_push(b, op);
+}
+
+Type_Info_Migration* ti_migration_compile(const Type_Info* from, const Type_Info* to) {
+    Ti__Migration_Builder b = {0};
+    ti__migration_compile(&b, from, 0, to, 0);
+
+    Type_Info_Migration* migration = NULL;
+    if(!b.failed) migration = TI_MALLOC(sizeof(*migration) + b.size * sizeof(*b.items));
+    if(migration) {
+        migration->from_fingerprint = ti__migration_key(from);
+        migration->to_fingerprint = ti__migration_key(to);
+        migration->from_size = from->size;
+        migration->to_size = to->size;
+        migration->ops_count = b.size;
+        if(b.size) memcpy(migration->ops, b.items, b.size * sizeof(*b.items));
+    }
+    TI_FREE(b.items);
+    return migration;
+}
+
+void ti_migration_free(Type_Info_Migration* migration) {
+    TI_FREE(migration);
+}
+
+// Open-addressing table of the migrations compiled by `ti_migration_get`
+static struct {
+    Type_Info_Migration** slots;
+    size_t count, capacity;  // Capacity is a power of two, or 0
+} ti__migrations;
+
+static size_t ti__migration_slot(Type_Info_Migration** slots, size_t capacity, uint64_t from,
+                                 uint64_t to) {
+    size_t mask = capacity - 1;
+    size_t i = (size_t)ti_hash_mix(from ^ ti_hash_mix(to)) & mask;
+    while(slots[i] && (slots[i]->from_fingerprint != from || slots[i]->to_fingerprint != to)) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+const Type_Info_Migration* ti_migration_get(const Type_Info* from, const Type_Info* to) {
+    uint64_t from_key = ti__migration_key(from), to_key = ti__migration_key(to);
+    if(ti__migrations.capacity) {
+        size_t i = ti__migration_slot(ti__migrations.slots, ti__migrations.capacity, from_key,
+                                      to_key);
+        if(ti__migrations.slots[i]) return ti__migrations.slots[i];
+    }
+
+    if((ti__migrations.count + 1) * 2 > ti__migrations.capacity) {
+        size_t capacity = ti__migrations.capacity ? ti__migrations.capacity * 2 : 16;
+        Type_Info_Migration** slots = TI_MALLOC(capacity * sizeof(*slots));
+        if(!slots) return NULL;
+        memset(slots, 0, capacity * sizeof(*slots));
+        for(size_t i = 0; i < ti__migrations.capacity; i++) {
+            Type_Info_Migration* m = ti__migrations.slots[i];
+            if(m) slots[ti__migration_slot(slots, capacity, m->from_fingerprint, m->to_fingerprint)] = m;
+        }
+        TI_FREE(ti__migrations.slots);
+        ti__migrations.slots = slots, ti__migrations.capacity = capacity;
+    }
+
+    Type_Info_Migration* migration = ti_migration_compile(from, to);
+    if(!migration) return NULL;
+    ti__migrations.slots[ti__migration_slot(ti__migrations.slots, ti__migrations.capacity, from_key,
+                                            to_key)] = migration;
+    ti__migrations.count++;
+    return migration;
+}
+
+void ti_migration_cache_clear(void) {
+    for(size_t i = 0; i < ti__migrations.capacity; i++) {
+        ti_migration_free(ti__migrations.slots[i]);
+    }
+    TI_FREE(ti__migrations.slots);
+    memset(&ti__migrations, 0, sizeof(ti__migrations));
+}
+
+static long double ti__migration_read_float(const char* p, size_t size) {
+    if(size == sizeof(float)) {
+        float f;
+        memcpy(&f, p, sizeof(f));
+        return f;
+    } else if(size == sizeof(double)) {
+        double d;
+        memcpy(&d, p, sizeof(d));
+        return d;
+    }
+    long double ld;
+    memcpy(&ld, p, sizeof(ld));
+    return ld;
+}
+
+static void ti__migration_write_float(char* p, size_t size, long double v) {
+    if(size == sizeof(float)) {
+        float f = (float)v;
+        memcpy(p, &f, sizeof(f));
+    } else if(size == sizeof(double)) {
+        double d = (double)v;
+        memcpy(p, &d, sizeof(d));
+    } else {
+        memcpy(p, &v, sizeof(v));
+    }
+}
+
+static uint64_t ti__migration_load_int(const Type_Info_Migration_Op* op, const char* src) {
+    if(op->from_bit_width > 0) {
+        return ti_bits_get(src, op->from_bit_offset, op->from_bit_width, op->from_signed);
+    }
+    return ti__load_int(src, op->from_size, op->from_signed);
+}
+
+static void ti__migration_store_int(const Type_Info_Migration_Op* op, char* dst, uint64_t v) {
+    if(op->bit_width > 0) ti_bits_set(dst, op->bit_offset, op->bit_width, v);
+    else ti__store_int(dst, op->size, v);
+}
+
+static void ti__migrate(const Type_Info_Migration_Op* ops, size_t ops_count, char* to,
+                        const char* from) {
+    for(size_t i = 0; i < ops_count; i++) {
+        const Type_Info_Migration_Op* op = &ops[i];
+        char* dst = to + op->to_offset;
+        const char* src = from + op->from_offset;
+        switch(op->kind) {
+        case TYPE_INFO_MIGRATE_COPY:
+            memcpy(dst, src, op->size);
+            break;
+        case TYPE_INFO_MIGRATE_ZERO:
+            if(op->bit_width > 0) ti_bits_set(dst, op->bit_offset, op->bit_width, 0);
+            else memset(dst, 0, op->size);
+            break;
+        case TYPE_INFO_MIGRATE_INT:
+            ti__migration_store_int(op, dst, ti__migration_load_int(op, src));
+            break;
+        case TYPE_INFO_MIGRATE_FLOAT:
+            ti__migration_write_float(dst, op->size, ti__migration_read_float(src, op->from_size));
+            break;
+        case TYPE_INFO_MIGRATE_INT_TO_FLOAT: {
+            uint64_t v = ti__migration_load_int(op, src);
+            ti__migration_write_float(dst, op->size,
+                                      op->from_signed ? (long double)(int64_t)v : (long double)v);
+        } break;
+        case TYPE_INFO_MIGRATE_LOOP:
+            for(size_t e = 0; e < op->count; e++) {
+                ti__migrate(op + 1, op->body_count, dst + e * op->size, src + e * op->from_size);
+            }
+            i += op->body_count;
+            break;
+        }
+    }
+}
+
+void ti_migrate(const Type_Info_Migration* migration, void* to, const void* from, size_t count) {
+    char* dst = (char*)to;
+    const char* src = (const char*)from;
+    // An unchanged type is copied as-is
+    if(migration->ops_count == 1 && migration->ops[0].kind == TYPE_INFO_MIGRATE_COPY &&
+       migration->ops[0].size == migration->to_size && migration->from_size == migration->to_size) {
+        memcpy(dst, src, count * migration->to_size);
+        return;
+    }
+    for(size_t i = 0; i < count; i++) {
+        ti__migrate(migration->ops, migration->ops_count, dst, src);
+        dst += migration->to_size;
+        src += migration->from_size;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// SECTION: Streaming decoding
+//
+
+size_t ti_max_depth(const Type_Info* type) {
+    switch(type->tag) {
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        return 1 + ti_max_depth(ti__elements(type, &count));
+    }
+    case TYPE_TAG_STRUCT:
+    case TYPE_TAG_UNION: {
+        const Type_Info_Struct* s = (const Type_Info_Struct*)type;
+        size_t depth = 0;
+        for(size_t i = 0; i < s->members_count; i++) {
+            size_t d = ti_max_depth(s->members[i].type);
+            if(d > depth) depth = d;
+        }
+        return 1 + depth;
+    }
+    default:
+        return 0;
+    }
+}
+
+static bool ti__stream_push(Type_Info_Stream* s, const Type_Info* type, char* value) {
+    if(s->frames_count == s->frames_capacity) return false;
+    Type_Info_Stream_Frame* f = &s->frames[s->frames_count++];
+    f->type = type;
+    f->value = value;
+    f->member_index = 0;
+    f->array_index = 0;
+    return true;
+}
+
+// Binary
+
+static bool ti__stream_binary_enter(Type_Info_Stream* s, const Type_Info* type, char* value) {
+    if(ti__is_raw_serializable(type)) {
+        s->leaf = value;
+        s->leaf_remaining = type->size;
+        return true;
+    }
+    switch(type->tag) {
+    case TYPE_TAG_VOID:
+        return true;
+    case TYPE_TAG_POINTER:
+        memset(value, 0, type->size);
+        return true;
+    case TYPE_TAG_INTEGER:
+    case TYPE_TAG_FLOAT:
+    case TYPE_TAG_ENUM:
+    case TYPE_TAG_UNION:
+        s->leaf = value;
+        s->leaf_remaining = type->size;
+        return true;
+    case TYPE_TAG_ARRAY:
+    case TYPE_TAG_VECTOR: {
+        size_t count;
+        const Type_Info* elem = ti__elements(type, &count);
+        Type_Info_Tag elem_tag = elem->tag;
+        if(elem_tag == TYPE_TAG_INTEGER || elem_tag == TYPE_TAG_FLOAT || elem_tag == TYPE_TAG_ENUM) {
+            s->leaf = value;
+            s->leaf_remaining = count * elem->size;
+            return true;
+        }
+        return ti__stream_push(s, type, value);
+    }
+    case TYPE_TAG_STRUCT:
+        return ti__stream_push(s, type, value);
+    }
+    return false;
+}
+
+static const char* ti__stream_feed_binary(Type_Info_Stream* s, const char* p, const char* end) {
+    for(;;) {
+        if(s->leaf_remaining > 0) {
+            size_t n = (size_t)(end - p) < s->leaf_remaining ? (size_t)(end - p) : s->leaf_remaining;
+            memcpy(s->leaf, p, n);
+            s->leaf += n;
+            s->leaf_remaining -= n;
+            p += n;
+            if(s->leaf_remaining > 0) return p;
+        }
+        if(s->frames_count == 0) {
+            s->status = TYPE_INFO_STREAM_DONE;
+            return p;
+        }
+
+        Type_Info_Stream_Frame* f = &s->frames[s->frames_count - 1];
+        const Type_Info* child;
+        char* child_value;
+        if(f->type->tag == TYPE_TAG_ARRAY) {
+            const Type_Info_Array* a = (const Type_Info_Array*)f->type;
+            if(f->array_index == a->num_elements) {
+                s->frames_count--;
+                continue;
+            }
+            child = a->element_type;
+            child_value = f->value + f->array_index++ * child->size;
+        } else {
+            const Type_Info_Struct* st = (const Type_Info_Struct*)f->type;
+            if(f->member_index == st->members_count) {
+                s->frames_count--;
+                continue;
+            }
+            const Type_Info_Member* m = &st->members[f->member_index];
+            if(m->bit_width > 0) {
+                uint64_t mask;
+                f->member_index = ti__bitfield_run(st->members, st->members_count, f->member_index,
+                                                   &s->leaf_remaining, &mask);
+                s->leaf = f->value + m->offset;
+                continue;
+            }
+            f->member_index++;
+            child = m->type;
+            child_value = f->value + m->offset;
+        }
+        if(!ti__stream_binary_enter(s, child, child_value)) {
+            s->status = TYPE_INFO_STREAM_ERROR;
+            return p;
+        }
+    }
+}
+
+// JSON
+
+enum {
+    TI__STREAM_VALUE,
+    TI__STREAM_KEY_OR_END,  // After '{'
+    TI__STREAM_KEY,         // After ',' in an object
+    TI__STREAM_COLON,
+    TI__STREAM_VALUE_OR_END,  // After '['
+    TI__STREAM_COMMA_OR_END,
+    TI__STREAM_STRING,
+    TI__STREAM_TOKEN,  // Numbers and literals
+};
+
+enum {
+    TI__STREAM_STRING_KEY,
+    TI__STREAM_STRING_CSTR,
+    TI__STREAM_STRING_ENUM,
+    TI__STREAM_STRING_SKIP,
+};
+
+static void ti__stream_value_done(Type_Info_Stream* s) {
+    if(s->nesting == 0) s->status = TYPE_INFO_STREAM_DONE;
+    else s->state = TI__STREAM_COMMA_OR_END;
+}
+
+static bool ti__stream_in_object(const Type_Info_Stream* s) {
+    size_t i = s->nesting - 1;
+    return (s->objects[i / 64] >> (i % 64)) & 1;
+}
+
+static bool ti__stream_open(Type_Info_Stream* s, bool object) {
+    if(s->nesting == TI_JSON_MAX_NESTING) return false;
+    size_t i = s->nesting++;
+    if(object) s->objects[i / 64] |= 1ULL << (i % 64);
+    else s->objects[i / 64] &= ~(1ULL << (i % 64));
+    return true;
+}
+
+static bool ti__stream_close(Type_Info_Stream* s, char c) {
+    if((c == '}') != ti__stream_in_object(s)) return false;
+    s->nesting--;
+    if(s->frames_count > s->nesting) s->frames_count--;
+    ti__stream_value_done(s);
+    return true;
+}
+
+static void ti__stream_set_target(Type_Info_Stream* s, const Type_Info* type, char* value,
+                                  bool cstr) {
+    s->target = type && type->tag != TYPE_TAG_VOID ? type : NULL;
+    s->target_value = value;
+    s->target_cstr = cstr;
+    s->target_bitfield = NULL;
+}
+
+// Stores the value decoded for a bitfield target. Returns false if it doesn't fit.
+static bool ti__stream_store_bitfield(Type_Info_Stream* s) {
+    return !s->target_bitfield ||
+           ti__bitfield_store(s->target_bitfield, s->target_record, &s->bitfield_value);
+}
+
+// Targets the next element of the innermost array
+static bool ti__stream_next_element(Type_Info_Stream* s) {
+    if(s->nesting > s->frames_count) {
+        ti__stream_set_target(s, NULL, NULL, false);
+        return true;
+    }
+    Type_Info_Stream_Frame* f = &s->frames[s->frames_count - 1];
+    size_t count;
+    const Type_Info* elem = ti__elements(f->type, &count);
+    if(f->array_index == count) return false;
+    ti__stream_set_target(s, elem, f->value + f->array_index++ * elem->size, false);
+    return true;
+}
+
+static void ti__stream_begin_string(Type_Info_Stream* s, int kind, char* dst, size_t cap) {
+    s->state = TI__STREAM_STRING;
+    s->string_kind = kind;
+    s->string = dst;
+    s->string_len = 0;
+    s->string_cap = cap;
+    s->escape_len = 0;
+}
+
+static bool ti__stream_append(Type_Info_Stream* s, const char* str, size_t len) {
+    if(s->string_kind == TI__STREAM_STRING_SKIP) return true;
+    if(len > s->string_cap - s->string_len) return false;
+    memcpy(s->string + s->string_len, str, len);
+    s->string_len += len;
+    return true;
+}
+
+static bool ti__stream_escape_complete(const Type_Info_Stream* s) {
+    if(s->escape_len < 2) return false;
+    if(s->escape[1] != 'u') return true;
+    if(s->escape_len < 6) return false;
+    if(s->escape_len == 6) {
+        int cp = ti__json_hex4(s->escape + 2);
+        return cp < 0xD800 || cp > 0xDBFF;  // Else wait for the low surrogate
+    }
+    return s->escape_len == 12;
+}
+
+static bool ti__stream_end_string(Type_Info_Stream* s) {
+    switch(s->string_kind) {
+    case TI__STREAM_STRING_KEY: {
+        s->state = TI__STREAM_COLON;
+        if(s->nesting > s->frames_count) {
+            ti__stream_set_target(s, NULL, NULL, false);
+            return true;
+        }
+        Type_Info_Stream_Frame* f = &s->frames[s->frames_count - 1];
+        size_t offset;
+        Type_Info_Member* m = ti_find_member_at((Type_Info*)f->type, s->string, s->string_len,
+                                                &offset);
+        if(m && m->bit_width > 0) {
+            ti__stream_set_target(s, m->type, (char*)&s->bitfield_value, false);
+            s->target_bitfield = m;
+            s->target_record = f->value + offset - m->offset;
+            ti__bitfield_load(m, s->target_record, &s->bitfield_value);
+        } else if(m) {
+            ti__stream_set_target(s, m->type, f->value + offset, ti__is_cstr_member(m));
+        } else {
+            ti__stream_set_target(s, NULL, NULL, false);
+        }
+        return true;
+    }
+    case TI__STREAM_STRING_CSTR:
+        s->string[s->string_len] = '\0';
+        break;
+    case TI__STREAM_STRING_ENUM: {
+        long long v;
+        if(!ti_enum_parse((const Type_Info_Enum*)s->target, s->string, s->string_len, &v)) {
+            return false;
+        }
+        ti__write_enum(s->target, s->target_value, v);
+        if(!ti__stream_store_bitfield(s)) return false;
+    } break;
+    }
+    ti__stream_value_done(s);
+    return true;
+}
+
+static const char* ti__stream_feed_string(Type_Info_Stream* s, const char* p, const char* end) {
+    while(p < end) {
+        if(s->escape_len > 0) {
+            s->escape[s->escape_len++] = *p++;
+            if(ti__stream_escape_complete(s)) {
+                char utf8[4];
+                size_t len;
+                if(!ti__json_unescape(s->escape, s->escape_len, utf8, sizeof(utf8), &len) ||
+                   !ti__stream_append(s, utf8, len)) {
+                    s->status = TYPE_INFO_STREAM_ERROR;
+                    return p;
+                }
+                s->escape_len = 0;
+            }
+            continue;
+        }
+
+        const char* run = p;
+        while(p < end && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20) p++;
+        if(!ti__stream_append(s, run, (size_t)(p - run))) {
+            s->status = TYPE_INFO_STREAM_ERROR;
+            return p;
+        }
+        if(p == end) break;
+
+        char c = *p++;
+        if(c == '\\') {
+            s->escape[0] = c;
+            s->escape_len = 1;
+        } else if(c != '"' || !ti__stream_end_string(s)) {
+            s->status = TYPE_INFO_STREAM_ERROR;
+            return p;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+static bool ti__stream_end_token(Type_Info_Stream* s) {
+    Ti__Json_Parser ps = {s->token, s->token + s->token_len, 0};
+    bool ok = s->target ? ti__json_decode(&ps, s->target, s->target_value)
+                        : ti__json_skip_value(&ps);
+    if(!ok || ps.p != ps.end || !ti__stream_store_bitfield(s)) return false;
+    ti__stream_value_done(s);
+    return true;
+}
+
+static bool ti__stream_begin_value(Type_Info_Stream* s, char c) {
+    if(s->target_cstr && c != '"' && c != 'n') return false;
+    while(s->target && s->target->tag == TYPE_TAG_POINTER && c != 'n') {
+        // Decode into the existing pointee, as `ti_json_decode`
+        const Type_Info* pointee = ((const Type_Info_Pointer*)s->target)->pointer_to;
+        char* p;
+        memcpy(&p, s->target_value, sizeof(p));
+        if(s->target_cstr || !p || !pointee || pointee->tag == TYPE_TAG_VOID) return false;
+        ti__stream_set_target(s, pointee, p, false);
+    }
+
+    const Type_Info* t = s->target;
+    switch(c) {
+    case '{':
+        if(t && t->tag != TYPE_TAG_STRUCT && t->tag != TYPE_TAG_UNION) return false;
+        if(!ti__stream_open(s, true) || (t && !ti__stream_push(s, t, s->target_value))) {
+            return false;
+        }
+        s->state = TI__STREAM_KEY_OR_END;
+        return true;
+    case '[':
+        if(t && t->tag != TYPE_TAG_ARRAY && t->tag != TYPE_TAG_VECTOR) return false;
+        if(!ti__stream_open(s, false) || (t && !ti__stream_push(s, t, s->target_value))) {
+            return false;
+        }
+        s->state = TI__STREAM_VALUE_OR_END;
+        return true;
+    case '"':
+        if(!t) {
+            ti__stream_begin_string(s, TI__STREAM_STRING_SKIP, NULL, 0);
+        } else if(s->target_cstr && t->tag == TYPE_TAG_ARRAY) {
+            size_t cap = ((const Type_Info_Array*)t)->num_elements;
+            if(cap == 0) return false;
+            ti__stream_begin_string(s, TI__STREAM_STRING_CSTR, s->target_value, cap - 1);
+        } else if(t->tag == TYPE_TAG_ENUM) {
+            ti__stream_begin_string(s, TI__STREAM_STRING_ENUM, s->token, sizeof(s->token));
+        } else {
+            return false;
+        }
+        return true;
+    default:
+        s->state = TI__STREAM_TOKEN;
+        s->token_len = 0;
+        return true;
+    }
+}
+
+static bool ti__stream_is_token_char(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           c == '-' || c == '+' || c == '.';
+}
+
+static const char* ti__stream_feed_json(Type_Info_Stream* s, const char* p, const char* end) {
+    while(p < end && s->status == TYPE_INFO_STREAM_NEED_MORE) {
+        if(s->state == TI__STREAM_STRING) {
+            p = ti__stream_feed_string(s, p, end);
+            continue;
+        }
+
+        char c = *p;
+        bool ok = true;
+        if(s->state == TI__STREAM_TOKEN) {
+            if(ti__stream_is_token_char(c)) {
+                if(s->token_len == sizeof(s->token)) ok = false;
+                else s->token[s->token_len++] = c, p++;
+            } else {
+                ok = ti__stream_end_token(s);
+            }
+        } else if(c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+            p++;
+        } else {
+            switch(s->state) {
+            case TI__STREAM_VALUE:
+                ok = ti__stream_begin_value(s, c);
+                if(s->state != TI__STREAM_TOKEN) p++;
+                break;
+            case TI__STREAM_KEY_OR_END:
+            case TI__STREAM_KEY:
+                if(c == '}' && s->state == TI__STREAM_KEY_OR_END) {
+                    ok = ti__stream_close(s, c);
+                } else if(c == '"') {
+                    ti__stream_begin_string(s, TI__STREAM_STRING_KEY, s->token, sizeof(s->token));
+                } else {
+                    ok = false;
+                }
+                p++;
+                break;
+            case TI__STREAM_COLON:
+                ok = c == ':';
+                s->state = TI__STREAM_VALUE;
+                p++;
+                break;
+            case TI__STREAM_VALUE_OR_END:
+                if(c == ']') {
+                    ok = ti__stream_close(s, c);
+                    p++;
+                } else {
+                    ok = ti__stream_next_element(s);
+                    s->state = TI__STREAM_VALUE;
+                }
+                break;
+            case TI__STREAM_COMMA_OR_END:
+                if(c == '}' || c == ']') {
+                    ok = ti__stream_close(s, c);
+                } else if(c != ',') {
+                    ok = false;
+                } else if(ti__stream_in_object(s)) {
+                    s->state = TI__STREAM_KEY;
+                } else {
+                    ok = ti__stream_next_element(s);
+                    s->state = TI__STREAM_VALUE;
+                }
+                p++;
+                break;
+            }
+        }
+        if(!ok) s->status = TYPE_INFO_STREAM_ERROR;
+    }
+    return p;
+}
+
+void ti_stream_init(Type_Info_Stream* stream, Type_Info_Stream_Format format, Type_Any out,
+                    Type_Info_Stream_Frame* frames, size_t frames_capacity) {
+    memset(stream, 0, sizeof(*stream));
+    stream->format = format;
+    stream->status = TYPE_INFO_STREAM_NEED_MORE;
+    stream->frames = frames;
+    stream->frames_capacity = frames_capacity;
+    if(format == TYPE_INFO_STREAM_BINARY) {
+        if(!ti__stream_binary_enter(stream, out.type, (char*)out.value)) {
+            stream->status = TYPE_INFO_STREAM_ERROR;
+        }
+    } else {
+        stream->state = TI__STREAM_VALUE;
+        ti__stream_set_target(stream, out.type, (char*)out.value, false);
+    }
+}
+
+Type_Info_Stream_Status ti_stream_feed(Type_Info_Stream* stream, const void* data, size_t size,
+                                       size_t* consumed) {
+    const char* p = (const char*)data;
+    const char* end = p + size;
+    if(stream->status == TYPE_INFO_STREAM_NEED_MORE) {
+        if(size == 0) {
+            // End of the input
+            bool ok = false;
+            if(stream->format == TYPE_INFO_STREAM_JSON && stream->state == TI__STREAM_TOKEN &&
+               stream->nesting == 0) {
+                ok = ti__stream_end_token(stream);
+            } else if(stream->format == TYPE_INFO_STREAM_BINARY) {
+                p = ti__stream_feed_binary(stream, p, end);
+                ok = stream->status == TYPE_INFO_STREAM_DONE;
+            }
+            if(!ok) stream->status = TYPE_INFO_STREAM_ERROR;
+        } else if(stream->format == TYPE_INFO_STREAM_BINARY) {
+            p = ti__stream_feed_binary(stream, p, end);
+        } else {
+            p = ti__stream_feed_json(stream, p, end);
+        }
+    }
+    if(consumed) *consumed = (size_t)(p - (const char*)data);
+    return stream->status;
+}
+
+#endif  // TYPEINFO_IMPL_H_
+#endif  // TYPEINFO_IMPL
@@ -1,6 +1,11 @@
+#define TYPEINFO_IMPL
+#define EXTLIB_IMPL
+#define EXTLIB_NO_SHORTHANDS
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #undef __STRICT_ANSI__
@@ -8,6 +13,7 @@
 #define CTEST_SEGFAULT
 #define CTEST_COLOR_OK
 #include "ctest.h"
+#include "extlib.h"
 #include "test_types.h"
 #include "test_types_typeinfo.h"
 #include "typeinfo.h"
@@ -167,6 +173,14 @@ CTEST(pointer_types, test_const_volatile_pointer) {
     ASSERT_TRUE(ptr_type->qualifier_flags & TYPE_INFO_QUALIFIER_VOLATILE);
 }
 
+CTEST(pointer_types, test_shared_instances) {
+    // `int*` and `int* const` are the same type, `const int*` isn't
+    Type_Info* ptr = find_member(&typeinfo_TestPointers, "ptr")->type;
+    ASSERT_TRUE(ptr == find_member(&typeinfo_TestPointers, "ptr_const")->type);
+    ASSERT_TRUE(ptr == find_member(&typeinfo_TestSerializeElement, "ptr")->type);
+    ASSERT_TRUE(ptr != find_member(&typeinfo_TestPointers, "const_ptr")->type);
+}
+
 // ==============================================================================
 // Array Type Tests
 // ==============================================================================
@@ -193,6 +207,7 @@ CTEST(array_types, test_string_array_with_annotation) {
     Type_Info_Array* arr_type = (Type_Info_Array*)member->type;
     ASSERT_EQUAL(256, arr_type->num_elements);
     ASSERT_TRUE(has_annotation(member->annotations, "CStr"));
+    ASSERT_TRUE(ti_has_annotation(member->annotation_set, TI_ANN_CStr));
 }
 
 CTEST(array_types, test_multidimensional_array) {
@@ -215,6 +230,7 @@ CTEST(struct_types, test_point_struct_annotation) {
     ASSERT_NOT_NULL(&typeinfo_Point);
     ASSERT_EQUAL(TYPE_TAG_STRUCT, typeinfo_Point.base.tag);
     ASSERT_TRUE(has_annotation(typeinfo_Point.annotations, "StructAnnotation"));
+    ASSERT_TRUE(ti_has_annotation(typeinfo_Point.annotation_set, TI_ANN_StructAnnotation));
 }
 
 CTEST(struct_types, test_point_members) {
@@ -227,6 +243,33 @@ CTEST(struct_types, test_point_members) {
     ASSERT_TRUE(has_annotation(y->annotations, "YCoord"));
 }
 
+CTEST(struct_types, test_point_annotation_sets) {
+    Type_Info_Member* x = find_member(&typeinfo_Point, "x");
+    Type_Info_Member* y = find_member(&typeinfo_Point, "y");
+    ASSERT_NOT_NULL(x);
+    ASSERT_NOT_NULL(y);
+    // Each member only has its own annotation
+    ASSERT_EQUAL(TYPE_INFO_ANNOTATION_BIT(TI_ANN_XCoord), x->annotation_set);
+    ASSERT_EQUAL(TYPE_INFO_ANNOTATION_BIT(TI_ANN_YCoord), y->annotation_set);
+    ASSERT_FALSE(ti_has_annotation(typeinfo_Point.annotation_set, TI_ANN_XCoord));
+}
+
+CTEST(struct_types, test_annotation_ids_are_interned) {
+    // The same annotation string gets the same ID in every type
+    Type_Info_Member* data = find_member(&typeinfo_TestComplex, "data");
+    ASSERT_NOT_NULL(data);
+    Type_Info_Member* name = find_member((Type_Info_Struct*)data->type, "name");
+    ASSERT_NOT_NULL(name);
+    ASSERT_TRUE(ti_has_annotation(name->annotation_set, TI_ANN_CStr));
+    // Checked by the runtime, so fixed in every generated file
+    ASSERT_EQUAL(TYPE_INFO_ANNOTATION_CSTR, TI_ANN_CStr);
+
+    Type_Info_Member* id = find_member(&typeinfo_TestComplex, "id");
+    ASSERT_NOT_NULL(id);
+    ASSERT_EQUAL(0, id->annotation_set);
+    ASSERT_FALSE(ti_has_annotation(id->annotation_set, 64));
+}
+
 CTEST(struct_types, test_nested_struct) {
     Type_Info_Member* member = find_member(&typeinfo_TestStructs, "point");
     ASSERT_NOT_NULL(member);
@@ -251,6 +294,7 @@ CTEST(union_types, test_union_exists) {
     ASSERT_NOT_NULL(&typeinfo_TestUnion);
     ASSERT_EQUAL(TYPE_TAG_UNION, typeinfo_TestUnion.base.tag);
     ASSERT_TRUE(has_annotation(typeinfo_TestUnion.annotations, "UnionAnnotation"));
+    ASSERT_TRUE(ti_has_annotation(typeinfo_TestUnion.annotation_set, TI_ANN_UnionAnnotation));
 }
 
 CTEST(union_types, test_union_members) {
@@ -302,6 +346,9 @@ CTEST(enum_types, test_enum_value_annotations) {
     ASSERT_NOT_NULL(error);
     ASSERT_TRUE(has_annotation(ok->annotations, "Success"));
     ASSERT_TRUE(has_annotation(error->annotations, "Failure"));
+    ASSERT_TRUE(ti_has_annotation(ok->annotation_set, TI_ANN_Success));
+    ASSERT_FALSE(ti_has_annotation(ok->annotation_set, TI_ANN_Failure));
+    ASSERT_TRUE(ti_has_annotation(error->annotation_set, TI_ANN_Failure));
 }
 
 CTEST(enum_types, test_enum_values) {
@@ -313,6 +360,97 @@ CTEST(enum_types, test_enum_values) {
     ASSERT_EQUAL(STATUS_PENDING, pending->value);
 }
 
+CTEST(enum_types, test_enum_signedness) {
+    // Follows the underlying integer type, which is signed when a value is negative
+    ASSERT_FALSE(typeinfo_Status.is_signed);
+    ASSERT_TRUE(typeinfo_TestSparseEnum.is_signed);
+    ASSERT_TRUE(typeinfo_TestDenseEnum.is_signed);
+    Type_Info_Enum* anonymous = (Type_Info_Enum*)find_member(&typeinfo_TestComplex, "type")->type;
+    ASSERT_FALSE(anonymous->is_signed);
+}
+
+CTEST(enum_types, test_enum_name_dense) {
+    ASSERT_NOT_NULL(typeinfo_Status.value_table);
+    ASSERT_STR("STATUS_OK", ti_enum_name(&typeinfo_Status, STATUS_OK));
+    ASSERT_STR("STATUS_ERROR", ti_enum_name(&typeinfo_Status, STATUS_ERROR));
+    ASSERT_STR("STATUS_PENDING", ti_enum_name(&typeinfo_Status, STATUS_PENDING));
+    ASSERT_NULL(ti_enum_name(&typeinfo_Status, -1));
+    ASSERT_NULL(ti_enum_name(&typeinfo_Status, 3));
+}
+
+CTEST(enum_types, test_enum_name_dense_with_holes) {
+    ASSERT_NOT_NULL(typeinfo_TestDenseEnum.value_table);
+    ASSERT_EQUAL(-2, typeinfo_TestDenseEnum.min_value);
+    ASSERT_STR("DENSE_MINUS_TWO", ti_enum_name(&typeinfo_TestDenseEnum, DENSE_MINUS_TWO));
+    ASSERT_STR("DENSE_TWO", ti_enum_name(&typeinfo_TestDenseEnum, DENSE_TWO));
+    ASSERT_NULL(ti_enum_name(&typeinfo_TestDenseEnum, -1));
+    ASSERT_NULL(ti_enum_name(&typeinfo_TestDenseEnum, LLONG_MIN));
+    ASSERT_NULL(ti_enum_name(&typeinfo_TestDenseEnum, LLONG_MAX));
+}
+
+CTEST(enum_types, test_enum_name_sparse) {
+    ASSERT_NULL(typeinfo_TestSparseEnum.value_table);
+    ASSERT_NOT_NULL(typeinfo_TestSparseEnum.value_index.slots);
+    ASSERT_STR("SPARSE_NEGATIVE", ti_enum_name(&typeinfo_TestSparseEnum, SPARSE_NEGATIVE));
+    ASSERT_STR("SPARSE_ONE", ti_enum_name(&typeinfo_TestSparseEnum, SPARSE_ALIAS));
+    ASSERT_STR("SPARSE_THOUSAND", ti_enum_name(&typeinfo_TestSparseEnum, SPARSE_THOUSAND));
+    ASSERT_STR("SPARSE_BIG", ti_enum_name(&typeinfo_TestSparseEnum, SPARSE_BIG));
+    ASSERT_NULL(ti_enum_name(&typeinfo_TestSparseEnum, 2));
+    ASSERT_NULL(ti_enum_name(&typeinfo_TestSparseEnum, 0));
+}
+
+CTEST(enum_types, test_enum_name_anonymous) {
+    Type_Info_Member* type = find_member(&typeinfo_TestComplex, "type");
+    ASSERT_NOT_NULL(type);
+    Type_Info_Enum* e = (Type_Info_Enum*)type->type;
+    ASSERT_STR("TYPE_B", ti_enum_name(e, TYPE_B));
+}
+
+CTEST(enum_types, test_enum_name_without_tables) {
+    Type_Info_Enum e = typeinfo_TestSparseEnum;
+    e.value_index = (Type_Info_Hash_Index){0};
+    ASSERT_STR("SPARSE_THOUSAND", ti_enum_name(&e, SPARSE_THOUSAND));
+    ASSERT_NULL(ti_enum_name(&e, 2));
+}
+
+CTEST(enum_types, test_enum_parse) {
+    long long value = -1;
+    ASSERT_NOT_NULL(typeinfo_Status.name_index.slots);
+    ASSERT_TRUE(ti_enum_parse(&typeinfo_Status, "STATUS_ERROR", 12, &value));
+    ASSERT_EQUAL(STATUS_ERROR, value);
+    ASSERT_TRUE(ti_enum_parse(&typeinfo_TestSparseEnum, "SPARSE_ALIAS", 12, &value));
+    ASSERT_EQUAL(SPARSE_ALIAS, value);
+    ASSERT_TRUE(ti_enum_parse(&typeinfo_TestSparseEnum, "SPARSE_NEGATIVE", 15, &value));
+    ASSERT_EQUAL(SPARSE_NEGATIVE, value);
+}
+
+CTEST(enum_types, test_enum_parse_not_nul_terminated) {
+    const char* input = "STATUS_OK,STATUS_PENDING";
+    long long value = -1;
+    ASSERT_TRUE(ti_enum_parse(&typeinfo_Status, input, 9, &value));
+    ASSERT_EQUAL(STATUS_OK, value);
+    ASSERT_TRUE(ti_enum_parse(&typeinfo_Status, input + 10, 14, &value));
+    ASSERT_EQUAL(STATUS_PENDING, value);
+}
+
+CTEST(enum_types, test_enum_parse_unknown) {
+    long long value = 42;
+    ASSERT_FALSE(ti_enum_parse(&typeinfo_Status, "STATUS", 6, &value));
+    ASSERT_FALSE(ti_enum_parse(&typeinfo_Status, "STATUS_OKAY", 11, &value));
+    ASSERT_FALSE(ti_enum_parse(&typeinfo_Status, "STATUS_OK\0", 10, &value));
+    ASSERT_FALSE(ti_enum_parse(&typeinfo_Status, "", 0, &value));
+    ASSERT_EQUAL(42, value);
+}
+
+CTEST(enum_types, test_enum_parse_without_index) {
+    Type_Info_Enum e = typeinfo_Status;
+    long long value = -1;
+    e.name_index = (Type_Info_Hash_Index){0};
+    ASSERT_TRUE(ti_enum_parse(&e, "STATUS_PENDING", 14, &value));
+    ASSERT_EQUAL(STATUS_PENDING, value);
+    ASSERT_FALSE(ti_enum_parse(&e, "STATUS_PEND", 11, &value));
+}
+
 // ==============================================================================
 // Anonymous Type Tests
 // ==============================================================================
@@ -343,6 +481,119 @@ CTEST(anonymous_types, test_anonymous_union_members) {
     ASSERT_STR("", anon_union_type->name);  // Anonymous unions have empty names
 }
 
+// ==============================================================================
+// Member Lookup Tests
+// ==============================================================================
+
+CTEST(member_lookup, test_find_member) {
+    Type_Info* ti = &typeinfo_TestIntegers.base;
+    ASSERT_NOT_NULL(typeinfo_TestIntegers.member_index.slots);
+    for(size_t i = 0; i < typeinfo_TestIntegers.members_count; i++) {
+        Type_Info_Member* m = &typeinfo_TestIntegers.members[i];
+        ASSERT_TRUE(m == ti_find_member(ti, m->name, strlen(m->name)));
+    }
+    ASSERT_NULL(ti_find_member(ti, "i128", 4));
+    ASSERT_NULL(ti_find_member(ti, "i", 1));
+    ASSERT_NULL(ti_find_member(ti, "", 0));
+}
+
+CTEST(member_lookup, test_find_member_not_nul_terminated) {
+    const char* key = "u16\":";
+    Type_Info_Member* m = ti_find_member(&typeinfo_TestIntegers.base, key, 3);
+    ASSERT_NOT_NULL(m);
+    ASSERT_STR("u16", m->name);
+}
+
+CTEST(member_lookup, test_find_union_member) {
+    Type_Info_Member* bytes = ti_find_member(&typeinfo_TestUnion.base, "bytes", 5);
+    ASSERT_NOT_NULL(bytes);
+    ASSERT_TRUE(bytes == find_union_member(&typeinfo_TestUnion, "bytes"));
+}
+
+CTEST(member_lookup, test_find_anonymous_members) {
+    size_t offset = 0;
+    Type_Info_Member* x = ti_find_member_at(&typeinfo_TestAnonymous.base, "anon_y", 6, &offset);
+    ASSERT_NOT_NULL(x);
+    ASSERT_STR("anon_y", x->name);
+    ASSERT_EQUAL(offsetof(TestAnonymous, anon_y), offset);
+
+    Type_Info_Member* f = ti_find_member_at(&typeinfo_TestAnonymous.base, "as_float", 8, &offset);
+    ASSERT_NOT_NULL(f);
+    ASSERT_EQUAL(TYPE_TAG_FLOAT, f->type->tag);
+    ASSERT_EQUAL(offsetof(TestAnonymous, as_float), offset);
+}
+
+CTEST(member_lookup, test_find_deep_anonymous_members) {
+    Type_Info* ti = &typeinfo_TestDeepAnonymous.base;
+    size_t offset = 0;
+    Type_Info_Member* m = ti_find_member_at(ti, "deep_float", 10, &offset);
+    ASSERT_NOT_NULL(m);
+    ASSERT_STR("deep_float", m->name);
+    ASSERT_EQUAL(offsetof(TestDeepAnonymous, deep_float), offset);
+
+    m = ti_find_member_at(ti, "after", 5, &offset);
+    ASSERT_NOT_NULL(m);
+    ASSERT_EQUAL(offsetof(TestDeepAnonymous, after), offset);
+    ASSERT_NULL(ti_find_member(ti, "deep", 4));
+}
+
+CTEST(member_lookup, test_find_member_of_named_inline_record) {
+    Type_Info_Member* data = ti_find_member(&typeinfo_TestComplex.base, "data", 4);
+    ASSERT_NOT_NULL(data);
+    ASSERT_NULL(ti_find_member(&typeinfo_TestComplex.base, "position", 8));
+    Type_Info_Member* position = ti_find_member(data->type, "position", 8);
+    ASSERT_NOT_NULL(position);
+    Type_Info_Member* z = ti_find_member(position->type, "z", 1);
+    ASSERT_NOT_NULL(z);
+    ASSERT_EQUAL(offsetof(TestComplex, data.position.z),
+                 data->offset + position->offset + z->offset);
+}
+
+CTEST(member_lookup, test_find_member_without_index) {
+    Type_Info_Struct s = typeinfo_TestDeepAnonymous;
+    size_t offset = 0;
+    s.member_index = (Type_Info_Hash_Index){0};
+    Type_Info_Member* m = ti_find_member_at(&s.base, "deep_int", 8, &offset);
+    ASSERT_NOT_NULL(m);
+    ASSERT_EQUAL(offsetof(TestDeepAnonymous, deep_int), offset);
+    ASSERT_NULL(ti_find_member(&s.base, "missing", 7));
+}
+
+CTEST(member_lookup, test_find_member_not_a_record) {
+    ASSERT_NULL(ti_find_member(&typeinfo_int.base, "x", 1));
+}
+
+// ==============================================================================
+// Type Registry Tests
+// ==============================================================================
+
+CTEST(registry, test_lookup_type) {
+    ASSERT_TRUE(ti_lookup_type("TestIntegers") == &typeinfo_TestIntegers.base);
+    ASSERT_TRUE(ti_lookup_type("TestUnion") == &typeinfo_TestUnion.base);
+    ASSERT_TRUE(ti_lookup_type("Status") == &typeinfo_Status.base);
+    // Not a root, but reachable from one
+    ASSERT_TRUE(ti_lookup_type("Inner") == &typeinfo_Inner.base);
+    ASSERT_NULL(ti_lookup_type("TestInteger"));
+    ASSERT_NULL(ti_lookup_type("int"));
+    ASSERT_NULL(ti_lookup_type(""));
+}
+
+CTEST(registry, test_lookup_type_not_nul_terminated) {
+    const char* name = "PointXYZ";
+    ASSERT_TRUE(ti_registry_lookup(&typeinfo_registry, name, 5) == &typeinfo_Point.base);
+}
+
+CTEST(registry, test_iterate_types) {
+    ASSERT_NOT_NULL(typeinfo_registry.name_index.slots);
+    ASSERT_GE_U(ti_type_count(), 17);
+    for(size_t i = 0; i < ti_type_count(); i++) {
+        Type_Info* ti = ti_type_at(i);
+        ASSERT_TRUE(ti->tag == TYPE_TAG_STRUCT || ti->tag == TYPE_TAG_UNION ||
+                    ti->tag == TYPE_TAG_ENUM);
+        ASSERT_TRUE(ti == ti_lookup_type(typeinfo_registry.entries[i].name));
+    }
+}
+
 // ==============================================================================
 // Nested Type Tests
 // ==============================================================================
@@ -423,6 +674,1664 @@ CTEST(void_types, test_void_pointer) {
     ASSERT_EQUAL(TYPE_TAG_VOID, ptr_type->pointer_to->tag);
 }
 
+// ==============================================================================
+// Serialization Tests
+// ==============================================================================
+
+static TestSerialize make_test_serialize(void) {
+    static int pointee = 42;
+    TestSerialize value;
+    memset(&value, 0xAB, sizeof(value));  // Garbage in the padding
+    value.c = 'c';
+    value.s = -2;
+    for(int i = 0; i < 3; i++) {
+        value.elements[i].tag = (char)('a' + i);
+        value.elements[i].value = i * 100;
+        value.elements[i].ptr = &pointee;
+    }
+    value.d = 3.5;
+    for(int i = 0; i < 2; i++) {
+        for(int j = 0; j < 3; j++) value.grid[i][j] = (short)(i * 3 + j);
+    }
+    value.status = STATUS_PENDING;
+    value.u.i = 0x01020304;
+    value.name = "name";
+    return value;
+}
+
+CTEST(serialization, test_serialized_size) {
+    size_t expected = sizeof(char) + sizeof(short) + 3 * (sizeof(char) + sizeof(int)) +
+                      sizeof(double) + 6 * sizeof(short) + sizeof(Status) + sizeof(TestUnion);
+    ASSERT_EQUAL_U(expected, ti_serialized_size(&typeinfo_TestSerialize.base));
+    ASSERT_EQUAL_U(expected, TI_SERIALIZED_SIZE_TestSerialize);
+    // No padding between the members
+    ASSERT_EQUAL_U(30, TI_SERIALIZED_SIZE_TestIntegers);
+    ASSERT_EQUAL_U(0, TI_SERIALIZED_SIZE_TestPointers);
+}
+
+CTEST(serialization, test_interpreted_roundtrip) {
+    TestSerialize value = make_test_serialize();
+    unsigned char data[TI_SERIALIZED_SIZE_TestSerialize];
+    ASSERT_EQUAL_U(sizeof(data), ti_serialize(type_any(&value, TestSerialize), data));
+
+    TestSerialize out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_EQUAL_U(0, ti_deserialize(type_any(&out, TestSerialize), data, sizeof(data) - 1));
+    ASSERT_EQUAL_U(sizeof(data), ti_deserialize(type_any(&out, TestSerialize), data, sizeof(data)));
+    ASSERT_EQUAL('c', out.c);
+    ASSERT_EQUAL(-2, out.s);
+    ASSERT_EQUAL('c', out.elements[2].tag);
+    ASSERT_EQUAL(200, out.elements[2].value);
+    ASSERT_NULL(out.elements[2].ptr);
+    ASSERT_DBL_NEAR(3.5, out.d);
+    ASSERT_EQUAL(5, out.grid[1][2]);
+    ASSERT_EQUAL(STATUS_PENDING, out.status);
+    ASSERT_EQUAL(0x01020304, out.u.i);
+    ASSERT_NULL(out.name);
+}
+
+CTEST(serialization, test_generated_matches_interpreted) {
+    TestSerialize value = make_test_serialize();
+    unsigned char interpreted[TI_SERIALIZED_SIZE_TestSerialize];
+    unsigned char generated[TI_SERIALIZED_SIZE_TestSerialize];
+    ti_serialize(type_any(&value, TestSerialize), interpreted);
+    ASSERT_EQUAL_U(sizeof(generated), ti_serialize_TestSerialize(&value, generated));
+    ASSERT_DATA(interpreted, sizeof(interpreted), generated, sizeof(generated));
+
+    TestSerialize a, b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    ti_deserialize(type_any(&a, TestSerialize), interpreted, sizeof(interpreted));
+    ASSERT_EQUAL_U(0, ti_deserialize_TestSerialize(&b, generated, sizeof(generated) - 1));
+    ASSERT_EQUAL_U(sizeof(generated), ti_deserialize_TestSerialize(&b, generated, sizeof(generated)));
+    ASSERT_DATA((unsigned char*)&a, sizeof(a), (unsigned char*)&b, sizeof(b));
+}
+
+CTEST(serialization, test_generated_anonymous_members) {
+    TestDeepAnonymous value = {1, {'p', {7}}, 2};
+    unsigned char interpreted[TI_SERIALIZED_SIZE_TestDeepAnonymous];
+    unsigned char generated[TI_SERIALIZED_SIZE_TestDeepAnonymous];
+    ti_serialize(type_any(&value, TestDeepAnonymous), interpreted);
+    ti_serialize_TestDeepAnonymous(&value, generated);
+    ASSERT_DATA(interpreted, sizeof(interpreted), generated, sizeof(generated));
+
+    TestDeepAnonymous out = {0};
+    ti_deserialize_TestDeepAnonymous(&out, generated, sizeof(generated));
+    ASSERT_EQUAL(1, out.before);
+    ASSERT_EQUAL('p', out.pad);
+    ASSERT_EQUAL(7, out.deep_int);
+    ASSERT_EQUAL(2, out.after);
+}
+
+CTEST(serialization, test_plan_merges_contiguous_members) {
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_Point.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL_U(1, plan->ops_count);
+    ASSERT_EQUAL(TYPE_INFO_PLAN_COPY, plan->ops[0].kind);
+    ASSERT_EQUAL_U(sizeof(Point), plan->ops[0].size);
+
+    // Padding after u16 splits the copy in two
+    plan = ti_plan_get(&typeinfo_TestIntegers.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL_U(2, plan->ops_count);
+    ASSERT_EQUAL_U(offsetof(TestIntegers, i32), plan->ops[1].value_offset);
+    ASSERT_EQUAL_U(6, plan->ops[1].data_offset);
+}
+
+CTEST(serialization, test_plan_is_cached) {
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestSerialize.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_TRUE(plan == typeinfo_TestSerialize.plan);
+    ASSERT_TRUE(plan == ti_plan_get(&typeinfo_TestSerialize.base));
+    ASSERT_EQUAL_U(TI_SERIALIZED_SIZE_TestSerialize, plan->data_size);
+    ASSERT_EQUAL_U(sizeof(TestSerialize), plan->value_size);
+    ASSERT_NULL(ti_plan_get(&typeinfo_int.base));
+}
+
+CTEST(serialization, test_plan_loop) {
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestSerialize.base);
+    ASSERT_NOT_NULL(plan);
+    // c, s, elements (loop over tag, value and ptr), d..u merged, name
+    ASSERT_EQUAL_U(8, plan->ops_count);
+    const Type_Info_Plan_Op* loop = &plan->ops[2];
+    ASSERT_EQUAL(TYPE_INFO_PLAN_LOOP, loop->kind);
+    ASSERT_EQUAL_U(3, loop->count);
+    ASSERT_EQUAL_U(3, loop->body_count);
+    ASSERT_EQUAL_U(sizeof(TestSerializeElement), loop->stride);
+    ASSERT_EQUAL(TYPE_INFO_PLAN_ZERO, plan->ops[5].kind);
+    ASSERT_EQUAL(TYPE_INFO_PLAN_COPY, plan->ops[6].kind);
+    ASSERT_EQUAL_U(offsetof(TestSerialize, d), plan->ops[6].value_offset);
+}
+
+CTEST(serialization, test_plan_array_of_records) {
+    TestSerialize values[2] = {make_test_serialize(), make_test_serialize()};
+    values[1].c = 'C';
+    unsigned char expected[2 * TI_SERIALIZED_SIZE_TestSerialize];
+    ti_serialize_TestSerialize(&values[0], expected);
+    ti_serialize_TestSerialize(&values[1], expected + TI_SERIALIZED_SIZE_TestSerialize);
+
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestSerialize.base);
+    unsigned char data[sizeof(expected)];
+    ASSERT_EQUAL_U(sizeof(data), ti_plan_serialize(plan, values, 2, data));
+    ASSERT_DATA(expected, sizeof(expected), data, sizeof(data));
+
+    TestSerialize out[2];
+    ASSERT_EQUAL_U(0, ti_plan_deserialize(plan, out, 2, data, sizeof(data) - 1));
+    ASSERT_EQUAL_U(sizeof(data), ti_plan_deserialize(plan, out, 2, data, sizeof(data)));
+    ASSERT_EQUAL('c', out[0].c);
+    ASSERT_EQUAL('C', out[1].c);
+    ASSERT_EQUAL(100, out[1].elements[1].value);
+    ASSERT_NULL(out[1].elements[1].ptr);
+}
+
+CTEST(serialization, test_plan_compile_array) {
+    // Plans can be compiled for any type, e.g. arrays
+    Type_Info_Member* grid = find_member(&typeinfo_TestSerialize, "grid");
+    ASSERT_NOT_NULL(grid);
+    Type_Info_Plan* plan = ti_plan_compile(grid->type);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL_U(1, plan->ops_count);
+    ASSERT_EQUAL_U(6 * sizeof(short), plan->data_size);
+    ti_plan_free(plan);
+}
+
+// ==============================================================================
+// JSON Tests
+// ==============================================================================
+
+#define ASSERT_JSON(expected, value, T)                                  \
+    do {                                                                 \
+        Type_Info_Buffer buf_ = {0};                                     \
+        ASSERT_TRUE(ti_json_encode(type_any(&(value), T), &buf_));       \
+        ASSERT_STR(expected, buf_.data);                                 \
+        ASSERT_EQUAL_U(strlen(expected), buf_.size);                     \
+        ti_buffer_free(&buf_);                                           \
+    } while(0)
+
+CTEST(json_encode, test_struct) {
+    Point p = {1, -2};
+    ASSERT_JSON("{\"x\":1,\"y\":-2}", p, Point);
+}
+
+CTEST(json_encode, test_integers) {
+    TestIntegers v = {INT8_MIN, UINT8_MAX, INT16_MIN, UINT16_MAX,
+                      INT32_MIN, UINT32_MAX, INT64_MIN, UINT64_MAX};
+    ASSERT_JSON("{\"i8\":-128,\"u8\":255,\"i16\":-32768,\"u16\":65535,\"i32\":-2147483648,"
+                "\"u32\":4294967295,\"i64\":-9223372036854775808,\"u64\":18446744073709551615}",
+                v, TestIntegers);
+}
+
+CTEST(json_encode, test_floats) {
+    TestFloats v = {0.1f, 3.5};
+    ASSERT_JSON("{\"f\":0.1,\"d\":3.5}", v, TestFloats);
+    v = (TestFloats){-100.0f, 1e30};
+    ASSERT_JSON("{\"f\":-100.0,\"d\":1e30}", v, TestFloats);
+    v = (TestFloats){1.5e-7f, 0.001234};
+    ASSERT_JSON("{\"f\":1.5e-7,\"d\":0.001234}", v, TestFloats);
+    v = (TestFloats){0.0f, 123456789.125};
+    ASSERT_JSON("{\"f\":0.0,\"d\":123456789.125}", v, TestFloats);
+    v = (TestFloats){3.4028235e38f, 2.2250738585072014e-308};
+    ASSERT_JSON("{\"f\":3.4028235e38,\"d\":2.2250738585072014e-308}", v, TestFloats);
+}
+
+CTEST(json_encode, test_float_roundtrip) {
+    double values[] = {0.1, 1.0 / 3.0, 5e-324, 1.7976931348623157e308, 123.456, 9007199254740993.0};
+    for(size_t i = 0; i < sizeof(values) / sizeof(*values); i++) {
+        Type_Info_Buffer buf = {0};
+        ASSERT_TRUE(ti_json_encode((Type_Any){&values[i], &typeinfo_double.base}, &buf));
+        ASSERT_TRUE(strtod(buf.data, NULL) == values[i]);
+        ti_buffer_free(&buf);
+    }
+}
+
+CTEST(json_encode, test_enum_by_name) {
+    Status status = STATUS_ERROR;
+    ASSERT_JSON("\"STATUS_ERROR\"", status, Status);
+    TestSparseEnum sparse = SPARSE_ALIAS;
+    ASSERT_JSON("\"SPARSE_ONE\"", sparse, TestSparseEnum);
+    status = (Status)42;
+    ASSERT_JSON("42", status, Status);
+}
+
+CTEST(json_encode, test_cstr_escaping) {
+    TestArrays v = {0};
+    strcpy(v.str, "quote \" backslash \\ newline \n tab \t bell \a long clean run ok");
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&v, TestArrays), &buf));
+    ASSERT_STRSTR(buf.data, "\"str\":\"quote \\\" backslash \\\\ newline \\n tab \\t bell \\u0007 "
+                            "long clean run ok\"");
+    ti_buffer_free(&buf);
+}
+
+CTEST(json_encode, test_anonymous_members_are_flattened) {
+    TestAnonymous v = {{1, 2}, {3}};
+    ASSERT_JSON("{\"anon_x\":1,\"anon_y\":2,\"as_int\":3,\"as_float\":4e-45}", v, TestAnonymous);
+}
+
+CTEST(json_encode, test_pointers) {
+    TestStructs v = {{1, 2}, NULL};
+    ASSERT_JSON("{\"point\":{\"x\":1,\"y\":2},\"point_ptr\":null}", v, TestStructs);
+    Point p = {3, 4};
+    v.point_ptr = &p;
+    ASSERT_JSON("{\"point\":{\"x\":1,\"y\":2},\"point_ptr\":{\"x\":3,\"y\":4}}", v, TestStructs);
+    TestVoidPtr vp = {&p};
+    ASSERT_JSON("{\"void_ptr\":null}", vp, TestVoidPtr);
+}
+
+CTEST(json_encode, test_appends) {
+    Point p = {1, 2};
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&p, Point), &buf));
+    ASSERT_TRUE(ti_json_encode(type_any(&p, Point), &buf));
+    ASSERT_STR("{\"x\":1,\"y\":2}{\"x\":1,\"y\":2}", buf.data);
+    ti_buffer_free(&buf);
+    ASSERT_NULL(buf.data);
+}
+
+#define JSON_DECODE(json, value, T) ti_json_decode(json, strlen(json), type_any(&(value), T))
+
+CTEST(json_decode, test_struct) {
+    Point p = {0};
+    ASSERT_TRUE(JSON_DECODE(" { \"y\" : -2 , \"x\":1 } ", p, Point));
+    ASSERT_EQUAL(1, p.x);
+    ASSERT_EQUAL(-2, p.y);
+}
+
+CTEST(json_decode, test_integers) {
+    TestIntegers v = {0};
+    ASSERT_TRUE(JSON_DECODE("{\"i8\":-128,\"u8\":255,\"i16\":-32768,\"u16\":65535,"
+                            "\"i32\":-2147483648,\"u32\":4294967295,"
+                            "\"i64\":-9223372036854775808,\"u64\":18446744073709551615}",
+                            v, TestIntegers));
+    ASSERT_EQUAL(INT8_MIN, v.i8);
+    ASSERT_EQUAL_U(UINT8_MAX, v.u8);
+    ASSERT_EQUAL(INT16_MIN, v.i16);
+    ASSERT_EQUAL_U(UINT16_MAX, v.u16);
+    ASSERT_EQUAL(INT32_MIN, v.i32);
+    ASSERT_EQUAL_U(UINT32_MAX, v.u32);
+    ASSERT_TRUE(v.i64 == INT64_MIN);
+    ASSERT_TRUE(v.u64 == UINT64_MAX);
+}
+
+CTEST(json_decode, test_integer_range) {
+    TestIntegers v = {0};
+    ASSERT_FALSE(JSON_DECODE("{\"i8\":128}", v, TestIntegers));
+    ASSERT_FALSE(JSON_DECODE("{\"i8\":-129}", v, TestIntegers));
+    ASSERT_FALSE(JSON_DECODE("{\"u8\":256}", v, TestIntegers));
+    ASSERT_FALSE(JSON_DECODE("{\"u16\":-1}", v, TestIntegers));
+    ASSERT_FALSE(JSON_DECODE("{\"u64\":18446744073709551616}", v, TestIntegers));
+    ASSERT_FALSE(JSON_DECODE("{\"i32\":1.5}", v, TestIntegers));
+    ASSERT_TRUE(JSON_DECODE("{\"u8\":true,\"i8\":-0}", v, TestIntegers));
+    ASSERT_EQUAL_U(1, v.u8);
+    ASSERT_EQUAL(0, v.i8);
+}
+
+CTEST(json_decode, test_floats) {
+    TestFloats v = {0};
+    ASSERT_TRUE(JSON_DECODE("{\"f\":0.1,\"d\":-1.25e-3}", v, TestFloats));
+    ASSERT_TRUE(v.f == 0.1f);
+    ASSERT_TRUE(v.d == -1.25e-3);
+    ASSERT_TRUE(JSON_DECODE("{\"f\":3,\"d\":2.2250738585072014e-308}", v, TestFloats));
+    ASSERT_TRUE(v.f == 3.0f);
+    ASSERT_TRUE(v.d == 2.2250738585072014e-308);
+    ASSERT_FALSE(JSON_DECODE("{\"d\":1.}", v, TestFloats));
+    ASSERT_FALSE(JSON_DECODE("{\"d\":.5}", v, TestFloats));
+}
+
+CTEST(json_decode, test_enums) {
+    Status status = STATUS_OK;
+    ASSERT_TRUE(JSON_DECODE("\"STATUS_ERROR\"", status, Status));
+    ASSERT_EQUAL(STATUS_ERROR, status);
+    ASSERT_TRUE(JSON_DECODE("42", status, Status));
+    ASSERT_EQUAL(42, (int)status);
+    ASSERT_FALSE(JSON_DECODE("\"STATUS_UNKNOWN\"", status, Status));
+    TestSparseEnum sparse = SPARSE_ONE;
+    ASSERT_TRUE(JSON_DECODE("\"SPARSE_NEGATIVE\"", sparse, TestSparseEnum));
+    ASSERT_EQUAL(SPARSE_NEGATIVE, sparse);
+}
+
+CTEST(json_decode, test_arrays_in_place) {
+    TestArrays v;
+    memset(&v, 0x7f, sizeof(v));
+    ASSERT_TRUE(JSON_DECODE("{\"arr\":[1,2,3],\"str\":\"hi \\\"there\\\" \\u00e9\\ud83d\\ude00\","
+                            "\"matrix\":[[1,2,3,4],[5]]}",
+                            v, TestArrays));
+    ASSERT_EQUAL(1, v.arr[0]);
+    ASSERT_EQUAL(3, v.arr[2]);
+    ASSERT_EQUAL(0x7f7f7f7f, v.arr[3]);  // Past the end of the JSON array, untouched
+    ASSERT_STR("hi \"there\" \xc3\xa9\xf0\x9f\x98\x80", v.str);
+    ASSERT_TRUE(v.matrix[0][3] == 4.0f);
+    ASSERT_TRUE(v.matrix[1][0] == 5.0f);
+    ASSERT_FALSE(JSON_DECODE("{\"arr\":[0,1,2,3,4,5,6,7,8,9,10]}", v, TestArrays));
+}
+
+CTEST(json_decode, test_cstr_must_fit) {
+    TestComplex v = {0};
+    char json[128] = "{\"data\":{\"name\":\"";
+    size_t len = strlen(json);
+    memset(json + len, 'a', 63);
+    strcpy(json + len + 63, "\"}}");
+    ASSERT_TRUE(JSON_DECODE(json, v, TestComplex));
+    ASSERT_EQUAL_U(63, strlen(v.data.name));
+    memset(json + len, 'a', 64);
+    strcpy(json + len + 64, "\"}}");
+    ASSERT_FALSE(JSON_DECODE(json, v, TestComplex));
+}
+
+CTEST(json_decode, test_anonymous_members_and_unknown_keys) {
+    TestDeepAnonymous v = {0};
+    ASSERT_TRUE(JSON_DECODE("{\"unknown\":{\"a\":[1,{\"b\":null}],\"c\":\"}\"},\"before\":1,"
+                            "\"deep_int\":7,\"after\":2,\"extra\":false}",
+                            v, TestDeepAnonymous));
+    ASSERT_EQUAL(1, v.before);
+    ASSERT_EQUAL(7, v.deep_int);
+    ASSERT_EQUAL(2, v.after);
+}
+
+CTEST(json_decode, test_pointers) {
+    Point p = {0};
+    TestStructs v = {{0}, &p};
+    ASSERT_TRUE(JSON_DECODE("{\"point_ptr\":{\"x\":3,\"y\":4}}", v, TestStructs));
+    ASSERT_EQUAL(3, p.x);
+    ASSERT_EQUAL(4, p.y);
+    ASSERT_TRUE(JSON_DECODE("{\"point_ptr\":null}", v, TestStructs));
+    ASSERT_NULL(v.point_ptr);
+    ASSERT_FALSE(JSON_DECODE("{\"point_ptr\":{\"x\":3}}", v, TestStructs));
+}
+
+CTEST(json_decode, test_malformed) {
+    Point p = {0};
+    ASSERT_FALSE(JSON_DECODE("", p, Point));
+    ASSERT_FALSE(JSON_DECODE("{\"x\":1", p, Point));
+    ASSERT_FALSE(JSON_DECODE("{\"x\":1,}", p, Point));
+    ASSERT_FALSE(JSON_DECODE("{\"x\" 1}", p, Point));
+    ASSERT_FALSE(JSON_DECODE("{\"x\":1} x", p, Point));
+    ASSERT_FALSE(JSON_DECODE("[1]", p, Point));
+    ASSERT_FALSE(JSON_DECODE("{\"z\":tru}", p, Point));
+    ASSERT_FALSE(ti_json_decode("{\"x\":1}", 6, type_any(&p, Point)));
+
+    char deep[2 * TI_JSON_MAX_NESTING + 16] = "{\"z\":";
+    size_t len = strlen(deep);
+    for(int i = 0; i < TI_JSON_MAX_NESTING; i++) deep[len++] = '[';
+    for(int i = 0; i < TI_JSON_MAX_NESTING; i++) deep[len++] = ']';
+    strcpy(deep + len, "}");
+    ASSERT_FALSE(JSON_DECODE(deep, p, Point));
+}
+
+CTEST(json_decode, test_roundtrip) {
+    TestSerialize v = make_test_serialize();
+    v.elements[0].ptr = NULL;
+    v.elements[1].ptr = NULL;
+    v.elements[2].ptr = NULL;
+    v.name = NULL;
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&v, TestSerialize), &buf));
+
+    TestSerialize out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_TRUE(ti_json_decode(buf.data, buf.size, type_any(&out, TestSerialize)));
+    ASSERT_EQUAL(v.c, out.c);
+    ASSERT_EQUAL(v.s, out.s);
+    ASSERT_EQUAL(v.elements[2].tag, out.elements[2].tag);
+    ASSERT_EQUAL(v.elements[2].value, out.elements[2].value);
+    ASSERT_TRUE(v.d == out.d);
+    ASSERT_DATA((const unsigned char*)v.grid, sizeof(v.grid), (const unsigned char*)out.grid,
+                sizeof(out.grid));
+    ASSERT_EQUAL(v.status, out.status);
+    ASSERT_EQUAL(v.u.i, out.u.i);
+    ti_buffer_free(&buf);
+}
+
+// ==============================================================================
+// Type Trait Tests
+// ==============================================================================
+
+CTEST(traits, test_trait_flags) {
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE | TYPE_INFO_TRAIT_IS_POD,
+                   typeinfo_Point.base.traits);
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_PADDING | TYPE_INFO_TRAIT_IS_POD,
+                   typeinfo_TestIntegers.base.traits);
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_HAS_PADDING | TYPE_INFO_TRAIT_IS_POD,
+                   typeinfo_TestFloats.base.traits);
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_POINTERS, typeinfo_TestStructs.base.traits);
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_POINTERS | TYPE_INFO_TRAIT_HAS_PADDING |
+                       TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_HAS_UNIONS,
+                   typeinfo_TestSerialize.base.traits);
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_FLOATS | TYPE_INFO_TRAIT_IS_POD | TYPE_INFO_TRAIT_HAS_UNIONS,
+                   typeinfo_TestUnion.base.traits);
+}
+
+CTEST(traits, test_const_and_flexible_array) {
+    ASSERT_TRUE(typeinfo_TestMemberQualifiers.base.traits & TYPE_INFO_TRAIT_HAS_CONST);
+    ASSERT_FALSE(typeinfo_TestIntegers.base.traits & TYPE_INFO_TRAIT_HAS_CONST);
+    ASSERT_TRUE(typeinfo_TestPointers.base.traits & TYPE_INFO_TRAIT_HAS_CONST);  // ptr_const
+    // Only the pointee of `name` is const
+    ASSERT_FALSE(typeinfo_TestSerialize.base.traits & TYPE_INFO_TRAIT_HAS_CONST);
+
+    ASSERT_EQUAL_U(TYPE_INFO_TRAIT_HAS_FLEXIBLE_ARRAY | TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE,
+                   typeinfo_TestFlexible.base.traits);
+}
+
+CTEST(traits, test_data_ranges) {
+    const Type_Info_Struct* s = &typeinfo_TestIntegers;
+    ASSERT_EQUAL_U(2, s->data_ranges_count);
+    ASSERT_EQUAL_U(0, s->data_ranges[0].offset);
+    ASSERT_EQUAL_U(offsetof(TestIntegers, i32) - 2, s->data_ranges[0].size);
+    ASSERT_EQUAL_U(offsetof(TestIntegers, i32), s->data_ranges[1].offset);
+    ASSERT_EQUAL_U(sizeof(TestIntegers) - offsetof(TestIntegers, i32), s->data_ranges[1].size);
+
+    // Nested anonymous struct and union are flattened
+    s = &typeinfo_TestDeepAnonymous;
+    ASSERT_EQUAL_U(2, s->data_ranges_count);
+    ASSERT_EQUAL_U(0, s->data_ranges[0].offset);
+    ASSERT_EQUAL_U(offsetof(TestDeepAnonymous, pad) + 1, s->data_ranges[0].size);
+    ASSERT_EQUAL_U(offsetof(TestDeepAnonymous, deep_int), s->data_ranges[1].offset);
+    ASSERT_EQUAL_U(sizeof(TestDeepAnonymous) - offsetof(TestDeepAnonymous, deep_int),
+                   s->data_ranges[1].size);
+
+    ASSERT_EQUAL_U(1, typeinfo_TestArrays.data_ranges_count);
+    ASSERT_EQUAL_U(sizeof(TestArrays), typeinfo_TestArrays.data_ranges[0].size);
+    ASSERT_EQUAL_U(1, typeinfo_TestUnion.data_ranges_count);
+    ASSERT_EQUAL_U(sizeof(TestUnion), typeinfo_TestUnion.data_ranges[0].size);
+    ASSERT_EQUAL_U(1, typeinfo_TestFlexible.data_ranges_count);
+    ASSERT_EQUAL_U(sizeof(int), typeinfo_TestFlexible.data_ranges[0].size);
+}
+
+CTEST(traits, test_pointer_maps) {
+    ASSERT_EQUAL_U(1, typeinfo_TestStructs.pointers_count);
+    ASSERT_EQUAL_U(offsetof(TestStructs, point_ptr), typeinfo_TestStructs.pointers[0].offset);
+    ASSERT_TRUE(typeinfo_TestStructs.pointers[0].pointee == &typeinfo_Point.base);
+
+    // Pointers of array elements are flattened, the union is skipped
+    const Type_Info_Struct* s = &typeinfo_TestSerialize;
+    ASSERT_EQUAL_U(4, s->pointers_count);
+    for(size_t i = 0; i < 3; i++) {
+        ASSERT_EQUAL_U(offsetof(TestSerialize, elements) + i * sizeof(TestSerializeElement) +
+                           offsetof(TestSerializeElement, ptr),
+                       s->pointers[i].offset);
+        ASSERT_FALSE(s->pointers[i].is_cstr);
+        ASSERT_TRUE(s->pointers[i].pointee == &typeinfo_int.base);
+    }
+    ASSERT_EQUAL_U(offsetof(TestSerialize, name), s->pointers[3].offset);
+    ASSERT_TRUE(s->pointers[3].is_cstr);
+    ASSERT_TRUE(s->pointers[3].pointee == &typeinfo_char.base);
+
+    ASSERT_EQUAL_U(5, typeinfo_TestPointers.pointers_count);
+    ASSERT_TRUE(typeinfo_TestVoidPtr.pointers[0].pointee == &typeinfo_void.base);
+    ASSERT_EQUAL_U(0, typeinfo_TestComplex.pointers_count);
+    ASSERT_NULL(typeinfo_TestComplex.pointers);
+
+    // Function pointers have no pointee to follow
+    ASSERT_EQUAL_U(0, typeinfo_TestCallbacks.pointers_count);
+    ASSERT_NULL(((Type_Info_Pointer*)find_member(&typeinfo_TestCallbacks, "callback")->type)
+                    ->pointer_to);
+}
+
+// See test_variant.c
+extern const uint64_t variant_fingerprints[];
+
+CTEST(traits, test_fingerprints_ignore_location) {
+    // Unnamed members are spelled with the path of the header by clang, which was generated again
+    // from another directory
+    ASSERT_TRUE(variant_fingerprints[0] == TI_FINGERPRINT_TestAnonymous);
+    ASSERT_TRUE(variant_fingerprints[1] == TI_FINGERPRINT_TestNested);
+    ASSERT_TRUE(variant_fingerprints[2] == TI_FINGERPRINT_TestComplex);
+    ASSERT_TRUE(variant_fingerprints[3] == TI_FINGERPRINT_TestDeepAnonymous);
+}
+
+CTEST(traits, test_fingerprints_include_pointees) {
+    // `TestHolder` is unchanged in the variant, but what it points to grew
+    ASSERT_TRUE(variant_fingerprints[4] != TI_FINGERPRINT_TestHolder);
+
+    TestPayload payload = {7};
+    TestHolder holder = {1, &payload};
+    const char* path = "test_snapshot_pointee.bin";
+    ASSERT_TRUE(ti_snapshot_write(type_any(&holder, TestHolder), path));
+    TestHolder* mapped = ti_snapshot_map(path, &typeinfo_TestHolder.base);
+    ASSERT_NOT_NULL(mapped);
+    ASSERT_EQUAL(7, ((TestPayload*)ti_snapshot_ptr(&mapped->payload))->value);
+    ti_snapshot_unmap(mapped);
+
+    // As a program built with the variant would expect it
+    Type_Info_Struct variant = typeinfo_TestHolder;
+    variant.fingerprint = variant_fingerprints[4];
+    ASSERT_NULL(ti_snapshot_map(path, &variant.base));
+    remove(path);
+}
+
+CTEST(traits, test_fingerprints) {
+    ASSERT_TRUE(typeinfo_Point.fingerprint == TI_FINGERPRINT_Point);
+    ASSERT_TRUE(typeinfo_Point.fingerprint != 0);
+    // Only the layout counts, not type names nor annotations
+    ASSERT_TRUE(typeinfo_Point.fingerprint == typeinfo_TestPointCopy.fingerprint);
+    ASSERT_TRUE(typeinfo_Point.fingerprint != typeinfo_Inner.fingerprint);
+    ASSERT_TRUE(typeinfo_TestAnonymous.fingerprint != typeinfo_TestDeepAnonymous.fingerprint);
+    ASSERT_TRUE(typeinfo_TestSparseEnum.fingerprint == TI_FINGERPRINT_TestSparseEnum);
+    ASSERT_TRUE(typeinfo_TestSparseEnum.fingerprint != typeinfo_TestDenseEnum.fingerprint);
+
+    // Snapshots are accepted by types with the same layout
+    Point point = {3, 4};
+    const char* path = "test_snapshot_fingerprint.bin";
+    ASSERT_TRUE(ti_snapshot_write(type_any(&point, Point), path));
+    TestPointCopy* copy = ti_snapshot_map(path, &typeinfo_TestPointCopy.base);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_EQUAL(4, copy->y);
+    ti_snapshot_unmap(copy);
+    ASSERT_NULL(ti_snapshot_map(path, &typeinfo_Inner.base));
+    remove(path);
+}
+
+CTEST(traits, test_plain_data_is_copied_whole) {
+    // No padding nor pointers: the binary format is the bytes of the value
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestComplex.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL_U(1, plan->ops_count);
+    ASSERT_EQUAL_U(sizeof(TestComplex), ti_serialized_size(&typeinfo_TestComplex.base));
+
+    TestComplex value = {7, {"name", {1, 2, 3}}, TYPE_C};
+    unsigned char data[sizeof(TestComplex)];
+    ASSERT_EQUAL_U(sizeof(data), ti_serialize(type_any(&value, TestComplex), data));
+    ASSERT_DATA((const unsigned char*)&value, sizeof(value), data, sizeof(data));
+
+    // With a flexible array member it's no longer plain data
+    ASSERT_EQUAL_U(sizeof(int), ti_serialized_size(&typeinfo_TestFlexible.base));
+}
+
+// ==============================================================================
+// Equality, Hashing and Ordering Tests
+// ==============================================================================
+
+CTEST(equality, test_trivially_comparable) {
+    Point a = {1, 2}, b = {1, 2}, c = {1, 3};
+    ASSERT_TRUE(ti_equal(type_any(&a, Point), type_any(&b, Point)));
+    ASSERT_FALSE(ti_equal(type_any(&a, Point), type_any(&c, Point)));
+    ASSERT_TRUE(ti_hash(type_any(&a, Point)) == ti_hash(type_any(&b, Point)));
+    ASSERT_TRUE(ti_hash(type_any(&a, Point)) != ti_hash(type_any(&c, Point)));
+    ASSERT_FALSE(ti_equal(type_any(&a, Point), type_any(&a, TestNested)));
+}
+
+CTEST(equality, test_ignores_padding_and_follows_pointers) {
+    TestSerialize a = make_test_serialize();
+    TestSerialize b;
+    memset(&b, 0, sizeof(b));  // Different padding
+    int pointee = 42;
+    char name[] = "name";
+    b.c = a.c;
+    b.s = a.s;
+    for(int i = 0; i < 3; i++) {
+        b.elements[i].tag = a.elements[i].tag;
+        b.elements[i].value = a.elements[i].value;
+        b.elements[i].ptr = &pointee;  // Different pointer, equal pointee
+    }
+    b.d = a.d;
+    memcpy(b.grid, a.grid, sizeof(a.grid));
+    b.status = a.status;
+    b.u = a.u;
+    b.name = name;  // CStr, compared as a string
+
+    ASSERT_TRUE(ti_equal(type_any(&a, TestSerialize), type_any(&b, TestSerialize)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestSerialize)) == ti_hash(type_any(&b, TestSerialize)));
+    ASSERT_EQUAL(0, ti_compare(type_any(&a, TestSerialize), type_any(&b, TestSerialize)));
+
+    pointee = 43;
+    ASSERT_FALSE(ti_equal(type_any(&a, TestSerialize), type_any(&b, TestSerialize)));
+    ASSERT_TRUE(ti_compare(type_any(&a, TestSerialize), type_any(&b, TestSerialize)) < 0);
+    pointee = 42;
+    b.elements[1].ptr = NULL;
+    ASSERT_FALSE(ti_equal(type_any(&a, TestSerialize), type_any(&b, TestSerialize)));
+    ASSERT_TRUE(ti_compare(type_any(&a, TestSerialize), type_any(&b, TestSerialize)) > 0);
+}
+
+CTEST(equality, test_padding_bytes_are_masked) {
+    TestIntegers a, b;
+    memset(&a, 0xAA, sizeof(a));
+    memset(&b, 0x55, sizeof(b));
+    a.i8 = b.i8 = -1;
+    a.u8 = b.u8 = 2;
+    a.i16 = b.i16 = -3;
+    a.u16 = b.u16 = 4;
+    a.i32 = b.i32 = -5;
+    a.u32 = b.u32 = 6;
+    a.i64 = b.i64 = -7;
+    a.u64 = b.u64 = 8;
+    ASSERT_TRUE(ti_equal(type_any(&a, TestIntegers), type_any(&b, TestIntegers)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestIntegers)) == ti_hash(type_any(&b, TestIntegers)));
+    ASSERT_EQUAL(0, ti_compare(type_any(&a, TestIntegers), type_any(&b, TestIntegers)));
+    b.u64 = 9;
+    ASSERT_FALSE(ti_equal(type_any(&a, TestIntegers), type_any(&b, TestIntegers)));
+    ASSERT_TRUE(ti_compare(type_any(&a, TestIntegers), type_any(&b, TestIntegers)) < 0);
+
+    TestDeepAnonymous c, d;
+    memset(&c, 0xAA, sizeof(c));
+    memset(&d, 0x55, sizeof(d));
+    c.before = d.before = 1;
+    c.pad = d.pad = 'p';
+    c.deep_int = d.deep_int = 2;
+    c.after = d.after = 3;
+    ASSERT_TRUE(ti_equal(type_any(&c, TestDeepAnonymous), type_any(&d, TestDeepAnonymous)));
+    ASSERT_TRUE(ti_hash(type_any(&c, TestDeepAnonymous)) ==
+                ti_hash(type_any(&d, TestDeepAnonymous)));
+    d.deep_int = 1;
+    ASSERT_TRUE(ti_compare(type_any(&c, TestDeepAnonymous), type_any(&d, TestDeepAnonymous)) > 0);
+}
+
+CTEST(equality, test_hand_built_struct) {
+    // No traits nor data ranges: compared member by member
+    typedef struct {
+        int a;
+        char b;
+    } Hand_Built;
+    Type_Info_Member members[] = {
+        {.name = "a", .offset = offsetof(Hand_Built, a), .type = &typeinfo_int.base},
+        {.name = "b", .offset = offsetof(Hand_Built, b), .type = &typeinfo_char.base},
+    };
+    Type_Info_Struct type = {
+        .base = {TYPE_TAG_STRUCT, sizeof(Hand_Built), TYPEINFO_ALIGNOF(Hand_Built),
+                 TYPE_INFO_TRAIT_NONE},
+        .name = "Hand_Built",
+        .members = members,
+        .members_count = 2,
+    };
+    Hand_Built a, b;
+    memset(&a, 0xAA, sizeof(a));
+    memset(&b, 0x55, sizeof(b));
+    a.a = b.a = 1;
+    a.b = b.b = 'x';
+    Type_Any va = {&a, &type.base}, vb = {&b, &type.base};
+    ASSERT_TRUE(ti_equal(va, vb));
+    ASSERT_TRUE(ti_hash(va) == ti_hash(vb));
+    ASSERT_EQUAL(0, ti_compare(va, vb));
+    b.a = 2;
+    ASSERT_FALSE(ti_equal(va, vb));
+    ASSERT_TRUE(ti_hash(va) != ti_hash(vb));
+    ASSERT_TRUE(ti_compare(va, vb) < 0);
+}
+
+CTEST(equality, test_hand_built_cstr) {
+    // Annotated by name only, without an annotation set
+    typedef struct {
+        char* name;
+    } Hand_Built;
+    Type_Info_Pointer char_pointer = {
+        {TYPE_TAG_POINTER, sizeof(char*), TYPEINFO_ALIGNOF(char*), TYPE_INFO_TRAIT_HAS_POINTERS},
+        &typeinfo_char.base,
+        TYPE_INFO_QUALIFIER_NONE,
+    };
+    Type_Info_Member members[] = {
+        {.annotations = (char*[]){"CStr", NULL}, .name = "name", .type = &char_pointer.base},
+    };
+    Type_Info_Struct type = {
+        .base = {TYPE_TAG_STRUCT, sizeof(Hand_Built), TYPEINFO_ALIGNOF(Hand_Built),
+                 TYPE_INFO_TRAIT_HAS_POINTERS},
+        .name = "Hand_Built",
+        .members = members,
+        .members_count = 1,
+    };
+    char first[] = "name", second[] = "name";
+    Hand_Built a = {first}, b = {second};
+    Type_Any va = {&a, &type.base}, vb = {&b, &type.base};
+    ASSERT_TRUE(ti_equal(va, vb));  // Compared as strings, not only the first character
+    ASSERT_TRUE(ti_hash(va) == ti_hash(vb));
+    second[3] = 'a';
+    ASSERT_FALSE(ti_equal(va, vb));
+    ASSERT_TRUE(ti_compare(va, vb) > 0);
+}
+
+CTEST(equality, test_floats) {
+    TestFloats a = {0.0f, -0.0}, b = {-0.0f, 0.0};
+    ASSERT_TRUE(ti_equal(type_any(&a, TestFloats), type_any(&b, TestFloats)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestFloats)) == ti_hash(type_any(&b, TestFloats)));
+    a.d = b.d = strtod("nan", NULL);
+    ASSERT_TRUE(ti_equal(type_any(&a, TestFloats), type_any(&b, TestFloats)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestFloats)) == ti_hash(type_any(&b, TestFloats)));
+    b.d = 1e300;
+    ASSERT_TRUE(ti_compare(type_any(&a, TestFloats), type_any(&b, TestFloats)) > 0);
+}
+
+CTEST(ordering, test_numeric_order) {
+    TestIntegers a = {0}, b = {0};
+    a.i32 = -1;
+    b.i32 = 1;
+    ASSERT_TRUE(ti_compare(type_any(&a, TestIntegers), type_any(&b, TestIntegers)) < 0);
+    ASSERT_TRUE(ti_compare(type_any(&b, TestIntegers), type_any(&a, TestIntegers)) > 0);
+    b.u16 = 256;  // Earlier member decides, regardless of byte order
+    a.u16 = 255;
+    ASSERT_TRUE(ti_compare(type_any(&a, TestIntegers), type_any(&b, TestIntegers)) < 0);
+    a.u8 = 1;
+    ASSERT_TRUE(ti_compare(type_any(&a, TestIntegers), type_any(&b, TestIntegers)) > 0);
+    ASSERT_EQUAL(0, ti_compare(type_any(&a, TestIntegers), type_any(&a, TestIntegers)));
+
+    // Trivially comparable: only the first differing member is compared
+    Point p1 = {-1, 5}, p2 = {1, 0};
+    ASSERT_TRUE(ti_compare(type_any(&p1, Point), type_any(&p2, Point)) < 0);
+    p1 = (Point){0xFF, 0};
+    p2 = (Point){0x100, 0};
+    ASSERT_TRUE(ti_compare(type_any(&p1, Point), type_any(&p2, Point)) < 0);
+    p1 = (Point){7, 0x100};
+    p2 = (Point){7, 0xFF};
+    ASSERT_TRUE(ti_compare(type_any(&p1, Point), type_any(&p2, Point)) > 0);
+
+    Status s1 = STATUS_OK, s2 = STATUS_ERROR;
+    ASSERT_TRUE(ti_compare(type_any(&s1, Status), type_any(&s2, Status)) < 0);
+}
+
+// ==============================================================================
+// Deep Copy Tests
+// ==============================================================================
+
+typedef struct {
+    Ext_Allocator base;
+    size_t allocations;
+    size_t bytes;
+} Counting_Allocator;
+
+static void* counting_alloc(Ext_Allocator* a, size_t size) {
+    Counting_Allocator* c = (Counting_Allocator*)a;
+    c->allocations++;
+    c->bytes += size;
+    return malloc(size);
+}
+
+static void* counting_realloc(Ext_Allocator* a, void* ptr, size_t old_size, size_t new_size) {
+    Counting_Allocator* c = (Counting_Allocator*)a;
+    c->bytes += new_size - old_size;
+    return realloc(ptr, new_size);
+}
+
+static void counting_free(Ext_Allocator* a, void* ptr, size_t size) {
+    Counting_Allocator* c = (Counting_Allocator*)a;
+    c->allocations--;
+    c->bytes -= size;
+    free(ptr);
+}
+
+static TestNode* make_node(Counting_Allocator* a, int value, const char* label) {
+    TestNode* node = counting_alloc(&a->base, sizeof(TestNode));
+    char* copy = counting_alloc(&a->base, strlen(label) + 1);
+    strcpy(copy, label);
+    *node = (TestNode){value, NULL, copy};
+    return node;
+}
+
+CTEST(deep_copy, test_clone_preserves_sharing) {
+    TestSerialize value = make_test_serialize();
+    Ext_Arena arena = ext_make_arena();
+    TestSerialize* copy = ti_clone(type_any(&value, TestSerialize), &arena);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_TRUE(ti_equal(type_any(&value, TestSerialize), type_any(copy, TestSerialize)));
+
+    // The pointee shared by the elements is copied once
+    ASSERT_TRUE(copy->elements[0].ptr != value.elements[0].ptr);
+    ASSERT_TRUE(copy->elements[0].ptr == copy->elements[1].ptr);
+    ASSERT_TRUE(copy->elements[0].ptr == copy->elements[2].ptr);
+    ASSERT_TRUE(copy->name != value.name);
+    ASSERT_STR("name", copy->name);
+
+    // No pointers: copied whole, padding included
+    Point point = {1, 2};
+    Point* point_copy = ti_clone(type_any(&point, Point), &arena);
+    ASSERT_DATA((const unsigned char*)&point, sizeof(point), (const unsigned char*)point_copy,
+                sizeof(*point_copy));
+    ext_arena_destroy(&arena);
+}
+
+static int test_handler(void) {
+    return 42;
+}
+
+CTEST(deep_copy, test_function_pointers) {
+    TestCallbacks value = {1, NULL, {test_handler, NULL}};
+    Ext_Arena arena = ext_make_arena();
+    TestCallbacks* copy = ti_clone(type_any(&value, TestCallbacks), &arena);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_TRUE(copy->handlers[0] == test_handler);
+
+    // Not followed, also as the root or array elements
+    Type_Any handlers = {value.handlers, find_member(&typeinfo_TestCallbacks, "handlers")->type};
+    int (**handlers_copy)(void) = ti_clone(handlers, &arena);
+    ASSERT_NOT_NULL(handlers_copy);
+    ASSERT_EQUAL(42, handlers_copy[0]());
+    Type_Info* handler_type = ((Type_Info_Array*)handlers.type)->element_type;
+    ASSERT_NOT_NULL(ti_clone((Type_Any){&value.handlers[0], handler_type}, &arena));
+    ASSERT_TRUE(ti_destroy((Type_Any){&value.handlers[0], handler_type}, &ext_default_allocator.base));
+    ext_arena_destroy(&arena);
+
+    const char* path = "test_snapshot_callbacks.bin";
+    ASSERT_TRUE(ti_snapshot_write(handlers, path));
+    remove(path);
+}
+
+CTEST(deep_copy, test_clone_and_destroy_cycle) {
+    Counting_Allocator a = {{counting_alloc, counting_realloc, counting_free}, 0, 0};
+    TestNode* first = make_node(&a, 1, "first");
+    TestNode* second = make_node(&a, 2, "second");
+    TestNode* third = make_node(&a, 3, "third");
+    first->next = second;
+    second->next = third;
+    third->next = first;
+
+    Ext_Arena arena = ext_make_arena();
+    TestNode* copy = ti_clone(type_any(first, TestNode), &arena);
+    ASSERT_NOT_NULL(copy);
+    ASSERT_TRUE(copy != first);
+    ASSERT_TRUE(copy->next->next->next == copy);
+    ASSERT_EQUAL(2, copy->next->value);
+    ASSERT_STR("third", copy->next->next->label);
+    ASSERT_TRUE(copy->next->next->label != third->label);
+    ext_arena_destroy(&arena);
+
+    // Frees everything but the root, even though the cycle points back to it
+    TestNode root = {0, first, NULL};
+    ASSERT_TRUE(ti_destroy(type_any(&root, TestNode), &a.base));
+    ASSERT_EQUAL_U(0, a.allocations);
+    ASSERT_EQUAL_U(0, a.bytes);
+}
+
+CTEST(deep_copy, test_relocate) {
+    Ext_Arena from = ext_make_arena(), to = ext_make_arena();
+    TestNode* nodes[3];
+    for(int i = 0; i < 3; i++) {
+        ext_arena_alloc(&from, 100);  // Fragmentation
+        nodes[i] = ext_arena_alloc(&from, sizeof(TestNode));
+        *nodes[i] = (TestNode){i, NULL, i == 2 ? "static" : ext_arena_strdup(&from, "label")};
+    }
+    nodes[0]->next = nodes[1];
+    nodes[1]->next = nodes[2];
+    nodes[2]->next = nodes[0];
+
+    TestNode* root = ti_relocate(type_any(nodes[0], TestNode), &from, &to);
+    ASSERT_NOT_NULL(root);
+    ext_arena_destroy(&from);
+
+    ASSERT_TRUE(root->next->next->next == root);
+    ASSERT_EQUAL(1, root->next->value);
+    ASSERT_STR("label", root->next->label);
+    ASSERT_STR("static", root->next->next->label);  // Not in `from`: unchanged
+    // Nodes are laid out in the order they are reached
+    ASSERT_TRUE((char*)root < (char*)root->next && (char*)root->next < (char*)root->next->next);
+
+    // A root outside of `from` stays in place, its pointers are rewritten
+    TestNode* first = ext_arena_alloc(&to, sizeof(TestNode));
+    *first = (TestNode){7, NULL, NULL};
+    TestNode outside = {0, first, NULL};
+    Ext_Arena compacted = ext_make_arena();
+    ASSERT_TRUE(ti_relocate(type_any(&outside, TestNode), &to, &compacted) == &outside);
+    ASSERT_TRUE(outside.next != first);
+    ASSERT_EQUAL(7, outside.next->value);
+    ext_arena_destroy(&to);
+    ext_arena_destroy(&compacted);
+}
+
+// ==============================================================================
+// Member Path Tests
+// ==============================================================================
+
+CTEST(path, test_members) {
+    Type_Info_Path path;
+    const char* spec = "nested.nested_inner.inner_field";
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestNested.base, spec, &path));
+    ASSERT_TRUE(path.type == &typeinfo_int.base);
+    ASSERT_EQUAL_U(offsetof(TestNested, nested.nested_inner.inner_field), path.offset);
+    ASSERT_EQUAL_U(1, path.count);
+    ASSERT_EQUAL_U(0, path.dims_count);
+
+    TestNested nested = {{1}, {{2}}};
+    ASSERT_EQUAL(2, *(int*)ti_path_at(&path, &nested, 0));
+
+    // Members of anonymous records
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestAnonymous.base, "as_float", &path));
+    ASSERT_EQUAL_U(offsetof(TestAnonymous, as_float), path.offset);
+
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, "elements[2].tag", &path));
+    ASSERT_EQUAL_U(offsetof(TestSerialize, elements[2].tag), path.offset);
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, "grid[1][2]", &path));
+    ASSERT_EQUAL_U(offsetof(TestSerialize, grid[1][2]), path.offset);
+    ASSERT_TRUE(path.type == &typeinfo_short.base);
+}
+
+CTEST(path, test_wildcards) {
+    TestSerialize value;
+    memset(&value, 0, sizeof(value));
+    for(int i = 0; i < 3; i++) value.elements[i].value = 10 * i;
+    for(int i = 0; i < 6; i++) value.grid[i / 3][i % 3] = (short)i;
+
+    Type_Info_Path path;
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, "elements[*].value", &path));
+    ASSERT_EQUAL_U(offsetof(TestSerialize, elements[0].value), path.offset);
+    ASSERT_EQUAL_U(3, path.count);
+    ASSERT_EQUAL_U(1, path.dims_count);
+    ASSERT_EQUAL_U(sizeof(TestSerializeElement), path.dims[0].stride);
+    ASSERT_EQUAL(20, *(int*)ti_path_at(&path, &value, 2));
+
+    int values[3];
+    ASSERT_EQUAL_U(3, ti_path_gather(&path, &value, values));
+    ASSERT_EQUAL(0, values[0]);
+    ASSERT_EQUAL(10, values[1]);
+    ASSERT_EQUAL(20, values[2]);
+
+    // Contiguous wildcards are merged
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, "grid[*][*]", &path));
+    ASSERT_EQUAL_U(1, path.dims_count);
+    ASSERT_EQUAL_U(6, path.count);
+    short grid[6];
+    ASSERT_EQUAL_U(6, ti_path_gather(&path, &value, grid));
+    for(int i = 0; i < 6; i++) ASSERT_EQUAL(i, grid[i]);
+
+    // A column: one wildcard over the rows
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, "grid[*][1]", &path));
+    ASSERT_EQUAL_U(2, path.count);
+    ASSERT_EQUAL(4, *(short*)ti_path_at(&path, &value, 1));
+
+    TestVectors vectors;
+    memset(&vectors, 0, sizeof(vectors));
+    vectors.indices = (TestVec4i){5, 6, 7, 8};
+    ASSERT_TRUE(ti_path_compile(&typeinfo_TestVectors.base, "indices[3]", &path));
+    ASSERT_EQUAL(8, *(int*)ti_path_at(&path, &vectors, 0));
+}
+
+CTEST(path, test_nested_wildcards) {
+    // Two wildcards that can't be merged: arrays inside an array of structs
+    TestArrays arrays[2];
+    for(int i = 0; i < 20; i++) arrays[i / 10].arr[i % 10] = i;
+    Type_Info_Array array = {{TYPE_TAG_ARRAY, sizeof(arrays), TYPEINFO_ALIGNOF(TestArrays),
+                              typeinfo_TestArrays.base.traits},
+                             2, &typeinfo_TestArrays.base};
+    Type_Info_Path path;
+    ASSERT_TRUE(ti_path_compile(&array.base, "[*].arr[*]", &path));
+    ASSERT_EQUAL_U(2, path.dims_count);
+    ASSERT_EQUAL_U(20, path.count);
+    ASSERT_EQUAL_U(sizeof(TestArrays), path.dims[0].stride);
+    ASSERT_EQUAL(13, *(int*)ti_path_at(&path, arrays, 13));
+
+    int values[20];
+    ASSERT_EQUAL_U(20, ti_path_gather(&path, arrays, values));
+    for(int i = 0; i < 20; i++) ASSERT_EQUAL(i, values[i]);
+}
+
+CTEST(path, test_errors) {
+    Type_Info_Path path = {0};
+    Type_Info* root = &typeinfo_TestSerialize.base;
+    ASSERT_FALSE(ti_path_compile(root, "missing", &path));
+    ASSERT_FALSE(ti_path_compile(root, "elements[3].tag", &path));  // Out of bounds
+    ASSERT_FALSE(ti_path_compile(root, "elements[*]tag", &path));
+    ASSERT_FALSE(ti_path_compile(root, "elements[].tag", &path));
+    ASSERT_FALSE(ti_path_compile(root, "elements.tag", &path));
+    ASSERT_FALSE(ti_path_compile(root, "c.x", &path));
+    ASSERT_FALSE(ti_path_compile(root, "c.", &path));
+    ASSERT_FALSE(ti_path_compile(root, ".c", &path));
+    ASSERT_FALSE(ti_path_compile(root, "elements[0].ptr.x", &path));  // Through a pointer
+    ASSERT_FALSE(ti_path_compile(&typeinfo_TestBitfields.base, "delta", &path));
+    ASSERT_TRUE(path.type == NULL);  // Left as it was
+}
+
+// ==============================================================================
+// Leaf Table Tests
+// ==============================================================================
+
+CTEST(leaves, test_flattened) {
+    const Type_Info_Struct* s = &typeinfo_TestSerialize;
+    // c, s, 3 * (tag, value), d, 6 grid cells, status; pointers and unions are left out
+    ASSERT_EQUAL_U(16, s->leaves_count);
+    ASSERT_STR("elements[1].value", s->leaves[5].name);
+    ASSERT_EQUAL_U(offsetof(TestSerialize, elements[1].value), s->leaves[5].offset);
+    ASSERT_STR("grid[1][2]", s->leaves[14].name);
+    ASSERT_TRUE(s->leaves[14].type == &typeinfo_short.base);
+    ASSERT_STR("status", s->leaves[15].name);
+    ASSERT_TRUE(s->leaves[15].type == &typeinfo_Status.base);
+
+    // Names are paths, sorted by offset
+    for(size_t i = 0; i < s->leaves_count; i++) {
+        Type_Info_Path path;
+        ASSERT_TRUE(ti_path_compile(&typeinfo_TestSerialize.base, s->leaves[i].name, &path));
+        ASSERT_EQUAL_U(path.offset, s->leaves[i].offset);
+        ASSERT_TRUE(path.type == s->leaves[i].type);
+        if(i > 0) ASSERT_TRUE(s->leaves[i - 1].offset < s->leaves[i].offset);
+    }
+
+    // Only roots have leaves
+    ASSERT_EQUAL_U(0, typeinfo_TestSerializeElement.leaves_count);
+    ASSERT_NULL(typeinfo_TestSerializeElement.leaves);
+}
+
+CTEST(leaves, test_anonymous_and_bitfields) {
+    const Type_Info_Struct* s = &typeinfo_TestAnonymous;
+    ASSERT_EQUAL_U(2, s->leaves_count);
+    ASSERT_STR("anon_x", s->leaves[0].name);
+    ASSERT_STR("anon_y", s->leaves[1].name);
+
+    s = &typeinfo_TestBitfields;
+    ASSERT_EQUAL_U(6, s->leaves_count);
+    const Type_Info_Leaf* delta = &s->leaves[1];
+    ASSERT_STR("delta", delta->name);
+    ASSERT_EQUAL_U(3, delta->bit_offset);
+    ASSERT_EQUAL_U(5, delta->bit_width);
+    TestBitfields value = {0};
+    value.delta = -5;
+    uint64_t bits = ti_bits_get((char*)&value + delta->offset, delta->bit_offset, delta->bit_width,
+                                true);
+    ASSERT_TRUE(bits == (uint64_t)-5);
+}
+
+// ==============================================================================
+// Walk Tests
+// ==============================================================================
+
+typedef struct {
+    char trace[256];
+    size_t nodes;
+    long long sum;
+    const char* skip;  // Member whose value is not entered
+    const char* stop;  // Member ending the walk
+} Walk_Trace;
+
+static Type_Info_Walk_Action trace_visitor(Type_Any value, const Type_Info_Member* member,
+                                           size_t depth, void* user) {
+    (void)value;
+    Walk_Trace* t = user;
+    size_t len = strlen(t->trace);
+    snprintf(t->trace + len, sizeof(t->trace) - len, "%s%s:%zu", len ? " " : "",
+             member ? member->name : "-", depth);
+    if(member && t->stop && strcmp(member->name, t->stop) == 0) return TYPE_INFO_WALK_STOP;
+    if(member && t->skip && strcmp(member->name, t->skip) == 0) return TYPE_INFO_WALK_SKIP;
+    return TYPE_INFO_WALK_CONTINUE;
+}
+
+static Type_Info_Walk_Action count_visitor(Type_Any value, const Type_Info_Member* member,
+                                           size_t depth, void* user) {
+    (void)depth;
+    Walk_Trace* t = user;
+    if(!member && value.type == &typeinfo_TestNode.base) {
+        t->nodes++;
+        t->sum += ((TestNode*)value.value)->value;
+    }
+    return TYPE_INFO_WALK_CONTINUE;
+}
+
+CTEST(walk, test_order) {
+    TestNode second = {2, NULL, "b"};
+    TestNode first = {1, &second, "a"};
+    Walk_Trace t = {0};
+    ASSERT_TRUE(ti_walk(type_any(&first, TestNode), trace_visitor, &t));
+    // Pointees are visited right after their pointer, before the next members
+    ASSERT_STR("-:0 value:1 next:1 -:2 value:3 next:3 label:3 -:4 label:1 -:2", t.trace);
+
+    Walk_Trace skip = {.skip = "next"};
+    ASSERT_TRUE(ti_walk(type_any(&first, TestNode), trace_visitor, &skip));
+    ASSERT_STR("-:0 value:1 next:1 label:1 -:2", skip.trace);
+
+    Walk_Trace stop = {.stop = "label"};
+    ASSERT_FALSE(ti_walk(type_any(&first, TestNode), trace_visitor, &stop));
+    ASSERT_STR("-:0 value:1 next:1 -:2 value:3 next:3 label:3", stop.trace);
+}
+
+CTEST(walk, test_arrays) {
+    int x = 7;
+    TestSerializeElement elements[2] = {{'a', 1, &x}, {'b', 2, NULL}};
+    Type_Info_Array array = {{TYPE_TAG_ARRAY, sizeof(elements), TYPEINFO_ALIGNOF(elements),
+                              TYPE_INFO_TRAIT_HAS_POINTERS},
+                             2, &typeinfo_TestSerializeElement.base};
+    Walk_Trace t = {0};
+    ASSERT_TRUE(ti_walk((Type_Any){elements, &array.base}, trace_visitor, &t));
+    ASSERT_STR("-:0 -:1 tag:2 value:2 ptr:2 -:3 -:1 tag:2 value:2 ptr:2", t.trace);
+}
+
+CTEST(walk, test_long_list) {
+    // Deep enough to overflow the C stack when recursing
+    size_t count = 1000000;
+    TestNode* nodes = malloc(count * sizeof(TestNode));
+    ASSERT_TRUE(nodes != NULL);
+    for(size_t i = 0; i < count; i++) {
+        nodes[i] = (TestNode){(int)(i % 10), i + 1 < count ? &nodes[i + 1] : NULL, NULL};
+    }
+    Walk_Trace t = {0};
+    ASSERT_TRUE(ti_walk(type_any(nodes, TestNode), count_visitor, &t));
+    ASSERT_EQUAL_U(count, t.nodes);
+    ASSERT_TRUE(t.sum == 4500000);
+    free(nodes);
+}
+
+// ==============================================================================
+// Snapshot Tests
+// ==============================================================================
+
+CTEST(snapshot, test_write_and_map) {
+    TestNode nodes[3] = {{1, NULL, "first"}, {2, NULL, NULL}, {3, NULL, "third"}};
+    nodes[0].next = &nodes[1];
+    nodes[1].next = &nodes[2];
+    nodes[2].next = &nodes[0];
+    const char* path = "test_snapshot.bin";
+    ASSERT_TRUE(ti_snapshot_write(type_any(&nodes[0], TestNode), path));
+
+    TestNode* root = ti_snapshot_map(path, &typeinfo_TestNode.base);
+    ASSERT_NOT_NULL(root);
+    ASSERT_EQUAL(1, root->value);
+    ASSERT_STR("first", ti_snapshot_ptr(&root->label));
+    TestNode* second = ti_snapshot_ptr(&root->next);
+    ASSERT_EQUAL(2, second->value);
+    ASSERT_NULL(ti_snapshot_ptr(&second->label));
+    TestNode* third = ti_snapshot_ptr(&second->next);
+    ASSERT_STR("third", ti_snapshot_ptr(&third->label));
+    ASSERT_TRUE(ti_snapshot_ptr(&third->next) == root);
+    ti_snapshot_unmap(root);
+
+    ASSERT_NULL(ti_snapshot_map(path, &typeinfo_Point.base));
+    FILE* file = fopen(path, "ab");  // The size no longer matches the header
+    ASSERT_NOT_NULL(file);
+    fputs("trailing", file);
+    fclose(file);
+    ASSERT_NULL(ti_snapshot_map(path, &typeinfo_TestNode.base));
+    remove(path);
+    ASSERT_NULL(ti_snapshot_map(path, &typeinfo_TestNode.base));
+}
+
+CTEST(snapshot, test_nested_pointers) {
+    TestSerialize value = make_test_serialize();
+    const char* path = "test_snapshot_nested.bin";
+    ASSERT_TRUE(ti_snapshot_write(type_any(&value, TestSerialize), path));
+    TestSerialize* root = ti_snapshot_map(path, &typeinfo_TestSerialize.base);
+    ASSERT_NOT_NULL(root);
+    ASSERT_EQUAL(3, root->grid[1][0]);
+    int* shared = ti_snapshot_ptr(&root->elements[0].ptr);
+    ASSERT_EQUAL(42, *shared);
+    ASSERT_TRUE(ti_snapshot_ptr(&root->elements[2].ptr) == shared);
+    ASSERT_STR("name", ti_snapshot_ptr(&root->name));
+    ti_snapshot_unmap(root);
+    remove(path);
+}
+
+// ==============================================================================
+// Bitfield Tests
+// ==============================================================================
+
+static TestBitfields make_test_bitfields(void) {
+    TestBitfields value;
+    memset(&value, 0xFF, sizeof(value));  // Unused bits are set, and must be ignored
+    value.flags = 5;
+    value.delta = -3;
+    value.wide = 0xABCDE;
+    value.status = STATUS_PENDING;
+    value.tag = 't';
+    value.big = 0x123456789AULL;
+    return value;
+}
+
+CTEST(bitfields, test_members) {
+    ASSERT_TRUE(typeinfo_TestBitfields.base.traits & TYPE_INFO_TRAIT_HAS_BITFIELDS);
+    ASSERT_TRUE(typeinfo_TestBitfields.base.traits & TYPE_INFO_TRAIT_HAS_PADDING);
+    ASSERT_FALSE(typeinfo_TestBitfields.base.traits & TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE);
+    ASSERT_FALSE(typeinfo_TestBitfieldsUnpacked.base.traits & TYPE_INFO_TRAIT_HAS_BITFIELDS);
+
+    // The unnamed bitfield is not a member
+    ASSERT_EQUAL_U(6, typeinfo_TestBitfields.members_count);
+    const Type_Info_Member* delta = &typeinfo_TestBitfields.members[1];
+    ASSERT_STR("delta", delta->name);
+    ASSERT_EQUAL_U(0, delta->offset);
+    ASSERT_EQUAL_U(3, delta->bit_offset);
+    ASSERT_EQUAL_U(5, delta->bit_width);
+    ASSERT_EQUAL_U(0, typeinfo_TestBitfields.members[4].bit_width);
+
+    TestBitfields value = make_test_bitfields();
+    ASSERT_TRUE(ti_bitfield_get(delta, &value) == (uint64_t)-3);
+    ASSERT_TRUE(ti_bitfield_get(&typeinfo_TestBitfields.members[2], &value) == 0xABCDE);
+    ASSERT_TRUE(ti_bitfield_get(&typeinfo_TestBitfields.members[5], &value) == 0x123456789AULL);
+    ti_bitfield_set(delta, &value, 11);
+    ASSERT_EQUAL(11, value.delta);
+    ASSERT_EQUAL(5, value.flags);
+    ti_bitfield_set(&typeinfo_TestBitfields.members[3], &value, STATUS_ERROR);
+    ASSERT_EQUAL(STATUS_ERROR, value.status);
+    ASSERT_EQUAL_U(0xABCDE, value.wide);
+}
+
+CTEST(bitfields, test_serialize) {
+    TestBitfields value = make_test_bitfields();
+    // flags and delta, wide and status, tag, big
+    ASSERT_EQUAL_U(1 + 3 + 1 + 5, TI_SERIALIZED_SIZE_TestBitfields);
+    ASSERT_EQUAL_U(TI_SERIALIZED_SIZE_TestBitfields,
+                   ti_serialized_size(&typeinfo_TestBitfields.base));
+    unsigned char interpreted[TI_SERIALIZED_SIZE_TestBitfields];
+    unsigned char generated[TI_SERIALIZED_SIZE_TestBitfields];
+    ti_serialize(type_any(&value, TestBitfields), interpreted);
+    ti_serialize_TestBitfields(&value, generated);
+    ASSERT_DATA(interpreted, sizeof(interpreted), generated, sizeof(generated));
+    ASSERT_EQUAL(0, interpreted[3] & 0xC0);  // Unused bits after `status` are cleared
+
+    TestBitfields out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_EQUAL_U(sizeof(interpreted),
+                   ti_deserialize(type_any(&out, TestBitfields), interpreted, sizeof(interpreted)));
+    ASSERT_TRUE(ti_equal(type_any(&value, TestBitfields), type_any(&out, TestBitfields)));
+    ASSERT_EQUAL(-3, out.delta);
+    ASSERT_EQUAL(STATUS_PENDING, out.status);
+    ASSERT_TRUE(out.big == 0x123456789AULL);
+
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestBitfields.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL(TYPE_INFO_PLAN_COPY, plan->ops[0].kind);
+    ASSERT_EQUAL(TYPE_INFO_PLAN_BITS, plan->ops[1].kind);
+    ASSERT_EQUAL_U(3, plan->ops[1].size);
+    ASSERT_TRUE(plan->ops[1].mask == 0x3FFFFF);
+}
+
+CTEST(bitfields, test_equality_ignores_unused_bits) {
+    TestBitfields a = make_test_bitfields();
+    TestBitfields b;
+    memset(&b, 0, sizeof(b));
+    b.flags = 5;
+    b.delta = -3;
+    b.wide = 0xABCDE;
+    b.status = STATUS_PENDING;
+    b.tag = 't';
+    b.big = 0x123456789AULL;
+    ASSERT_TRUE(ti_equal(type_any(&a, TestBitfields), type_any(&b, TestBitfields)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestBitfields)) == ti_hash(type_any(&b, TestBitfields)));
+    ASSERT_EQUAL(0, ti_compare(type_any(&a, TestBitfields), type_any(&b, TestBitfields)));
+
+    b.delta = -4;  // Signed: ordered before -3
+    ASSERT_FALSE(ti_equal(type_any(&a, TestBitfields), type_any(&b, TestBitfields)));
+    ASSERT_TRUE(ti_compare(type_any(&b, TestBitfields), type_any(&a, TestBitfields)) < 0);
+}
+
+CTEST(bitfields, test_json) {
+    TestBitfields value = make_test_bitfields();
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&value, TestBitfields), &buf));
+    ASSERT_STR("{\"flags\":5,\"delta\":-3,\"wide\":703710,\"status\":\"STATUS_PENDING\","
+               "\"tag\":116,\"big\":78187493530}",
+               buf.data);
+
+    TestBitfields out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_TRUE(ti_json_decode(buf.data, buf.size, type_any(&out, TestBitfields)));
+    ASSERT_TRUE(ti_equal(type_any(&value, TestBitfields), type_any(&out, TestBitfields)));
+    ti_buffer_free(&buf);
+
+    // Values must fit in the bitfield
+    const char* json = "{\"delta\":-16}";
+    ASSERT_TRUE(ti_json_decode(json, strlen(json), type_any(&out, TestBitfields)));
+    ASSERT_EQUAL(-16, out.delta);
+    json = "{\"delta\":16}";
+    ASSERT_FALSE(ti_json_decode(json, strlen(json), type_any(&out, TestBitfields)));
+    json = "{\"flags\":8}";
+    ASSERT_FALSE(ti_json_decode(json, strlen(json), type_any(&out, TestBitfields)));
+}
+
+CTEST(bitfields, test_stream) {
+    TestBitfields value = make_test_bitfields();
+    unsigned char data[TI_SERIALIZED_SIZE_TestBitfields];
+    ti_serialize(type_any(&value, TestBitfields), data);
+
+    TestBitfields out;
+    memset(&out, 0, sizeof(out));
+    Type_Info_Stream_Frame frames[TI_MAX_DEPTH_TestBitfields];
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_BINARY, type_any(&out, TestBitfields), frames,
+                   TI_MAX_DEPTH_TestBitfields);
+    for(size_t i = 0; i < sizeof(data); i++) ti_stream_feed(&stream, data + i, 1, NULL);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, stream.status);
+    ASSERT_TRUE(ti_equal(type_any(&value, TestBitfields), type_any(&out, TestBitfields)));
+
+    const char* json = "{\"wide\":1048575,\"status\":\"STATUS_ERROR\",\"delta\":-7}";
+    memset(&out, 0, sizeof(out));
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, TestBitfields), frames,
+                   TI_MAX_DEPTH_TestBitfields);
+    for(size_t i = 0; json[i]; i++) ti_stream_feed(&stream, json + i, 1, NULL);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, stream.status);
+    ASSERT_EQUAL_U(1048575, out.wide);
+    ASSERT_EQUAL(STATUS_ERROR, out.status);
+    ASSERT_EQUAL(-7, out.delta);
+    ASSERT_EQUAL(0, out.flags);
+}
+
+CTEST(bitfields, test_migration) {
+    TestBitfields value = make_test_bitfields();
+    TestBitfieldsUnpacked unpacked;
+    const Type_Info_Migration* m =
+        ti_migration_get(&typeinfo_TestBitfields.base, &typeinfo_TestBitfieldsUnpacked.base);
+    ASSERT_NOT_NULL(m);
+    ti_migrate(m, &unpacked, &value, 1);
+    ASSERT_EQUAL(5, unpacked.flags);
+    ASSERT_EQUAL(-3, unpacked.delta);
+    ASSERT_EQUAL_U(0xABCDE, unpacked.wide);
+    ASSERT_EQUAL(STATUS_PENDING, unpacked.status);
+    ASSERT_TRUE(unpacked.big == 0x123456789AULL);
+
+    unpacked.delta = -9;
+    TestBitfields out;
+    memset(&out, 0, sizeof(out));
+    m = ti_migration_get(&typeinfo_TestBitfieldsUnpacked.base, &typeinfo_TestBitfields.base);
+    ASSERT_NOT_NULL(m);
+    ti_migrate(m, &out, &unpacked, 1);
+    ASSERT_EQUAL(5, out.flags);
+    ASSERT_EQUAL(-9, out.delta);
+    ASSERT_EQUAL('t', out.tag);
+    ASSERT_TRUE(out.big == 0x123456789AULL);
+    ti_migration_cache_clear();
+}
+
+// ==============================================================================
+// Vector Tests
+// ==============================================================================
+
+static TestVectors make_test_vectors(void) {
+    TestVectors value;
+    memset(&value, 0, sizeof(value));
+    value.position = (TestVec4f){1.0f, -2.5f, 0.25f, 8.0f};
+    value.indices = (TestVec4i){3, -1, 7, 100000};
+    value.id = 42;
+    return value;
+}
+
+CTEST(vectors, test_type_info) {
+    const Type_Info_Member* position = &typeinfo_TestVectors.members[0];
+    ASSERT_EQUAL(TYPE_TAG_VECTOR, position->type->tag);
+    ASSERT_EQUAL_U(16, position->type->alignment);
+    const Type_Info_Vector* v = (const Type_Info_Vector*)position->type;
+    ASSERT_EQUAL_U(4, v->num_lanes);
+    ASSERT_TRUE(v->lane_type == &typeinfo_float.base);
+    ASSERT_TRUE(position->type->traits & TYPE_INFO_TRAIT_HAS_FLOATS);
+
+    const Type_Info* indices = typeinfo_TestVectors.members[1].type;
+    ASSERT_TRUE(((const Type_Info_Vector*)indices)->lane_type == &typeinfo_int.base);
+    ASSERT_TRUE(indices->traits & TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE);
+    ASSERT_EQUAL_U(2, ti_max_depth(&typeinfo_TestVectors.base));
+}
+
+CTEST(vectors, test_serialize) {
+    TestVectors value = make_test_vectors();
+    ASSERT_EQUAL_U(33, TI_SERIALIZED_SIZE_TestVectors);
+    ASSERT_EQUAL_U(33, ti_serialized_size(&typeinfo_TestVectors.base));
+    unsigned char interpreted[TI_SERIALIZED_SIZE_TestVectors];
+    unsigned char generated[TI_SERIALIZED_SIZE_TestVectors];
+    ti_serialize(type_any(&value, TestVectors), interpreted);
+    ti_serialize_TestVectors(&value, generated);
+    ASSERT_DATA(interpreted, sizeof(interpreted), generated, sizeof(generated));
+
+    // The vectors are copied whole, together with the next member
+    const Type_Info_Plan* plan = ti_plan_get(&typeinfo_TestVectors.base);
+    ASSERT_NOT_NULL(plan);
+    ASSERT_EQUAL_U(1, plan->ops_count);
+    ASSERT_EQUAL_U(33, plan->ops[0].size);
+
+    TestVectors out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_EQUAL_U(sizeof(interpreted),
+                   ti_deserialize(type_any(&out, TestVectors), interpreted, sizeof(interpreted)));
+    ASSERT_TRUE(ti_equal(type_any(&value, TestVectors), type_any(&out, TestVectors)));
+}
+
+CTEST(vectors, test_equality) {
+    TestVectors a = make_test_vectors();
+    TestVectors b = make_test_vectors();
+    a.position[2] = 0.0f;
+    b.position[2] = -0.0f;  // Lanes compare as floats
+    ASSERT_TRUE(ti_equal(type_any(&a, TestVectors), type_any(&b, TestVectors)));
+    ASSERT_TRUE(ti_hash(type_any(&a, TestVectors)) == ti_hash(type_any(&b, TestVectors)));
+
+    b.indices[1] = -2;
+    ASSERT_FALSE(ti_equal(type_any(&a, TestVectors), type_any(&b, TestVectors)));
+    ASSERT_TRUE(ti_compare(type_any(&b, TestVectors), type_any(&a, TestVectors)) < 0);
+}
+
+CTEST(vectors, test_json) {
+    TestVectors value = make_test_vectors();
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&value, TestVectors), &buf));
+    ASSERT_STR("{\"position\":[1.0,-2.5,0.25,8.0],\"indices\":[3,-1,7,100000],\"id\":42}", buf.data);
+
+    TestVectors out;
+    memset(&out, 0, sizeof(out));
+    ASSERT_TRUE(ti_json_decode(buf.data, buf.size, type_any(&out, TestVectors)));
+    ASSERT_TRUE(ti_equal(type_any(&value, TestVectors), type_any(&out, TestVectors)));
+
+    memset(&out, 0, sizeof(out));
+    Type_Info_Stream_Frame frames[TI_MAX_DEPTH_TestVectors];
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, TestVectors), frames,
+                   TI_MAX_DEPTH_TestVectors);
+    for(size_t i = 0; i < buf.size; i++) ti_stream_feed(&stream, buf.data + i, 1, NULL);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, stream.status);
+    ASSERT_TRUE(ti_equal(type_any(&value, TestVectors), type_any(&out, TestVectors)));
+    ti_buffer_free(&buf);
+
+    const char* json = "{\"indices\":[1,2,3,4,5]}";  // Too many lanes
+    ASSERT_FALSE(ti_json_decode(json, strlen(json), type_any(&out, TestVectors)));
+}
+
+// ==============================================================================
+// Migration Tests
+// ==============================================================================
+
+CTEST(migration, test_upgrade_records) {
+    TestRecordV1 old[3] = {
+        {1, 1.5f, -2, 7, "one", {1, 2}, {0.5f, 1.0f, 1.5f}, STATUS_PENDING},
+        {2, -3.25f, 300, 0, "two", {3, 4}, {2.0f, 2.5f, 3.0f}, STATUS_OK},
+        {-3, 0.0f, -32768, 255, "three", {5, 6}, {-1.0f, 0.0f, 1.0f}, STATUS_ERROR},
+    };
+    TestRecordV2 current[3];
+    memset(current, 0xAB, sizeof(current));
+
+    const Type_Info_Migration* m =
+        ti_migration_get(&typeinfo_TestRecordV1.base, &typeinfo_TestRecordV2.base);
+    ASSERT_NOT_NULL(m);
+    ASSERT_TRUE(m->from_fingerprint == TI_FINGERPRINT_TestRecordV1);
+    ASSERT_TRUE(m->to_fingerprint == TI_FINGERPRINT_TestRecordV2);
+    ti_migrate(m, current, old, 3);
+
+    ASSERT_TRUE(current[2].id == -3);
+    ASSERT_STR("three", current[2].name);
+    ASSERT_EQUAL(0, current[2].name[11]);
+    ASSERT_EQUAL(5, current[2].position.x);
+    ASSERT_TRUE(current[1].score == -3.25);
+    ASSERT_EQUAL(-2, current[0].delta);
+    ASSERT_EQUAL(300, current[1].delta);
+    ASSERT_EQUAL(-32768, current[2].delta);
+    ASSERT_EQUAL_U(0, current[1].added);
+    ASSERT_TRUE(current[0].samples[2] == 1.5);
+    ASSERT_TRUE(current[2].samples[0] == -1.0);
+    ASSERT_TRUE(current[2].samples[3] == 0.0);
+    ASSERT_TRUE(current[0].status == STATUS_PENDING);
+    ASSERT_TRUE(current[2].status == STATUS_ERROR);
+    ti_migration_cache_clear();
+}
+
+CTEST(migration, test_downgrade_records) {
+    TestRecordV2 current = {-5, "eleven char", {7, 8}, 2.5, 70000, 9, {1, 2, 3, 4}, 1.0};
+    TestRecordV1 old;
+    const Type_Info_Migration* m =
+        ti_migration_get(&typeinfo_TestRecordV2.base, &typeinfo_TestRecordV1.base);
+    ASSERT_NOT_NULL(m);
+    ti_migrate(m, &old, &current, 1);
+    ASSERT_EQUAL(-5, old.id);
+    ASSERT_TRUE(memcmp(old.name, "eleven c", 8) == 0);
+    ASSERT_TRUE(old.score == 2.5f);
+    ASSERT_EQUAL((short)70000, old.delta);
+    ASSERT_EQUAL(0, old.flags);
+    ASSERT_TRUE(old.samples[2] == 3.0f);
+    // Floats are not converted to enums
+    ASSERT_EQUAL(0, old.status);
+    ti_migration_cache_clear();
+}
+
+CTEST(migration, test_migrations_are_cached) {
+    const Type_Info_Migration* m =
+        ti_migration_get(&typeinfo_TestRecordV1.base, &typeinfo_TestRecordV2.base);
+    ASSERT_NOT_NULL(m);
+    ASSERT_TRUE(m == ti_migration_get(&typeinfo_TestRecordV1.base, &typeinfo_TestRecordV2.base));
+    ASSERT_TRUE(m != ti_migration_get(&typeinfo_TestRecordV2.base, &typeinfo_TestRecordV1.base));
+
+    // Matching members are merged into bulk copies, element conversions into a loop
+    bool has_loop = false;
+    for(size_t i = 0; i < m->ops_count; i++) {
+        if(m->ops[i].kind == TYPE_INFO_MIGRATE_LOOP) {
+            has_loop = true;
+            ASSERT_EQUAL_U(3, m->ops[i].count);
+            ASSERT_EQUAL_U(1, m->ops[i].body_count);
+            ASSERT_EQUAL(TYPE_INFO_MIGRATE_FLOAT, m->ops[i + 1].kind);
+        }
+    }
+    ASSERT_TRUE(has_loop);
+
+    // Unchanged types are a single copy
+    const Type_Info_Migration* same =
+        ti_migration_get(&typeinfo_TestRecordV1.base, &typeinfo_TestRecordV1.base);
+    ASSERT_NOT_NULL(same);
+    ASSERT_EQUAL_U(1, same->ops_count);
+    ASSERT_EQUAL(TYPE_INFO_MIGRATE_COPY, same->ops[0].kind);
+    ASSERT_EQUAL_U(sizeof(TestRecordV1), same->ops[0].size);
+    ti_migration_cache_clear();
+}
+
+// ==============================================================================
+// Streaming Tests
+// ==============================================================================
+
+// Feeds `data` in chunks of `chunk` bytes, returning the final status
+static Type_Info_Stream_Status stream_in_chunks(Type_Info_Stream* stream, const char* data,
+                                                size_t size, size_t chunk, size_t* total) {
+    Type_Info_Stream_Status status = TYPE_INFO_STREAM_NEED_MORE;
+    *total = 0;
+    while(*total < size && status == TYPE_INFO_STREAM_NEED_MORE) {
+        size_t n = size - *total < chunk ? size - *total : chunk;
+        size_t consumed;
+        status = ti_stream_feed(stream, data + *total, n, &consumed);
+        *total += consumed;
+    }
+    return status;
+}
+
+CTEST(stream, test_max_depth) {
+    ASSERT_EQUAL_U(3, ti_max_depth(&typeinfo_TestSerialize.base));
+    ASSERT_EQUAL_U(3, TI_MAX_DEPTH_TestSerialize);
+    ASSERT_EQUAL_U(3, ti_max_depth(&typeinfo_TestComplex.base));
+    ASSERT_EQUAL_U(3, TI_MAX_DEPTH_TestComplex);
+    ASSERT_EQUAL_U(1, TI_MAX_DEPTH_Point);
+    ASSERT_EQUAL_U(0, ti_max_depth(&typeinfo_int.base));
+}
+
+CTEST(stream, test_binary_in_chunks) {
+    TestSerialize value = make_test_serialize();
+    unsigned char data[TI_SERIALIZED_SIZE_TestSerialize];
+    ti_serialize(type_any(&value, TestSerialize), data);
+    TestSerialize expected;
+    memset(&expected, 0, sizeof(expected));
+    ti_deserialize(type_any(&expected, TestSerialize), data, sizeof(data));
+
+    for(size_t chunk = 1; chunk <= sizeof(data); chunk += 7) {
+        TestSerialize out;
+        memset(&out, 0, sizeof(out));
+        Type_Info_Stream_Frame frames[TI_MAX_DEPTH_TestSerialize];
+        Type_Info_Stream stream;
+        ti_stream_init(&stream, TYPE_INFO_STREAM_BINARY, type_any(&out, TestSerialize), frames,
+                       TI_MAX_DEPTH_TestSerialize);
+        size_t total;
+        ASSERT_EQUAL(TYPE_INFO_STREAM_DONE,
+                     stream_in_chunks(&stream, (const char*)data, sizeof(data), chunk, &total));
+        ASSERT_EQUAL_U(sizeof(data), total);
+        ASSERT_DATA((const unsigned char*)&expected, sizeof(expected),
+                    (const unsigned char*)&out, sizeof(out));
+    }
+}
+
+CTEST(stream, test_binary_back_to_back) {
+    Point points[2] = {{1, 2}, {3, 4}};
+    char data[4 * sizeof(int)];
+    ti_serialize(type_any(&points[0], Point), data);
+    ti_serialize(type_any(&points[1], Point), data + 2 * sizeof(int));
+
+    Point out;
+    Type_Info_Stream_Frame frames[TI_MAX_DEPTH_Point];
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_BINARY, type_any(&out, Point), frames, 1);
+    size_t consumed;
+    ASSERT_EQUAL(TYPE_INFO_STREAM_NEED_MORE, ti_stream_feed(&stream, data, 3, &consumed));
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, ti_stream_feed(&stream, data + 3, 10, &consumed));
+    ASSERT_EQUAL_U(2 * sizeof(int) - 3, consumed);
+    ASSERT_EQUAL(2, out.y);
+
+    ti_stream_init(&stream, TYPE_INFO_STREAM_BINARY, type_any(&out, Point), frames, 1);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_NEED_MORE, ti_stream_feed(&stream, data + 8, 4, NULL));
+    ASSERT_EQUAL(TYPE_INFO_STREAM_ERROR, ti_stream_feed(&stream, NULL, 0, NULL));
+}
+
+CTEST(stream, test_json_in_chunks) {
+    TestSerialize value = make_test_serialize();
+    for(int i = 0; i < 3; i++) value.elements[i].ptr = NULL;
+    value.name = NULL;
+    Type_Info_Buffer buf = {0};
+    ASSERT_TRUE(ti_json_encode(type_any(&value, TestSerialize), &buf));
+    TestSerialize expected;
+    memset(&expected, 0, sizeof(expected));
+    ASSERT_TRUE(ti_json_decode(buf.data, buf.size, type_any(&expected, TestSerialize)));
+
+    for(size_t chunk = 1; chunk <= 8; chunk++) {
+        TestSerialize out;
+        memset(&out, 0, sizeof(out));
+        Type_Info_Stream_Frame frames[TI_MAX_DEPTH_TestSerialize];
+        Type_Info_Stream stream;
+        ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, TestSerialize), frames,
+                       TI_MAX_DEPTH_TestSerialize);
+        size_t total;
+        ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, stream_in_chunks(&stream, buf.data, buf.size, chunk,
+                                                              &total));
+        ASSERT_EQUAL_U(buf.size, total);
+        ASSERT_DATA((const unsigned char*)&expected, sizeof(expected),
+                    (const unsigned char*)&out, sizeof(out));
+    }
+    ti_buffer_free(&buf);
+}
+
+CTEST(stream, test_json_strings_and_skipping) {
+    const char* json = "{\"unknown\":{\"a\":[1,{\"b\":\"}\\\"]\"}],\"c\":null},"
+                       "\"str\":\"a\\u00e9\\ud83d\\ude00\\n\",\"arr\":[1,2],\"m\\u0061trix\":[[5]]}";
+    TestArrays out;
+    memset(&out, 0, sizeof(out));
+    Type_Info_Stream_Frame frames[TI_MAX_DEPTH_TestArrays];
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, TestArrays), frames,
+                   TI_MAX_DEPTH_TestArrays);
+    size_t total;
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, stream_in_chunks(&stream, json, strlen(json), 1, &total));
+    ASSERT_STR("a\xc3\xa9\xf0\x9f\x98\x80\n", out.str);
+    ASSERT_EQUAL(2, out.arr[1]);
+    ASSERT_TRUE(out.matrix[0][0] == 5.0f);
+}
+
+CTEST(stream, test_json_top_level_number) {
+    int value = 0;
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, (Type_Any){&value, &typeinfo_int.base}, NULL, 0);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_NEED_MORE, ti_stream_feed(&stream, " -12", 4, NULL));
+    ASSERT_EQUAL(TYPE_INFO_STREAM_NEED_MORE, ti_stream_feed(&stream, "34", 2, NULL));
+    ASSERT_EQUAL(TYPE_INFO_STREAM_DONE, ti_stream_feed(&stream, NULL, 0, NULL));
+    ASSERT_EQUAL(-1234, value);
+}
+
+CTEST(stream, test_json_errors) {
+    const char* invalid[] = {
+        "{\"x\":1,}", "{\"x\" 1}", "{\"x\":1]", "[1]", "{\"x\":\"1\"}", "{\"x\":99999999999}",
+    };
+    for(size_t i = 0; i < sizeof(invalid) / sizeof(*invalid); i++) {
+        Point out;
+        Type_Info_Stream_Frame frames[TI_MAX_DEPTH_Point];
+        Type_Info_Stream stream;
+        ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, Point), frames, 1);
+        ASSERT_EQUAL(TYPE_INFO_STREAM_ERROR,
+                     ti_stream_feed(&stream, invalid[i], strlen(invalid[i]), NULL));
+    }
+
+    // Truncated
+    Point out;
+    Type_Info_Stream_Frame frames[TI_MAX_DEPTH_Point];
+    Type_Info_Stream stream;
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, Point), frames, 1);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_NEED_MORE, ti_stream_feed(&stream, "{\"x\":1", 6, NULL));
+    ASSERT_EQUAL(TYPE_INFO_STREAM_ERROR, ti_stream_feed(&stream, NULL, 0, NULL));
+
+    // Not enough frames
+    ti_stream_init(&stream, TYPE_INFO_STREAM_JSON, type_any(&out, Point), frames, 0);
+    ASSERT_EQUAL(TYPE_INFO_STREAM_ERROR, ti_stream_feed(&stream, "{}", 2, NULL));
+}
+
 // ==============================================================================
 // Size and Alignment Tests
 // ==============================================================================
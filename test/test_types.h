@@ -29,6 +29,12 @@ typedef struct TI_ROOT {
     int* const ptr_const;
 } TestPointers;
 
+typedef struct TI_ROOT {
+    int id;
+    void (*callback)(int);
+    int (*handlers[2])(void);
+} TestCallbacks;
+
 typedef struct TI_ROOT {
     int arr[10];
     char str[256] TI_ANN(CStr);
@@ -40,6 +46,12 @@ typedef struct TI_ANN(StructAnnotation) {
     int y TI_ANN(YCoord);
 } Point;
 
+// Same layout as `Point`
+typedef struct TI_ROOT {
+    int x;
+    int y;
+} TestPointCopy;
+
 typedef struct TI_ROOT {
     Point point;
     Point* point_ptr;
@@ -102,4 +114,124 @@ typedef struct TI_ROOT {
     void* void_ptr;
 } TestVoidPtr;
 
+typedef struct TI_ROOT {
+    int before;
+    struct {
+        char pad;
+        union {
+            int deep_int;
+            float deep_float;
+        };
+    };
+    int after;
+} TestDeepAnonymous;
+
+typedef enum TI_ROOT {
+    SPARSE_NEGATIVE = -100,
+    SPARSE_ONE = 1,
+    SPARSE_ALIAS = 1,
+    SPARSE_THOUSAND = 1000,
+    SPARSE_BIG = 1 << 20,
+} TestSparseEnum;
+
+typedef enum TI_ROOT {
+    DENSE_MINUS_TWO = -2,
+    DENSE_ZERO = 0,
+    DENSE_ONE,
+    DENSE_TWO,
+} TestDenseEnum;
+
+typedef struct TI_ROOT {
+    int count;
+    int items[];
+} TestFlexible;
+
+typedef struct {
+    char tag;
+    int value;
+    int* ptr;
+} TestSerializeElement;
+
+typedef struct TI_ROOT {
+    char c;
+    short s;
+    TestSerializeElement elements[3];
+    double d;
+    short grid[2][3];
+    Status status;
+    TestUnion u;
+    const char* name TI_ANN(CStr);
+} TestSerialize;
+
+typedef struct TI_ROOT TestNode {
+    int value;
+    struct TestNode* next;
+    const char* label TI_ANN(CStr);
+} TestNode;
+
+// Two versions of a stored record, for schema migration
+typedef struct TI_ROOT {
+    int32_t id;
+    float score;
+    short delta;
+    uint8_t flags;
+    char name[8];
+    Point position;
+    float samples[3];
+    Status status;
+} TestRecordV1;
+
+typedef struct TI_ROOT {
+    int64_t id;
+    char name[12];
+    Point position;
+    double score;
+    int32_t delta;
+    uint32_t added;
+    double samples[4];
+    double status;
+} TestRecordV2;
+
+typedef struct TI_ROOT {
+    unsigned flags : 3;
+    int delta : 5;
+    unsigned : 0;
+    unsigned wide : 20;
+    Status status : 2;
+    char tag;
+    uint64_t big : 40;
+} TestBitfields;
+
+// `TestBitfields` without bitfields, for migrations
+typedef struct TI_ROOT {
+    uint8_t flags;
+    int delta;
+    uint32_t wide;
+    Status status;
+    char tag;
+    uint64_t big;
+} TestBitfieldsUnpacked;
+
+typedef float TestVec4f __attribute__((vector_size(16)));
+typedef int32_t TestVec4i __attribute__((vector_size(16)));
+
+typedef struct TI_ROOT {
+    TestVec4f position;
+    TestVec4i indices;
+    uint8_t id;
+} TestVectors;
+
+// Grows when generated with TEST_TYPES_VARIANT, see test_variant.c
+typedef struct TestPayload {
+    int value;
+#ifdef TEST_TYPES_VARIANT
+    int extra;
+#endif
+} TestPayload;
+
+typedef struct TI_ROOT {
+    int id;
+    TestPayload* payload;
+} TestHolder;
+
 #endif  // TEST_TYPES_H_
@@ -0,0 +1,10 @@
+// Fingerprints of test_types.h generated a second time, from the test directory rather than the
+// root of the repository and with TEST_TYPES_VARIANT defined. Only its header is used.
+#include <stdint.h>
+
+#include "test_types_variant_typeinfo.h"
+
+const uint64_t variant_fingerprints[] = {
+    TI_FINGERPRINT_TestAnonymous, TI_FINGERPRINT_TestNested,  TI_FINGERPRINT_TestComplex,
+    TI_FINGERPRINT_TestDeepAnonymous, TI_FINGERPRINT_TestHolder,
+};
@@ -3,6 +3,7 @@
 #include <clang-c/Index.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,6 +14,8 @@
 #define TYPE_INFO_ANNOTATION "__TypeInfoRoot"
 #define RUNNING_METAPROGRAM  "-DRUNNING_TYPEINFO_METAPROGRAM"
 #define INDENT               2
+#define MAX_ANNOTATION_IDS   64  // Bits in `Type_Info_Annotation_Set`
+#define ANNOTATION_CSTR      "CStr"  // ID 0, must match `TYPE_INFO_ANNOTATION_CSTR` in typeinfo.h
 
 #define shift(argc, argv) ((argc)--, *(argv)++)
 #define ctx_indent(ctx)   defer_loop((ctx)->indent += INDENT, (ctx)->indent -= INDENT)
@@ -21,6 +24,9 @@ typedef struct {
     const char* out;
     bool recursive;
     bool no_builtin_types;
+    bool emit_serializers;
+    const char* registry;
+    const char* annotation_prefix;
     char** files;
     int count;
     Array(char*) forwarded;
@@ -32,6 +38,19 @@ typedef struct {
     void* allocator;
 } Annotations;
 
+typedef struct {
+    char* key;
+    uint32_t value;
+} Annotation_Id_Entry;
+
+// Interned annotation strings, mapped to their ID
+typedef struct {
+    Annotation_Id_Entry* entries;
+    size_t* hashes;
+    size_t size, capacity;
+    void* allocator;
+} Annotation_Ids;
+
 typedef struct {
     char* key;
     bool value;
@@ -50,12 +69,160 @@ typedef struct {
     void* allocator;
 } Type_Queue;
 
+typedef struct {
+    char* name;
+    long long value;
+} Enum_Value;
+
+typedef struct {
+    Enum_Value* items;
+    size_t size, capacity;
+    void* allocator;
+} Enum_Values;
+
+typedef struct {
+    char* name;
+    uint32_t position;
+} Member_Name;
+
+typedef struct {
+    Member_Name* items;
+    size_t size, capacity;
+    void* allocator;
+} Member_Names;
+
+typedef struct {
+    Member_Names* names;
+    uint32_t count;          // Members of the indexed record visited so far
+    int64_t anonymous_owner; // Anonymous member of the indexed record being flattened, or -1
+} Member_Name_Collector;
+
+// Perfect hash table, see `Type_Info_Hash_Index` in typeinfo.h
+typedef struct {
+    uint32_t* seeds;
+    uint32_t* slots;
+    uint32_t size;  // 0 if the index is empty
+} Hash_Index;
+
+typedef struct {
+    char* name;
+} Registered_Type;
+
+typedef struct {
+    Registered_Type* items;
+    size_t size, capacity;
+    void* allocator;
+} Registered_Types;
+
+typedef enum {
+    SERIALIZER_COPY,  // Copy `size` bytes between the value and the serialized data
+    SERIALIZER_ZERO,  // Zero `size` bytes of the value when deserializing (pointers)
+    SERIALIZER_LOOP,  // Run `body` for each of the `count` elements of an array
+    SERIALIZER_BITS,  // Copy `size` bytes of bitfields, clearing the bits not in `mask`
+} Serializer_Op_Kind;
+
+typedef struct Serializer_Op Serializer_Op;
+
+typedef struct {
+    Serializer_Op* items;
+    size_t size, capacity;
+    void* allocator;
+} Serializer_Ops;
+
+struct Serializer_Op {
+    Serializer_Op_Kind kind;
+    long long value_offset;
+    long long data_offset;
+    long long size;    // For loops, the serialized size of an element
+    long long count;   // Loops only
+    long long stride;  // Loops only, the size of an element in the value
+    Serializer_Ops body;  // Loops only, offsets are relative to the element
+    uint64_t mask;        // Bits only: bit `i` keeps bit `i % 8` of byte `i / 8`
+};
+
+typedef struct {
+    Serializer_Ops* ops;
+    long long value_offset;
+    long long* data_offset;
+    bool ok;
+} Serializer_Fields;
+
+typedef struct {
+    long long offset;
+    long long size;
+} Byte_Range;
+
+typedef struct {
+    Byte_Range* items;
+    size_t size, capacity;
+    void* allocator;
+} Byte_Ranges;
+
+typedef struct {
+    Byte_Ranges* ranges;
+    long long offset;
+} Range_Fields;
+
+typedef struct {
+    long long offset;
+    bool is_cstr;
+    CXType pointee;
+} Pointer_Slot;
+
+typedef struct {
+    Pointer_Slot* items;
+    size_t size, capacity;
+    void* allocator;
+} Pointer_Slots;
+
+typedef struct {
+    Pointer_Slots* slots;
+    long long offset;
+} Pointer_Fields;
+
+typedef struct {
+    long long offset;
+    long long bit_offset;
+    long long bit_width;  // 0 if not a bitfield
+    const char* name;
+    CXType type;
+} Leaf;
+
+typedef struct {
+    Leaf* items;
+    size_t size, capacity;
+    void* allocator;
+} Leaves;
+
+typedef struct {
+    Leaves* leaves;
+    long long offset;
+    const char* prefix;  // Path of the record, "" for the root
+} Leaf_Fields;
+
+typedef struct {
+    char* key;       // See `derived_type_key`
+    uint32_t value;  // Number in the name of its instance
+} Derived_Type_Entry;
+
+// Pointers, arrays, vectors and anonymous records and enums defined so far, by key
+typedef struct {
+    Derived_Type_Entry* entries;
+    size_t* hashes;
+    size_t size, capacity;
+    void* allocator;
+} Derived_Types;
+
 typedef struct {
     FILE* header;
     FILE* source;
     int indent;
     Visited_Types* visited_types;
+    Derived_Types* derived_types;
     Type_Queue* pending_types;
+    Registered_Types* registered_types;
+    Annotation_Ids* annotation_ids;
+    Annotations* annotation_constants;  // Name of the enum constant of each annotation ID
 } Type_Info_Context;
 
 static Opts opts;
@@ -119,6 +286,481 @@ static void emit_qualifier_flags(FILE* out, CXType type) {
     }
 }
 
+// Unnamed bitfields (e.g. `int : 3`) only pad the record: they are not emitted as members
+static bool is_unnamed_bitfield(CXCursor c) {
+    if(!clang_Cursor_isBitField(c)) return false;
+    CXString spelling = clang_getCursorSpelling(c);
+    bool unnamed = clang_getCString(spelling)[0] == '\0';
+    clang_disposeString(spelling);
+    return unnamed;
+}
+
+// Must match `Type_Info_Trait` in typeinfo.h
+enum {
+    TRAIT_HAS_POINTERS = 1 << 0,
+    TRAIT_HAS_PADDING = 1 << 1,
+    TRAIT_HAS_FLOATS = 1 << 2,
+    TRAIT_TRIVIALLY_COMPARABLE = 1 << 3,
+    TRAIT_IS_POD = 1 << 4,
+    TRAIT_HAS_FLEXIBLE_ARRAY = 1 << 5,
+    TRAIT_HAS_UNIONS = 1 << 6,
+    TRAIT_HAS_CONST = 1 << 7,
+    TRAIT_HAS_BITFIELDS = 1 << 8,
+};
+
+// Traits of a type that don't simply propagate to the types containing it
+#define DERIVED_TRAITS (TRAIT_TRIVIALLY_COMPARABLE | TRAIT_IS_POD)
+
+static const char* trait_names[] = {
+    "TYPE_INFO_TRAIT_HAS_POINTERS",
+    "TYPE_INFO_TRAIT_HAS_PADDING",
+    "TYPE_INFO_TRAIT_HAS_FLOATS",
+    "TYPE_INFO_TRAIT_TRIVIALLY_COMPARABLE",
+    "TYPE_INFO_TRAIT_IS_POD",
+    "TYPE_INFO_TRAIT_HAS_FLEXIBLE_ARRAY",
+    "TYPE_INFO_TRAIT_HAS_UNIONS",
+    "TYPE_INFO_TRAIT_HAS_CONST",
+    "TYPE_INFO_TRAIT_HAS_BITFIELDS",
+};
+
+typedef struct {
+    unsigned traits;
+    bool all_trivially_comparable;
+    bool has_gaps;  // Bytes not covered by any field
+    long long end_bits;  // End of the fields visited so far
+} Field_Traits;
+
+static unsigned type_traits(CXType type);
+
+static enum CXVisitorResult collect_field_traits(CXCursor c, CXClientData data) {
+    Field_Traits* f = data;
+    if(is_unnamed_bitfield(c)) return CXVisit_Continue;  // Counted as padding
+    CXType type = clang_getCursorType(c);
+    unsigned traits = type_traits(type);
+    if(clang_Cursor_isBitField(c)) f->traits |= TRAIT_HAS_BITFIELDS;
+    f->traits |= traits & ~DERIVED_TRAITS;
+    if(clang_isConstQualifiedType(type)) f->traits |= TRAIT_HAS_CONST;
+    if(!(traits & TRAIT_TRIVIALLY_COMPARABLE)) f->all_trivially_comparable = false;
+
+    long long start = clang_Cursor_getOffsetOfField(c);
+    long long width = clang_Cursor_isBitField(c) ? clang_getFieldDeclBitWidth(c)
+                                                 : clang_Type_getSizeOf(type) * 8;
+    if(start < 0 || width < 0) {  // Flexible array member
+        return CXVisit_Continue;
+    }
+    if(start > f->end_bits) f->has_gaps = true;
+    if(start + width > f->end_bits) f->end_bits = start + width;
+    return CXVisit_Continue;
+}
+
+static unsigned own_traits(CXType type) {
+    switch(type.kind) {
+    case CXType_Float:
+    case CXType_Double:
+    case CXType_LongDouble:
+        return TRAIT_HAS_FLOATS;
+    case CXType_Pointer:
+        return TRAIT_HAS_POINTERS;
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray: {
+        CXType elem = clang_getElementType(type);
+        unsigned traits = type_traits(elem);
+        if(clang_isConstQualifiedType(elem)) traits |= TRAIT_HAS_CONST;
+        if(type.kind == CXType_IncompleteArray) traits |= TRAIT_HAS_FLEXIBLE_ARRAY;
+        return traits & ~TRAIT_IS_POD;  // Recomputed by `type_traits`
+    }
+    case CXType_Vector:
+    case CXType_ExtVector: {
+        CXType lane = clang_getElementType(type);
+        unsigned traits = type_traits(lane) & ~TRAIT_IS_POD;
+        long long lanes_size = clang_getNumElements(type) * clang_Type_getSizeOf(lane);
+        if(lanes_size < clang_Type_getSizeOf(type)) {  // 3 lanes padded to 4
+            traits = (traits | TRAIT_HAS_PADDING) & ~TRAIT_TRIVIALLY_COMPARABLE;
+        }
+        return traits;
+    }
+    case CXType_Record: {
+        Field_Traits f = {.all_trivially_comparable = true};
+        clang_Type_visitFields(type, collect_field_traits, &f);
+        if(f.end_bits < clang_Type_getSizeOf(type) * 8) f.has_gaps = true;
+        unsigned traits = f.traits | (f.has_gaps ? TRAIT_HAS_PADDING : 0);
+        if(clang_getCursorKind(clang_getTypeDeclaration(type)) == CXCursor_UnionDecl) {
+            traits |= TRAIT_HAS_UNIONS;
+        }
+        if(!f.has_gaps && f.all_trivially_comparable) traits |= TRAIT_TRIVIALLY_COMPARABLE;
+        return traits;
+    }
+    case CXType_Enum:
+    case CXType_Void:
+        return TRAIT_TRIVIALLY_COMPARABLE;
+    default:  // Integers
+        return builtin_symbol(type.kind) ? TRAIT_TRIVIALLY_COMPARABLE : 0;
+    }
+}
+
+// Computes the `Type_Info_Trait`s of a type, transitively over its fields and elements. See
+// typeinfo.h
+static unsigned type_traits(CXType type) {
+    type = clang_getCanonicalType(type);
+    unsigned traits = own_traits(type);
+    if(!(traits & (TRAIT_HAS_POINTERS | TRAIT_HAS_FLEXIBLE_ARRAY))) traits |= TRAIT_IS_POD;
+    return traits;
+}
+
+// Appends a range, merging it with the previous one when they touch or overlap
+static void push_byte_range(Byte_Ranges* ranges, long long offset, long long size) {
+    if(ranges->size > 0) {
+        Byte_Range* last = &ranges->items[ranges->size - 1];
+        if(offset >= last->offset && offset <= last->offset + last->size) {
+            if(offset + size > last->offset + last->size) last->size = offset + size - last->offset;
+            return;
+        }
+    }
+    array_push(ranges, ((Byte_Range){offset, size}));
+}
+
+static int compare_byte_ranges(const void* a, const void* b) {
+    long long oa = ((const Byte_Range*)a)->offset, ob = ((const Byte_Range*)b)->offset;
+    return (oa > ob) - (oa < ob);
+}
+
+static void collect_byte_ranges(CXType type, long long offset, Byte_Ranges* ranges);
+
+static enum CXVisitorResult collect_field_ranges(CXCursor c, CXClientData data) {
+    Range_Fields* f = data;
+    long long offset_bits = clang_Cursor_getOffsetOfField(c);
+    if(offset_bits < 0 || is_unnamed_bitfield(c)) return CXVisit_Continue;
+    if(clang_Cursor_isBitField(c)) {
+        long long width = clang_getFieldDeclBitWidth(c);
+        if(width > 0) {
+            push_byte_range(f->ranges, f->offset + offset_bits / 8, (offset_bits % 8 + width + 7) / 8);
+        }
+    } else {
+        collect_byte_ranges(clang_getCursorType(c), f->offset + offset_bits / 8, f->ranges);
+    }
+    return CXVisit_Continue;
+}
+
+// Collects the bytes of a type holding data, i.e. not padding, as sorted and merged ranges.
+// Allocates from the allocator of `ranges`.
+static void collect_byte_ranges(CXType type, long long offset, Byte_Ranges* ranges) {
+    type = clang_getCanonicalType(type);
+    switch(type.kind) {
+    case CXType_IncompleteArray:
+        break;
+    case CXType_ConstantArray:
+    case CXType_Vector:
+    case CXType_ExtVector: {  // Padding lanes of vectors are past `count`
+        CXType elem = clang_getElementType(type);
+        long long count = clang_getNumElements(type);
+        long long stride = clang_Type_getSizeOf(elem);
+        Byte_Ranges elem_ranges = {.allocator = ranges->allocator};
+        collect_byte_ranges(elem, 0, &elem_ranges);
+        if(elem_ranges.size == 1 && elem_ranges.items[0].size == stride) {
+            push_byte_range(ranges, offset, count * stride);
+            break;
+        }
+        for(long long i = 0; i < count; i++) {
+            array_foreach(const Byte_Range, r, &elem_ranges) {
+                push_byte_range(ranges, offset + i * stride + r->offset, r->size);
+            }
+        }
+    } break;
+    case CXType_Record: {
+        size_t start = ranges->size;
+        Range_Fields f = {ranges, offset};
+        clang_Type_visitFields(type, collect_field_ranges, &f);
+        if(clang_getCursorKind(clang_getTypeDeclaration(type)) == CXCursor_UnionDecl) {
+            // Members overlap: sort and merge them again
+            size_t count = ranges->size - start;
+            Byte_Range* items = temp_alloc(count * sizeof(Byte_Range));
+            memcpy(items, ranges->items + start, count * sizeof(Byte_Range));
+            qsort(items, count, sizeof(Byte_Range), compare_byte_ranges);
+            ranges->size = start;
+            for(size_t i = 0; i < count; i++) push_byte_range(ranges, items[i].offset, items[i].size);
+        }
+    } break;
+    default: {
+        long long size = clang_Type_getSizeOf(type);
+        if(size > 0) push_byte_range(ranges, offset, size);
+    } break;
+    }
+}
+
+// Emits the `data_ranges` and `data_ranges_count` of a struct or union
+static void emit_byte_ranges(FILE* out, CXType type) {
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Byte_Ranges ranges = {.allocator = &temp_allocator};
+        collect_byte_ranges(type, 0, &ranges);
+        if(ranges.size == 0) {
+            fprintf(out, "NULL, 0");
+        } else {
+            fprintf(out, "(Type_Info_Byte_Range[]){");
+            array_foreach(const Byte_Range, r, &ranges) {
+                fprintf(out, "%s{%lld, %lld}", r == ranges.items ? "" : ", ", r->offset, r->size);
+            }
+            fprintf(out, "}, %zu", ranges.size);
+        }
+    }
+}
+
+static bool has_annotation(CXCursor c, const char* annotation);
+
+static void collect_pointer_slots(CXType type, long long offset, bool is_cstr,
+                                  Pointer_Slots* slots);
+
+static enum CXVisitorResult collect_field_pointers(CXCursor c, CXClientData data) {
+    Pointer_Fields* f = data;
+    long long offset_bits = clang_Cursor_getOffsetOfField(c);
+    if(offset_bits < 0 || clang_Cursor_isBitField(c)) return CXVisit_Continue;
+    collect_pointer_slots(clang_getCursorType(c), f->offset + offset_bits / 8,
+                          has_annotation(c, "CStr"), f->slots);
+    return CXVisit_Continue;
+}
+
+// Collects the pointers of a type by increasing offset, seeing through structs and fixed size
+// arrays. Pointers in unions are left out, as their active member is not known, and so are
+// pointers to functions, which have no type info to point to.
+static void collect_pointer_slots(CXType type, long long offset, bool is_cstr,
+                                  Pointer_Slots* slots) {
+    type = clang_getCanonicalType(type);
+    switch(type.kind) {
+    case CXType_Pointer: {
+        CXType pointee = clang_getCanonicalType(clang_getPointeeType(type));
+        if(pointee.kind == CXType_FunctionProto || pointee.kind == CXType_FunctionNoProto) break;
+        is_cstr = is_cstr && clang_Type_getSizeOf(pointee) == 1 && builtin_symbol(pointee.kind);
+        array_push(slots, ((Pointer_Slot){offset, is_cstr, clang_getPointeeType(type)}));
+    } break;
+    case CXType_ConstantArray: {
+        CXType elem = clang_getElementType(type);
+        long long count = clang_getNumElements(type);
+        long long stride = clang_Type_getSizeOf(elem);
+        Pointer_Slots elem_slots = {.allocator = slots->allocator};
+        collect_pointer_slots(elem, 0, false, &elem_slots);
+        for(long long i = 0; i < count && elem_slots.size > 0; i++) {
+            array_foreach(const Pointer_Slot, slot, &elem_slots) {
+                array_push(slots, ((Pointer_Slot){offset + i * stride + slot->offset,
+                                                  slot->is_cstr, slot->pointee}));
+            }
+        }
+    } break;
+    case CXType_Record:
+        if(clang_getCursorKind(clang_getTypeDeclaration(type)) != CXCursor_UnionDecl) {
+            Pointer_Fields f = {slots, offset};
+            clang_Type_visitFields(type, collect_field_pointers, &f);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+static void collect_leaves(CXType type, long long offset, const char* name, Leaves* leaves);
+
+static enum CXVisitorResult collect_field_leaves(CXCursor c, CXClientData data) {
+    Leaf_Fields* f = data;
+    long long offset_bits = clang_Cursor_getOffsetOfField(c);
+    if(offset_bits < 0 || is_unnamed_bitfield(c)) return CXVisit_Continue;
+
+    // Members of anonymous records are named as if they were members of the enclosing one
+    CXString spelling = clang_getCursorSpelling(c);
+    const char* field_name = clang_getCString(spelling);
+    const char* name = f->prefix;
+    if(!strchr(field_name, '(') && field_name[0] != '\0') {
+        name = f->prefix[0] ? temp_sprintf("%s.%s", f->prefix, field_name) : temp_strdup(field_name);
+    }
+    clang_disposeString(spelling);
+
+    if(clang_Cursor_isBitField(c)) {
+        Leaf leaf = {f->offset + offset_bits / 8, offset_bits % 8, clang_getFieldDeclBitWidth(c),
+                     name, clang_getCursorType(c)};
+        array_push(f->leaves, leaf);
+    } else {
+        collect_leaves(clang_getCursorType(c), f->offset + offset_bits / 8, name, f->leaves);
+    }
+    return CXVisit_Continue;
+}
+
+// Collects the scalars of a type, seeing through structs and fixed size arrays, named by their
+// path as accepted by `ti_path_compile`. Allocates from the temporary allocator.
+static void collect_leaves(CXType type, long long offset, const char* name, Leaves* leaves) {
+    type = clang_getCanonicalType(type);
+    switch(type.kind) {
+    case CXType_ConstantArray: {
+        CXType elem = clang_getElementType(type);
+        long long count = clang_getNumElements(type);
+        long long stride = clang_Type_getSizeOf(elem);
+        for(long long i = 0; i < count; i++) {
+            collect_leaves(elem, offset + i * stride, temp_sprintf("%s[%lld]", name, i), leaves);
+        }
+    } break;
+    case CXType_Record:
+        if(clang_getCursorKind(clang_getTypeDeclaration(type)) != CXCursor_UnionDecl) {
+            Leaf_Fields f = {leaves, offset, name};
+            clang_Type_visitFields(type, collect_field_leaves, &f);
+        }
+        break;
+    case CXType_Enum:
+    case CXType_Vector:
+    case CXType_ExtVector:
+        array_push(leaves, ((Leaf){offset, 0, 0, name, type}));
+        break;
+    default:
+        if(type.kind != CXType_Void && builtin_symbol(type.kind)) {
+            array_push(leaves, ((Leaf){offset, 0, 0, name, type}));
+        }
+        break;
+    }
+}
+
+static void emit_trait_flags(FILE* out, unsigned traits) {
+    if(traits == 0) {
+        fprintf(out, "TYPE_INFO_TRAIT_NONE");
+        return;
+    }
+    bool first = true;
+    for(size_t i = 0; i < sizeof(trait_names) / sizeof(*trait_names); i++) {
+        if(!(traits & (1u << i))) continue;
+        fprintf(out, first ? "%s" : " | %s", trait_names[i]);
+        first = false;
+    }
+}
+
+// FNV-1a. Must match `ti_hash_bytes` in typeinfo.h
+static uint64_t hash_bytes(const void* data, size_t len) {
+    const unsigned char* bytes = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for(size_t i = 0; i < len; i++) {
+        h ^= bytes[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+// splitmix64 finalizer. Must match `ti_hash_mix` in typeinfo.h
+static uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+#define HASH_INDEX_EMPTY     UINT32_MAX
+#define HASH_INDEX_MAX_SEEDS (1u << 16)
+
+// Hash and displace: keys are grouped in buckets by `h & mask`, and buckets are placed largest
+// first by searching a seed that sends all of their keys to free slots.
+static bool try_build_hash_index(const uint64_t* hashes, const uint32_t* positions, size_t count,
+                                 uint32_t size, Hash_Index* index) {
+    uint32_t mask = size - 1;
+    uint32_t* bucket_sizes = temp_alloc(size * sizeof(uint32_t));
+    uint32_t* bucket_order = temp_alloc(size * sizeof(uint32_t));
+    uint32_t* bucket_keys = temp_alloc(count * sizeof(uint32_t));
+    uint32_t* bucket_start = temp_alloc((size + 1) * sizeof(uint32_t));
+    uint32_t* taken = temp_alloc(count * sizeof(uint32_t));
+    memset(bucket_sizes, 0, size * sizeof(uint32_t));
+
+    for(size_t i = 0; i < count; i++) bucket_sizes[hashes[i] & mask]++;
+
+    bucket_start[0] = 0;
+    for(uint32_t b = 0; b < size; b++) bucket_start[b + 1] = bucket_start[b] + bucket_sizes[b];
+    memset(bucket_sizes, 0, size * sizeof(uint32_t));
+    for(size_t i = 0; i < count; i++) {
+        uint32_t b = hashes[i] & mask;
+        bucket_keys[bucket_start[b] + bucket_sizes[b]++] = (uint32_t)i;
+    }
+
+    // Order buckets by decreasing size, they hold only a handful of keys each
+    uint32_t max_bucket = 0;
+    for(uint32_t b = 0; b < size; b++) {
+        if(bucket_sizes[b] > max_bucket) max_bucket = bucket_sizes[b];
+    }
+    uint32_t ordered = 0;
+    for(uint32_t n = max_bucket; n > 0; n--) {
+        for(uint32_t b = 0; b < size; b++) {
+            if(bucket_sizes[b] == n) bucket_order[ordered++] = b;
+        }
+    }
+
+    index->size = size;
+    index->seeds = temp_alloc(size * sizeof(uint32_t));
+    index->slots = temp_alloc(size * sizeof(uint32_t));
+    memset(index->seeds, 0, size * sizeof(uint32_t));
+    for(uint32_t i = 0; i < size; i++) index->slots[i] = HASH_INDEX_EMPTY;
+
+    for(uint32_t o = 0; o < ordered; o++) {
+        uint32_t b = bucket_order[o];
+        uint32_t n = bucket_sizes[b];
+
+        bool placed = false;
+        for(uint32_t seed = 0; seed < HASH_INDEX_MAX_SEEDS && !placed; seed++) {
+            uint32_t k = 0;
+            for(; k < n; k++) {
+                uint32_t key = bucket_keys[bucket_start[b] + k];
+                uint32_t slot = hash_mix(hashes[key] ^ seed) & mask;
+                if(index->slots[slot] != HASH_INDEX_EMPTY) break;
+                index->slots[slot] = positions[key];
+                taken[k] = slot;
+            }
+            if(k == n) {
+                index->seeds[b] = seed;
+                placed = true;
+            } else {
+                while(k-- > 0) index->slots[taken[k]] = HASH_INDEX_EMPTY;
+            }
+        }
+
+        if(!placed) return false;
+    }
+
+    return true;
+}
+
+// Builds a perfect hash index mapping `hashes[i]` to `positions[i]`. Hashes must be unique.
+// Returns false if no index could be built, in which case the runtime falls back to linear scans.
+// Allocates in the temp allocator.
+static bool build_hash_index(const uint64_t* hashes, const uint32_t* positions, size_t count,
+                             Hash_Index* index) {
+    *index = (Hash_Index){0};
+    if(count == 0) return true;
+
+    uint32_t size = 1;
+    while(size < count) size <<= 1;
+
+    for(int attempt = 0; attempt < 4; attempt++, size <<= 1) {
+        void* checkpoint = temp_checkpoint();
+        if(try_build_hash_index(hashes, positions, count, size, index)) return true;
+        temp_rewind(checkpoint);
+    }
+
+    *index = (Hash_Index){0};
+    return false;
+}
+
+static void emit_index_array(FILE* out, const uint32_t* items, size_t count) {
+    fprintf(out, "(uint32_t[]){ ");
+    for(size_t i = 0; i < count; i++) {
+        if(items[i] == HASH_INDEX_EMPTY) fprintf(out, "TYPE_INFO_INDEX_EMPTY, ");
+        else fprintf(out, "%u, ", items[i]);
+    }
+    fprintf(out, "}");
+}
+
+static void emit_hash_index(FILE* out, const Hash_Index* index) {
+    if(index->size == 0) {
+        fprintf(out, "{ NULL, NULL, 0 }");
+        return;
+    }
+    fprintf(out, "{ ");
+    emit_index_array(out, index->seeds, index->size);
+    fprintf(out, ", ");
+    emit_index_array(out, index->slots, index->size);
+    fprintf(out, ", %u }", index->size - 1);
+}
+
 static void emit_builtin_decls(FILE* header) {
     fprintf(header,
             "extern Type_Info_Void typeinfo_void;\n"
@@ -140,38 +782,43 @@ static void emit_builtin_decls(FILE* header) {
 }
 
 static void emit_builtin_defs(FILE* source) {
-    fprintf(source,
-            "Type_Info_Void typeinfo_void = {{ TYPE_TAG_VOID, 0, 0 }};\n"
-            "Type_Info_Integer typeinfo_bool = {{ TYPE_TAG_INTEGER, sizeof(_Bool), "
-            "TYPEINFO_ALIGNOF(_Bool) }, 0};\n"
-            "Type_Info_Integer typeinfo_char = {{ TYPE_TAG_INTEGER, sizeof(char), "
-            "TYPEINFO_ALIGNOF(char) }, (char)-1 < 0};\n"
-            "Type_Info_Integer typeinfo_signed_char = {{ TYPE_TAG_INTEGER, sizeof(signed char), "
-            "TYPEINFO_ALIGNOF(signed char) }, 1};\n"
-            "Type_Info_Integer typeinfo_unsigned_char = {{ TYPE_TAG_INTEGER, sizeof(unsigned "
-            "char), TYPEINFO_ALIGNOF(unsigned char) }, 0};\n"
-            "Type_Info_Integer typeinfo_short = {{ TYPE_TAG_INTEGER, sizeof(short), "
-            "TYPEINFO_ALIGNOF(short) }, 1};\n"
-            "Type_Info_Integer typeinfo_unsigned_short = {{ TYPE_TAG_INTEGER, sizeof(unsigned "
-            "short), TYPEINFO_ALIGNOF(unsigned short) }, 0};\n"
-            "Type_Info_Integer typeinfo_int = {{ TYPE_TAG_INTEGER, sizeof(int), "
-            "TYPEINFO_ALIGNOF(int) }, 1};\n"
-            "Type_Info_Integer typeinfo_unsigned_int = {{ TYPE_TAG_INTEGER, sizeof(unsigned int), "
-            "TYPEINFO_ALIGNOF(unsigned int) }, 0};\n"
-            "Type_Info_Integer typeinfo_long = {{ TYPE_TAG_INTEGER, sizeof(long), "
-            "TYPEINFO_ALIGNOF(long) }, 1};\n"
-            "Type_Info_Integer typeinfo_unsigned_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned "
-            "long), TYPEINFO_ALIGNOF(unsigned long) }, 0};\n"
-            "Type_Info_Integer typeinfo_long_long = {{ TYPE_TAG_INTEGER, sizeof(long long), "
-            "TYPEINFO_ALIGNOF(long long) }, 1};\n"
-            "Type_Info_Integer typeinfo_unsigned_long_long = {{ TYPE_TAG_INTEGER, sizeof(unsigned "
-            "long long), TYPEINFO_ALIGNOF(unsigned long long) }, 0};\n"
-            "Type_Info_Float typeinfo_float = {{ TYPE_TAG_FLOAT, sizeof(float), "
-            "TYPEINFO_ALIGNOF(float) }};\n"
-            "Type_Info_Float typeinfo_double = {{ TYPE_TAG_FLOAT, sizeof(double), "
-            "TYPEINFO_ALIGNOF(double) }};\n"
-            "Type_Info_Float typeinfo_long_double = {{ TYPE_TAG_FLOAT, sizeof(long double), "
-            "TYPEINFO_ALIGNOF(long double) }};\n\n");
+    static const struct {
+        const char* symbol;
+        const char* c_type;
+        const char* is_signed;  // NULL for floats
+    } builtins[] = {
+        {"bool", "_Bool", "0"},
+        {"char", "char", "(char)-1 < 0"},
+        {"signed_char", "signed char", "1"},
+        {"unsigned_char", "unsigned char", "0"},
+        {"short", "short", "1"},
+        {"unsigned_short", "unsigned short", "0"},
+        {"int", "int", "1"},
+        {"unsigned_int", "unsigned int", "0"},
+        {"long", "long", "1"},
+        {"unsigned_long", "unsigned long", "0"},
+        {"long_long", "long long", "1"},
+        {"unsigned_long_long", "unsigned long long", "0"},
+        {"float", "float", NULL},
+        {"double", "double", NULL},
+        {"long_double", "long double", NULL},
+    };
+
+    fprintf(source, "Type_Info_Void typeinfo_void = {{ TYPE_TAG_VOID, 0, 0, ");
+    emit_trait_flags(source, TRAIT_TRIVIALLY_COMPARABLE | TRAIT_IS_POD);
+    fprintf(source, " }};\n");
+    for(size_t i = 0; i < sizeof(builtins) / sizeof(*builtins); i++) {
+        bool is_float = builtins[i].is_signed == NULL;
+        fprintf(source, "%s typeinfo_%s = {{ %s, sizeof(%s), TYPEINFO_ALIGNOF(%s), ",
+                is_float ? "Type_Info_Float" : "Type_Info_Integer", builtins[i].symbol,
+                is_float ? "TYPE_TAG_FLOAT" : "TYPE_TAG_INTEGER", builtins[i].c_type,
+                builtins[i].c_type);
+        emit_trait_flags(source, (is_float ? TRAIT_HAS_FLOATS : TRAIT_TRIVIALLY_COMPARABLE) |
+                                     TRAIT_IS_POD);
+        if(is_float) fprintf(source, " }};\n");
+        else fprintf(source, " }, %s};\n", builtins[i].is_signed);
+    }
+    fprintf(source, "\n");
 }
 
 static void emit_indentation(FILE* out, int indent) {
@@ -236,8 +883,7 @@ static enum CXChildVisitResult count_enum_values(CXCursor c, CXCursor parent, CX
 }
 
 static enum CXVisitorResult count_fields(CXCursor c, CXClientData data) {
-    (void)c;
-    (*(int*)data)++;
+    if(!is_unnamed_bitfield(c)) (*(int*)data)++;
     return CXVisit_Continue;
 }
 
@@ -256,6 +902,19 @@ static enum CXChildVisitResult collect_annotations(CXCursor c, CXCursor parent,
     return CXChildVisit_Continue;
 }
 
+static bool has_annotation(CXCursor c, const char* annotation) {
+    bool found = false;
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Annotations annotations = {.allocator = &temp_allocator};
+        clang_visitChildren(c, collect_annotations, &annotations);
+        array_foreach(char*, it, &annotations) {
+            if(strcmp(*it, annotation) == 0) found = true;
+        }
+    }
+    return found;
+}
+
 static void emit_annotations_for_cursor(CXCursor c, FILE* out) {
     void* temp;
     defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
@@ -269,10 +928,268 @@ static void emit_annotations_for_cursor(CXCursor c, FILE* out) {
     }
 }
 
+static enum CXChildVisitResult collect_enum_values(CXCursor c, CXCursor parent,
+                                                   CXClientData client_data) {
+    (void)parent;
+    Enum_Values* out = (Enum_Values*)client_data;
+    if(clang_getCursorKind(c) == CXCursor_EnumConstantDecl) {
+        CXString name = clang_getCursorSpelling(c);
+        Enum_Value value = {temp_strdup(clang_getCString(name)), clang_getEnumConstantDeclValue(c)};
+        array_push(out, value);
+        clang_disposeString(name);
+    }
+    return CXChildVisit_Continue;
+}
+
+// Whether the underlying integer type of an enum is signed. Must match `Type_Info_Enum::is_signed`.
+static bool is_signed_enum(CXCursor decl) {
+    switch(clang_getCanonicalType(clang_getEnumDeclIntegerType(decl)).kind) {
+    case CXType_Char_S:
+    case CXType_SChar:
+    case CXType_Short:
+    case CXType_Int:
+    case CXType_Long:
+    case CXType_LongLong:
+    case CXType_Int128:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Emits the lookup fields of `Type_Info_Enum`. Enums whose values span a range at most twice as
+// large as their count get a direct table indexed by `value - min_value`, all the others a perfect
+// hash over their values. Names always get a perfect hash.
+static void emit_enum_lookup(CXCursor decl, FILE* out) {
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Enum_Values values = {.allocator = &temp_allocator};
+        clang_visitChildren(decl, collect_enum_values, &values);
+
+        long long min = values.size ? values.items[0].value : 0;
+        long long max = min;
+        array_foreach(Enum_Value, it, &values) {
+            if(it->value < min) min = it->value;
+            if(it->value > max) max = it->value;
+        }
+
+        unsigned long long range = (unsigned long long)max - (unsigned long long)min;
+        if(values.size == 0) {
+            fprintf(out, "0, NULL, 0, { NULL, NULL, 0 }");
+        } else if(range < 2 * values.size) {
+            size_t count = (size_t)range + 1;
+            uint32_t* table = temp_alloc(count * sizeof(uint32_t));
+            for(size_t i = 0; i < count; i++) table[i] = HASH_INDEX_EMPTY;
+            for(size_t i = values.size; i-- > 0;) {  // Backwards, so that first alias wins
+                table[(unsigned long long)values.items[i].value - (unsigned long long)min] =
+                    (uint32_t)i;
+            }
+
+            fprintf(out, "%lld, ", min);
+            emit_index_array(out, table, count);
+            fprintf(out, ", %zu, { NULL, NULL, 0 }", count);
+        } else {
+            uint64_t* hashes = temp_alloc(values.size * sizeof(uint64_t));
+            uint32_t* positions = temp_alloc(values.size * sizeof(uint32_t));
+            size_t unique = 0;
+            for(size_t i = 0; i < values.size; i++) {
+                bool alias = false;
+                for(size_t j = 0; j < i && !alias; j++) {
+                    alias = values.items[j].value == values.items[i].value;
+                }
+                if(alias) continue;
+                hashes[unique] = hash_mix((uint64_t)values.items[i].value);
+                positions[unique] = (uint32_t)i;
+                unique++;
+            }
+
+            Hash_Index index;
+            build_hash_index(hashes, positions, unique, &index);
+            fprintf(out, "%lld, NULL, 0, ", min);
+            emit_hash_index(out, &index);
+        }
+
+        uint64_t* name_hashes = temp_alloc((values.size + 1) * sizeof(uint64_t));
+        uint32_t* name_positions = temp_alloc((values.size + 1) * sizeof(uint32_t));
+        for(size_t i = 0; i < values.size; i++) {
+            name_hashes[i] = hash_bytes(values.items[i].name, strlen(values.items[i].name));
+            name_positions[i] = (uint32_t)i;
+        }
+
+        Hash_Index name_index;
+        build_hash_index(name_hashes, name_positions, values.size, &name_index);
+        fprintf(out, ", ");
+        emit_hash_index(out, &name_index);
+    }
+}
+
+// Collects the names of the members of a record, mapped to their position. Names reachable through
+// anonymous members are mapped to the position of the anonymous member.
+static enum CXVisitorResult collect_member_names(CXCursor c, CXClientData data) {
+    Member_Name_Collector* collector = data;
+    if(is_unnamed_bitfield(c)) return CXVisit_Continue;
+    uint32_t position = collector->anonymous_owner >= 0 ? (uint32_t)collector->anonymous_owner
+                                                        : collector->count++;
+
+    CXString spelling = clang_getCursorSpelling(c);
+    const char* name = clang_getCString(spelling);
+    if(strchr(name, '(')) name = "";  // See `member_visitor`
+
+    if(*name) {
+        Member_Name member_name = {temp_strdup(name), position};
+        array_push(collector->names, member_name);
+    } else {
+        CXType type = clang_getCanonicalType(clang_getCursorType(c));
+        if(type.kind == CXType_Record) {
+            Member_Name_Collector anonymous = {collector->names, 0, position};
+            clang_Type_visitFields(type, collect_member_names, &anonymous);
+        }
+    }
+
+    clang_disposeString(spelling);
+    return CXVisit_Continue;
+}
+
+// Emits the `member_index` of a `Type_Info_Struct` or `Type_Info_Union`
+static void emit_member_index(CXType type, FILE* out) {
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Member_Names names = {.allocator = &temp_allocator};
+        Member_Name_Collector collector = {&names, 0, -1};
+        clang_Type_visitFields(type, collect_member_names, &collector);
+
+        uint64_t* hashes = temp_alloc((names.size + 1) * sizeof(uint64_t));
+        uint32_t* positions = temp_alloc((names.size + 1) * sizeof(uint32_t));
+        for(size_t i = 0; i < names.size; i++) {
+            hashes[i] = hash_bytes(names.items[i].name, strlen(names.items[i].name));
+            positions[i] = names.items[i].position;
+        }
+
+        Hash_Index index;
+        build_hash_index(hashes, positions, names.size, &index);
+        emit_hash_index(out, &index);
+    }
+}
+
+// Returns the ID of an annotation, assigning the next free one if it was never seen before
+static uint32_t intern_annotation(Type_Info_Context* ctx, const char* annotation) {
+    Annotation_Id_Entry* interned = hmap_get_cstr(ctx->annotation_ids, (char*)annotation);
+    if(interned) return interned->value;
+
+    uint32_t id = (uint32_t)ctx->annotation_ids->size;
+    hmap_put_cstr(ctx->annotation_ids, ext_strdup(annotation), id);
+
+    // Annotations are arbitrary strings, turn them into a valid and unique identifier
+    StringBuffer constant = {0};
+    sb_append_cstr(&constant, opts.annotation_prefix);
+    for(const char* c = annotation; *c; c++) {
+        bool valid = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+                     (*c >= '0' && *c <= '9') || *c == '_';
+        sb_append_char(&constant, valid ? *c : '_');
+    }
+    sb_append_char(&constant, '\0');
+    array_foreach(char*, it, ctx->annotation_constants) {
+        if(strcmp(*it, constant.items) == 0) {
+            constant.size--;
+            sb_appendf(&constant, "_%u", id);
+            sb_append_char(&constant, '\0');
+            break;
+        }
+    }
+    array_push(ctx->annotation_constants, ext_strdup(constant.items));
+    sb_free(&constant);
+
+    if(id == MAX_ANNOTATION_IDS) {
+        fprintf(stderr,
+                "warning: more than %d distinct annotations, annotation '%s' and the following "
+                "ones are only available as strings\n",
+                MAX_ANNOTATION_IDS, annotation);
+    }
+
+    return id;
+}
+
+// Emits the `Type_Info_Annotation_Set` of the annotations on a cursor
+static void emit_annotation_set_for_cursor(Type_Info_Context* ctx, CXCursor c, FILE* out) {
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Annotations annotations = {.allocator = &temp_allocator};
+        clang_visitChildren(c, collect_annotations, &annotations);
+        int emitted = 0;
+        array_foreach(char*, it, &annotations) {
+            uint32_t id = intern_annotation(ctx, *it);
+            if(id >= MAX_ANNOTATION_IDS) continue;
+            fprintf(out, "%sTYPE_INFO_ANNOTATION_BIT(%s)", emitted++ ? " | " : "",
+                    ctx->annotation_constants->items[id]);
+        }
+        if(!emitted) fprintf(out, "0");
+    }
+}
+
+static void emit_annotation_ids(Type_Info_Context* ctx) {
+    if(ctx->annotation_constants->size == 0) return;
+    fprintf(ctx->header, "\n// Annotation IDs, see `Type_Info_Annotation_Set`\nenum {\n");
+    for(size_t id = 0; id < ctx->annotation_constants->size && id < MAX_ANNOTATION_IDS; id++) {
+        fprintf(ctx->header, "    %s = %zu,\n", ctx->annotation_constants->items[id], id);
+    }
+    fprintf(ctx->header, "};\n");
+}
+
 static void emit_typeinfo_for_type(Type_Info_Context* ctx, CXType type);
+static void emit_fingerprint(FILE* out, CXType type);
 static enum CXChildVisitResult enum_value_visitor(CXCursor c, CXCursor parent, CXClientData data);
 static enum CXVisitorResult member_visitor(CXCursor c, CXClientData data);
 
+// Emits the `pointers` and `pointers_count` of a struct or union
+static void emit_pointer_slots(Type_Info_Context* ctx, CXType type) {
+    FILE* out = ctx->source;
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Pointer_Slots slots = {.allocator = &temp_allocator};
+        collect_pointer_slots(type, 0, false, &slots);
+        if(slots.size == 0) {
+            fprintf(out, "NULL, 0");
+        } else {
+            fprintf(out, "(Type_Info_Pointer_Slot[]){");
+            array_foreach(const Pointer_Slot, slot, &slots) {
+                fprintf(out, "%s{%lld, %s, ", slot == slots.items ? "" : ", ", slot->offset,
+                        slot->is_cstr ? "true" : "false");
+                emit_typeinfo_for_type(ctx, slot->pointee);
+                fprintf(out, "}");
+            }
+            fprintf(out, "}, %zu", slots.size);
+        }
+    }
+}
+
+// Emits the `leaves` and `leaves_count` of a struct, empty unless it's a root
+static void emit_leaves(Type_Info_Context* ctx, CXType type, bool is_root) {
+    FILE* out = ctx->source;
+    if(!is_root) {
+        fprintf(out, "NULL, 0");
+        return;
+    }
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Leaves leaves = {.allocator = &temp_allocator};
+        collect_leaves(type, 0, "", &leaves);
+        if(leaves.size == 0) {
+            fprintf(out, "NULL, 0");
+        } else {
+            fprintf(out, "(Type_Info_Leaf[]){\n");
+            array_foreach(const Leaf, leaf, &leaves) {
+                emit_indentation(out, ctx->indent + 2 * INDENT);
+                fprintf(out, "{%lld, %lld, %lld, \"%s\", ", leaf->offset, leaf->bit_offset,
+                        leaf->bit_width, leaf->name);
+                emit_typeinfo_for_type(ctx, clang_getCanonicalType(leaf->type));
+                fprintf(out, "},\n");
+            }
+            emit_indentation(out, ctx->indent + INDENT);
+            fprintf(out, "}, %zu", leaves.size);
+        }
+    }
+}
+
 static void enqueue_type_if_needed(Type_Info_Context* ctx, CXType type) {
     type = clang_getCanonicalType(type);
 
@@ -298,22 +1215,147 @@ static void enqueue_type_if_needed(Type_Info_Context* ctx, CXType type) {
         return;
     }
 
-    array_push(ctx->pending_types, type);  // Add to queue
-    clang_disposeString(spelling);
-}
+    array_push(ctx->pending_types, type);  // Add to queue
+    clang_disposeString(spelling);
+}
+
+// Types without a name of their own get a static instance, shared by all their uses, so that type
+// infos of the same type are the same pointer. Returns NULL for other types, which are referenced
+// by name.
+static const char* derived_type_kind(CXType type, const char** type_info) {
+    switch(type.kind) {
+    case CXType_Pointer:
+        *type_info = "Type_Info_Pointer";
+        return "pointer";
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray:
+        *type_info = "Type_Info_Array";
+        return "array";
+    case CXType_Vector:
+    case CXType_ExtVector:
+        *type_info = "Type_Info_Vector";
+        return "vector";
+    case CXType_Enum:
+        if(!clang_Cursor_isAnonymous(clang_getTypeDeclaration(type))) return NULL;
+        *type_info = "Type_Info_Enum";
+        return "enum";
+    case CXType_Record: {
+        CXCursor decl = clang_getTypeDeclaration(type);
+        if(!clang_Cursor_isAnonymous(decl)) return NULL;
+        bool is_union = clang_getCursorKind(decl) == CXCursor_UnionDecl;
+        *type_info = is_union ? "Type_Info_Union" : "Type_Info_Struct";
+        return is_union ? "union" : "struct";
+    }
+    default:
+        return NULL;
+    }
+}
+
+// Spelling of a canonical derived type, which identifies it. Qualifiers of the type itself are left
+// out, as members carry them rather than the type info. Allocates from the temporary allocator.
+static char* derived_type_key(CXType type) {
+    bool is_pointer = type.kind == CXType_Pointer;
+    CXString spelling = clang_getTypeSpelling(is_pointer ? clang_getPointeeType(type) : type);
+    const char* key = clang_getCString(spelling);
+    // The pointee keeps its qualifiers, and those of arrays apply to their elements
+    bool stripped = !is_pointer && type.kind != CXType_ConstantArray &&
+                    type.kind != CXType_IncompleteArray;
+    while(stripped) {
+        static const char* qualifiers[] = {"const ", "volatile ", "restrict "};
+        stripped = false;
+        for(size_t i = 0; i < sizeof(qualifiers) / sizeof(*qualifiers); i++) {
+            size_t len = strlen(qualifiers[i]);
+            if(strncmp(key, qualifiers[i], len) == 0) key += len, stripped = true;
+        }
+    }
+    char* result = temp_sprintf(is_pointer ? "%s *" : "%s", key);
+    clang_disposeString(spelling);
+    return result;
+}
+
+static void define_derived_type(Type_Info_Context* ctx, CXType type);
+
+static enum CXVisitorResult define_field_types(CXCursor c, CXClientData data) {
+    define_derived_type(data, clang_getCursorType(c));
+    return CXVisit_Continue;
+}
+
+// Defines the derived types the type info of a struct or union refers to: the types of its
+// members, what its pointers point to and the types of its leaves
+static void define_derived_types_of_record(Type_Info_Context* ctx, CXType type, bool is_root) {
+    clang_Type_visitFields(type, define_field_types, ctx);
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Pointer_Slots slots = {.allocator = &temp_allocator};
+        collect_pointer_slots(type, 0, false, &slots);
+        array_foreach(const Pointer_Slot, slot, &slots) {
+            define_derived_type(ctx, slot->pointee);
+        }
+        if(is_root) {
+            Leaves leaves = {.allocator = &temp_allocator};
+            collect_leaves(type, 0, "", &leaves);
+            array_foreach(const Leaf, leaf, &leaves) {
+                define_derived_type(ctx, leaf->type);
+            }
+        }
+    }
+}
+
+// Emits the static instance of a derived type, after the ones it refers to. Must be called outside
+// of any other definition.
+static void define_derived_type(Type_Info_Context* ctx, CXType type) {
+    FILE* out = ctx->source;
+    type = clang_getCanonicalType(type);
+
+    const char* type_info;
+    const char* derived_kind = derived_type_kind(type, &type_info);
+    if(!derived_kind) return;
+
+    char* key = derived_type_key(type);
+    if(hmap_get_cstr(ctx->derived_types, key)) return;
+
+    switch(type.kind) {
+    case CXType_Pointer: {
+        CXType pointee = clang_getPointeeType(type);
+        if(pointee.kind != CXType_FunctionProto && pointee.kind != CXType_FunctionNoProto) {
+            define_derived_type(ctx, pointee);
+        }
+    } break;
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray:
+    case CXType_Vector:
+    case CXType_ExtVector:
+        define_derived_type(ctx, clang_getElementType(type));
+        break;
+    case CXType_Record:
+        define_derived_types_of_record(ctx, type, false);
+        break;
+    default:
+        break;
+    }
+
+    uint32_t id = (uint32_t)ctx->derived_types->size;
+    hmap_put_cstr(ctx->derived_types, ext_strdup(key), id);
 
-static void emit_typeinfo_for_type(Type_Info_Context* ctx, CXType type) {
-    FILE* out = ctx->source;
+    fprintf(out, "// %s\nstatic %s typeinfo__%s_%u = ", key, type_info, derived_kind, id);
 
     long long num_elems = clang_getNumElements(type);
-    if(num_elems >= 0) {  // It's an array
+    if(type.kind == CXType_Vector || type.kind == CXType_ExtVector) {
+        fprintf(out, "{{TYPE_TAG_VECTOR, %lld, %lld, ", clang_Type_getSizeOf(type),
+                clang_Type_getAlignOf(type));
+        emit_trait_flags(out, type_traits(type));
+        fprintf(out, "}, %lld, ", num_elems);
+        emit_typeinfo_for_type(ctx, clang_getCanonicalType(clang_getElementType(type)));
+        fprintf(out, " }");
+    } else if(num_elems >= 0) {  // It's an array
         long long const_size = clang_getArraySize(type);
 
         long long count = (const_size >= 0 ? const_size : num_elems);
         long long array_size = clang_Type_getSizeOf(type);
         long long array_align = clang_Type_getAlignOf(type);
-        fprintf(out, "(Type_Info*)&(Type_Info_Array){{TYPE_TAG_ARRAY, %lld, %lld}, %lld, ",
-                array_size, array_align, count);
+        fprintf(out, "{{TYPE_TAG_ARRAY, %lld, %lld, ", array_size, array_align);
+        emit_trait_flags(out, type_traits(type));
+        fprintf(out, "}, %lld, ", count);
 
         CXType elem = clang_getArrayElementType(type);
         emit_typeinfo_for_type(ctx, clang_getCanonicalType(elem));
@@ -323,14 +1365,17 @@ static void emit_typeinfo_for_type(Type_Info_Context* ctx, CXType type) {
         CXType elem = clang_getArrayElementType(type);
         long long elem_align = clang_Type_getAlignOf(clang_getCanonicalType(elem));
         if(elem_align < 0) elem_align = 0;
-        fprintf(out, "(Type_Info*)&(Type_Info_Array){{TYPE_TAG_ARRAY, 0, %lld}, 0, ", elem_align);
+        fprintf(out, "{{TYPE_TAG_ARRAY, 0, %lld, ", elem_align);
+        emit_trait_flags(out, type_traits(type));
+        fprintf(out, "}, 0, ");
         emit_typeinfo_for_type(ctx, clang_getCanonicalType(elem));
         fprintf(out, " }");
     } else if(type.kind == CXType_Pointer) {
         CXType pointee = clang_getPointeeType(type);
         long long ptr_align = clang_Type_getAlignOf(type);
-        fprintf(out, "(Type_Info*)&(Type_Info_Pointer){{TYPE_TAG_POINTER, sizeof(void*), %lld}, ",
-                ptr_align);
+        fprintf(out, "{{TYPE_TAG_POINTER, sizeof(void*), %lld, ", ptr_align);
+        emit_trait_flags(out, TRAIT_HAS_POINTERS);
+        fprintf(out, "}, ");
 
         if(pointee.kind == CXType_FunctionProto || pointee.kind == CXType_FunctionNoProto) {
             fprintf(out, "NULL");
@@ -340,61 +1385,88 @@ static void emit_typeinfo_for_type(Type_Info_Context* ctx, CXType type) {
         fprintf(out, ", ");
         emit_qualifier_flags(out, pointee);
         fprintf(out, " }");
-    } else if(type.kind == CXType_Enum) {
+    } else if(type.kind == CXType_Enum) {  // Anonymous enum
         CXCursor decl = clang_getTypeDeclaration(type);
 
-        if(clang_Cursor_isAnonymous(decl)) {  // Anonymous enum, emit inline
-            // Count enum values
-            int value_count = 0;
-            clang_visitChildren(decl, count_enum_values, &value_count);
+        // Count enum values
+        int value_count = 0;
+        clang_visitChildren(decl, count_enum_values, &value_count);
 
-            long long esize = clang_Type_getSizeOf(type);
-            long long ealign = clang_Type_getAlignOf(type);
-            fprintf(out, "(Type_Info*)&(Type_Info_Enum){{TYPE_TAG_ENUM, %lld, %lld}, ", esize,
-                    ealign);
+        long long esize = clang_Type_getSizeOf(type);
+        long long ealign = clang_Type_getAlignOf(type);
+        fprintf(out, "{{TYPE_TAG_ENUM, %lld, %lld, ", esize, ealign);
+        emit_trait_flags(out, type_traits(type));
+        fprintf(out, "}, ");
 
-            emit_annotations_for_cursor(decl, out);
+        emit_annotations_for_cursor(decl, out);
 
-            fprintf(out, ", \"\", (Type_Info_Enum_Value[]){\n");
-            ctx_indent(ctx) {
-                clang_visitChildren(decl, enum_value_visitor, ctx);
-            }
-            emit_indentation(out, ctx->indent);
-            fprintf(out, "}, %d }", value_count);
-        } else {  // Named enum - reference by name
-            enqueue_type_if_needed(ctx, type);
-            CXString en = clang_getCursorSpelling(decl);
-            fprintf(out, "(Type_Info*)&typeinfo_%s", clang_getCString(en));
-            clang_disposeString(en);
+        fprintf(out, ", \"\", (Type_Info_Enum_Value[]){\n");
+        ctx_indent(ctx) {
+            clang_visitChildren(decl, enum_value_visitor, ctx);
         }
-    } else if(type.kind == CXType_Record) {
+        emit_indentation(out, ctx->indent);
+        fprintf(out, "}, %d, ", value_count);
+        emit_enum_lookup(decl, out);
+        fprintf(out, ", ");
+        emit_annotation_set_for_cursor(ctx, decl, out);
+        fprintf(out, ", ");
+        emit_fingerprint(out, type);
+        fprintf(out, ", %s }", is_signed_enum(decl) ? "true" : "false");
+    } else {  // Anonymous struct/union
         CXCursor decl = clang_getTypeDeclaration(type);
         enum CXCursorKind kind = clang_getCursorKind(decl);
 
-        if(clang_Cursor_isAnonymous(decl)) {  // Anonymous struct/union, emit inline
-            int field_count = 0;
-            clang_Type_visitFields(type, count_fields, &field_count);
+        int field_count = 0;
+        clang_Type_visitFields(type, count_fields, &field_count);
 
-            const char* tag = (kind == CXCursor_UnionDecl) ? "TYPE_TAG_UNION" : "TYPE_TAG_STRUCT";
-            const char* ti = (kind == CXCursor_UnionDecl) ? "Type_Info_Union" : "Type_Info_Struct";
-            long long ssize = clang_Type_getSizeOf(type);
-            long long salign = clang_Type_getAlignOf(type);
-            fprintf(out, "(Type_Info*)&(%s){{%s, %lld, %lld}, ", ti, tag, ssize, salign);
+        const char* tag = (kind == CXCursor_UnionDecl) ? "TYPE_TAG_UNION" : "TYPE_TAG_STRUCT";
+        long long ssize = clang_Type_getSizeOf(type);
+        long long salign = clang_Type_getAlignOf(type);
+        fprintf(out, "{{%s, %lld, %lld, ", tag, ssize, salign);
+        emit_trait_flags(out, type_traits(type));
+        fprintf(out, "}, ");
 
-            emit_annotations_for_cursor(decl, out);
+        emit_annotations_for_cursor(decl, out);
 
-            fprintf(out, ", \"\", (Type_Info_Member[]){\n");
-            ctx_indent(ctx) {
-                clang_Type_visitFields(type, member_visitor, ctx);
-            }
-            emit_indentation(out, ctx->indent);
-            fprintf(out, "}, %d }", field_count);
-        } else {  // Named struct/union - reference by name
-            enqueue_type_if_needed(ctx, type);
-            CXString sn = clang_getCursorSpelling(decl);
-            fprintf(out, "(Type_Info*)&typeinfo_%s", clang_getCString(sn));
-            clang_disposeString(sn);
+        fprintf(out, ", \"\", (Type_Info_Member[]){\n");
+        ctx_indent(ctx) {
+            clang_Type_visitFields(type, member_visitor, ctx);
+        }
+        emit_indentation(out, ctx->indent);
+        fprintf(out, "}, %d, ", field_count);
+        emit_member_index(type, out);
+        fprintf(out, ", ");
+        emit_annotation_set_for_cursor(ctx, decl, out);
+        fprintf(out, ", NULL, ");
+        emit_byte_ranges(out, type);
+        fprintf(out, ", ");
+        emit_pointer_slots(ctx, type);
+        fprintf(out, ", ");
+        emit_fingerprint(out, type);
+        fprintf(out, ", NULL, 0 }");
+    }
+
+    fprintf(out, ";\n\n");
+}
+
+static void emit_typeinfo_for_type(Type_Info_Context* ctx, CXType type) {
+    FILE* out = ctx->source;
+
+    const char* type_info;
+    const char* derived_kind = derived_type_kind(clang_getCanonicalType(type), &type_info);
+    if(derived_kind) {  // Defined beforehand by `define_derived_type`
+        void* temp;
+        defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+            Derived_Type_Entry* derived =
+                hmap_get_cstr(ctx->derived_types, derived_type_key(clang_getCanonicalType(type)));
+            assert(derived && "derived type used before being defined");
+            fprintf(out, "(Type_Info*)&typeinfo__%s_%u", derived_kind, derived->value);
         }
+    } else if(type.kind == CXType_Enum || type.kind == CXType_Record) {  // Reference by name
+        enqueue_type_if_needed(ctx, type);
+        CXString sn = clang_getCursorSpelling(clang_getTypeDeclaration(type));
+        fprintf(out, "(Type_Info*)&typeinfo_%s", clang_getCString(sn));
+        clang_disposeString(sn);
     } else {  // Otherwise, base type
         const char* base_sym = builtin_symbol(type.kind);
         if(base_sym) {
@@ -414,6 +1486,7 @@ static enum CXVisitorResult member_visitor(CXCursor c, CXClientData data) {
     FILE* out = ctx->source;
 
     assert(clang_getCursorKind(c) == CXCursor_FieldDecl);
+    if(is_unnamed_bitfield(c)) return CXVisit_Continue;
 
     CXString name = clang_getCursorSpelling(c);
     const char* field_name = clang_getCString(name);
@@ -434,6 +1507,11 @@ static enum CXVisitorResult member_visitor(CXCursor c, CXClientData data) {
     }
 
     long long offset_bytes = offset_bits / 8;
+    long long bit_offset = 0, bit_width = 0;
+    if(clang_Cursor_isBitField(c)) {
+        bit_offset = offset_bits % 8;
+        bit_width = clang_getFieldDeclBitWidth(c);
+    }
 
     emit_indentation(out, ctx->indent);
     fprintf(out, "{ ");
@@ -442,7 +1520,9 @@ static enum CXVisitorResult member_visitor(CXCursor c, CXClientData data) {
     emit_typeinfo_for_type(ctx, type);
     fprintf(out, ", ");
     emit_qualifier_flags(out, declared_type);
-    fprintf(out, " },\n");
+    fprintf(out, ", %zu, ", strlen(field_name));
+    emit_annotation_set_for_cursor(ctx, c, out);
+    fprintf(out, ", %lld, %lld },\n", bit_offset, bit_width);
 
     clang_disposeString(name);
 
@@ -455,18 +1535,488 @@ static enum CXChildVisitResult enum_value_visitor(CXCursor c, CXCursor parent, C
     FILE* out = ctx->source;
     if(clang_getCursorKind(c) == CXCursor_EnumConstantDecl) {
         CXString name = clang_getCursorSpelling(c);
+        const char* value_name = clang_getCString(name);
         long long value = clang_getEnumConstantDeclValue(c);
 
         emit_indentation(out, ctx->indent);
         fprintf(out, "{ ");
         emit_annotations_for_cursor(c, out);
-        fprintf(out, ", \"%s\", %lld },\n", clang_getCString(name), value);
+        fprintf(out, ", \"%s\", %lld, %zu, ", value_name, value, strlen(value_name));
+        emit_annotation_set_for_cursor(ctx, c, out);
+        fprintf(out, " },\n");
 
         clang_disposeString(name);
     }
     return CXChildVisit_Continue;
 }
 
+// Appends an op, merging it with the previous one when both are contiguous
+static void push_serializer_op(Serializer_Ops* ops, Serializer_Op op) {
+    if(ops->size > 0 && (op.kind == SERIALIZER_COPY || op.kind == SERIALIZER_ZERO)) {
+        Serializer_Op* last = &ops->items[ops->size - 1];
+        if(last->kind == op.kind && last->value_offset + last->size == op.value_offset &&
+           (op.kind == SERIALIZER_ZERO || last->data_offset + last->size == op.data_offset)) {
+            last->size += op.size;
+            return;
+        }
+    }
+    array_push(ops, op);
+}
+
+// Bitfields sharing bytes are serialized together, as the bytes they span with the bits of other
+// members cleared. Extends the last op if the bitfield shares a byte with it. Past 8 bytes, the
+// bytes are copied whole. Same as `ti__bitfield_run` in typeinfo.h.
+static void push_bitfield_op(Serializer_Ops* ops, long long offset_bits, long long width,
+                             long long* data_offset) {
+    long long first = offset_bits / 8, end = (offset_bits + width + 7) / 8;
+    Serializer_Op* last = ops->size > 0 ? &ops->items[ops->size - 1] : NULL;
+    if(!last || (last->kind != SERIALIZER_BITS && last->kind != SERIALIZER_COPY) ||
+       last->value_offset + last->size <= first) {
+        Serializer_Op op = {
+            .kind = SERIALIZER_BITS,
+            .value_offset = first,
+            .data_offset = *data_offset,
+        };
+        array_push(ops, op);
+        last = &ops->items[ops->size - 1];
+    }
+    if(last->value_offset + last->size < end) {
+        *data_offset += end - last->value_offset - last->size;
+        last->size = end - last->value_offset;
+    }
+    long long low = offset_bits - last->value_offset * 8;
+    if(low + width <= 64) {
+        last->mask |= (width >= 64 ? ~0ULL : (1ULL << width) - 1) << low;
+    }
+    if(last->size > 8) last->mask = ~0ULL;
+}
+
+// Bitfields using all the bits of their bytes are copied as is
+static void finish_bitfield_op(Serializer_Ops* ops) {
+    if(ops->size == 0) return;
+    Serializer_Op* last = &ops->items[ops->size - 1];
+    if(last->kind != SERIALIZER_BITS) return;
+    uint64_t full = last->size >= 8 ? ~0ULL : (1ULL << (last->size * 8)) - 1;
+    if(last->mask != full) return;
+    Serializer_Op op = *last;
+    op.kind = SERIALIZER_COPY;
+    op.mask = 0;
+    ops->size--;
+    push_serializer_op(ops, op);
+}
+
+static bool collect_serializer_ops(CXType type, long long value_offset, long long* data_offset,
+                                   Serializer_Ops* ops);
+
+static enum CXVisitorResult collect_serializer_fields(CXCursor c, CXClientData data) {
+    Serializer_Fields* fields = data;
+    long long offset_bits = clang_Cursor_getOffsetOfField(c);
+    if(offset_bits < 0) {
+        fields->ok = false;
+        return CXVisit_Break;
+    }
+    if(clang_Cursor_isBitField(c)) {
+        if(!is_unnamed_bitfield(c)) {
+            push_bitfield_op(fields->ops, fields->value_offset * 8 + offset_bits,
+                             clang_getFieldDeclBitWidth(c), fields->data_offset);
+        }
+        return CXVisit_Continue;
+    }
+    finish_bitfield_op(fields->ops);
+    if(!collect_serializer_ops(clang_getCursorType(c), fields->value_offset + offset_bits / 8,
+                               fields->data_offset, fields->ops)) {
+        fields->ok = false;
+        return CXVisit_Break;
+    }
+    return CXVisit_Continue;
+}
+
+// Flattens a type into the copies needed to (de)serialize it, following the format of
+// `ti_serialize` in typeinfo.h. Returns false if the type cannot be serialized (incomplete types).
+static bool collect_serializer_ops(CXType type, long long value_offset, long long* data_offset,
+                                   Serializer_Ops* ops) {
+    type = clang_getCanonicalType(type);
+
+    long long count = clang_getNumElements(type);
+    if(count >= 0) {  // It's an array or a vector, whose padding lanes are left out
+        CXType elem = clang_getCanonicalType(clang_getElementType(type));
+        long long elem_size = clang_Type_getSizeOf(elem);
+        long long elem_data_size = 0;
+        Serializer_Ops body = {.allocator = ops->allocator};
+        if(!collect_serializer_ops(elem, 0, &elem_data_size, &body)) return false;
+        if(count == 0 || body.size == 0) return true;
+
+        Serializer_Op* first = &body.items[0];
+        if(body.size == 1 && (first->kind == SERIALIZER_COPY || first->kind == SERIALIZER_ZERO) &&
+           first->size == elem_size) {
+            // Elements without padding: the whole array is a single op
+            Serializer_Op op = {
+                .kind = first->kind,
+                .value_offset = value_offset,
+                .data_offset = *data_offset,
+                .size = count * elem_size,
+            };
+            push_serializer_op(ops, op);
+        } else {
+            Serializer_Op op = {
+                .kind = SERIALIZER_LOOP,
+                .value_offset = value_offset,
+                .data_offset = *data_offset,
+                .size = elem_data_size,
+                .count = count,
+                .stride = elem_size,
+                .body = body,
+            };
+            push_serializer_op(ops, op);
+        }
+        *data_offset += count * elem_data_size;
+        return true;
+    }
+
+    if(type.kind == CXType_IncompleteArray) {  // Flexible array members are skipped
+        return true;
+    }
+
+    if(type.kind == CXType_Pointer) {
+        Serializer_Op op = {
+            .kind = SERIALIZER_ZERO,
+            .value_offset = value_offset,
+            .data_offset = *data_offset,
+            .size = clang_Type_getSizeOf(type),
+        };
+        push_serializer_op(ops, op);
+        return true;
+    }
+
+    if(type.kind == CXType_Record &&
+       clang_getCursorKind(clang_getTypeDeclaration(type)) == CXCursor_StructDecl) {
+        Serializer_Fields fields = {ops, value_offset, data_offset, true};
+        clang_Type_visitFields(type, collect_serializer_fields, &fields);
+        finish_bitfield_op(ops);
+        return fields.ok;
+    }
+
+    // Scalars, enums and unions are copied whole
+    long long size = clang_Type_getSizeOf(type);
+    if(size < 0) return false;
+    Serializer_Op op = {
+        .kind = SERIALIZER_COPY,
+        .value_offset = value_offset,
+        .data_offset = *data_offset,
+        .size = size,
+    };
+    push_serializer_op(ops, op);
+    *data_offset += size;
+    return true;
+}
+
+static void emit_serializer_ops(FILE* out, const Serializer_Ops* ops, bool deserialize, int depth) {
+    array_foreach(Serializer_Op, op, ops) {
+        // Pointers and arrays of pointers don't take space in the serialized data
+        if(!deserialize && (op->kind == SERIALIZER_ZERO || op->size == 0)) continue;
+
+        emit_indentation(out, INDENT * (depth + 1));
+        switch(op->kind) {
+        case SERIALIZER_COPY:
+            if(deserialize) {
+                fprintf(out, "memcpy(v%d + %lld, d%d + %lld, %lld);\n", depth, op->value_offset,
+                        depth, op->data_offset, op->size);
+            } else {
+                fprintf(out, "memcpy(d%d + %lld, v%d + %lld, %lld);\n", depth, op->data_offset,
+                        depth, op->value_offset, op->size);
+            }
+            break;
+        case SERIALIZER_ZERO:
+            fprintf(out, "memset(v%d + %lld, 0, %lld);\n", depth, op->value_offset, op->size);
+            break;
+        case SERIALIZER_BITS:
+            if(deserialize) {  // The serialized bits not in the mask are 0
+                fprintf(out, "memcpy(v%d + %lld, d%d + %lld, %lld);\n", depth, op->value_offset,
+                        depth, op->data_offset, op->size);
+                break;
+            }
+            for(long long i = 0; i < op->size; i++) {
+                unsigned byte_mask = i < 8 ? (unsigned)(op->mask >> (i * 8)) & 0xFF : 0xFF;
+                if(i > 0) emit_indentation(out, INDENT * (depth + 1));
+                fprintf(out, "d%d[%lld] = (char)(v%d[%lld] & 0x%02x);\n", depth,
+                        op->data_offset + i, depth, op->value_offset + i, byte_mask);
+            }
+            break;
+        case SERIALIZER_LOOP:
+            fprintf(out, "for(size_t i%d = 0; i%d < %lld; i%d++) {\n", depth, depth, op->count,
+                    depth);
+            emit_indentation(out, INDENT * (depth + 2));
+            fprintf(out, "%schar* v%d = v%d + %lld + i%d * %lld;\n", deserialize ? "" : "const ",
+                    depth + 1, depth, op->value_offset, depth, op->stride);
+            if(op->size > 0) {
+                emit_indentation(out, INDENT * (depth + 2));
+                fprintf(out, "%schar* d%d = d%d + %lld + i%d * %lld;\n",
+                        deserialize ? "const " : "", depth + 1, depth, op->data_offset, depth,
+                        op->size);
+            }
+            emit_serializer_ops(out, &op->body, deserialize, depth + 1);
+            emit_indentation(out, INDENT * (depth + 1));
+            fprintf(out, "}\n");
+            break;
+        }
+    }
+}
+
+// Emits `ti_serialize_<name>` and `ti_deserialize_<name>`: straight-line versions of
+// `ti_serialize`/`ti_deserialize` specialized for a struct or union
+static void emit_serializers(Type_Info_Context* ctx, CXType type, const char* name) {
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Serializer_Ops ops = {.allocator = &temp_allocator};
+        long long data_size = 0;
+        if(!collect_serializer_ops(type, 0, &data_size, &ops)) {
+            fprintf(stderr, "warning: `%s` has incomplete types, no serializer generated for it\n",
+                    name);
+            continue;
+        }
+
+        fprintf(ctx->header,
+                "#define TI_SERIALIZED_SIZE_%s %lld\n"
+                "size_t ti_serialize_%s(const void* value, void* out);\n"
+                "size_t ti_deserialize_%s(void* value, const void* data, size_t size);\n",
+                name, data_size, name, name);
+
+        FILE* out = ctx->source;
+        fprintf(out, "size_t ti_serialize_%s(const void* value, void* out) {\n", name);
+        if(data_size > 0) {
+            fprintf(out,
+                    "  const char* v0 = (const char*)value;\n"
+                    "  char* d0 = (char*)out;\n");
+            emit_serializer_ops(out, &ops, false, 0);
+        } else {
+            fprintf(out, "  (void)value;\n  (void)out;\n");
+        }
+        fprintf(out, "  return %lld;\n}\n\n", data_size);
+
+        fprintf(out, "size_t ti_deserialize_%s(void* value, const void* data, size_t size) {\n",
+                name);
+        if(data_size > 0) {
+            fprintf(out, "  if(size < %lld) return 0;\n", data_size);
+        } else {
+            fprintf(out, "  (void)size;\n");
+        }
+        fprintf(out, ops.size > 0 ? "  char* v0 = (char*)value;\n" : "  (void)value;\n");
+        fprintf(out, data_size > 0 ? "  const char* d0 = (const char*)data;\n" : "  (void)data;\n");
+        emit_serializer_ops(out, &ops, true, 0);
+        fprintf(out, "  return %lld;\n}\n\n", data_size);
+    }
+}
+
+static int max_depth(CXType type);
+
+static enum CXVisitorResult max_depth_of_fields(CXCursor c, CXClientData data) {
+    int* depth = data;
+    int d = max_depth(clang_getCursorType(c));
+    if(d > *depth) *depth = d;
+    return CXVisit_Continue;
+}
+
+// Nesting of structs, unions, arrays and vectors in a type, see `ti_max_depth` in typeinfo.h
+static int max_depth(CXType type) {
+    type = clang_getCanonicalType(type);
+    switch(type.kind) {
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray:
+    case CXType_Vector:
+    case CXType_ExtVector:
+        return 1 + max_depth(clang_getElementType(type));
+    case CXType_Record: {
+        int depth = 0;
+        clang_Type_visitFields(type, max_depth_of_fields, &depth);
+        return 1 + depth;
+    }
+    default:
+        return 0;
+    }
+}
+
+// Must match `Type_Info_Tag` in typeinfo.h
+enum {
+    TAG_VOID,
+    TAG_INTEGER,
+    TAG_FLOAT,
+    TAG_POINTER,
+    TAG_ARRAY,
+    TAG_STRUCT,
+    TAG_UNION,
+    TAG_ENUM,
+    TAG_VECTOR,
+};
+
+static uint64_t fingerprint_mix(uint64_t h, uint64_t value) {
+    return hash_mix(h ^ (value + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2)));
+}
+
+static uint64_t fingerprint_cursor_name(uint64_t h, CXCursor c) {
+    CXString name = clang_getCursorSpelling(c);
+    const char* str = clang_getCString(name);
+    // Unnamed members are spelled with their location, which must not change the fingerprint. See
+    // `member_visitor`.
+    if(strchr(str, '(')) str = "";
+    h = fingerprint_mix(h, hash_bytes(str, strlen(str)));
+    clang_disposeString(name);
+    return h;
+}
+
+static uint64_t layout_fingerprint(CXType type);
+
+static enum CXVisitorResult fingerprint_fields(CXCursor c, CXClientData data) {
+    uint64_t* h = data;
+    *h = fingerprint_cursor_name(*h, c);
+    *h = fingerprint_mix(*h, (uint64_t)clang_Cursor_getOffsetOfField(c));
+    *h = fingerprint_mix(*h, clang_Cursor_isBitField(c) ? (uint64_t)clang_getFieldDeclBitWidth(c)
+                                                        : UINT64_MAX);
+    *h = fingerprint_mix(*h, layout_fingerprint(clang_getCursorType(c)));
+    return CXVisit_Continue;
+}
+
+static enum CXChildVisitResult fingerprint_enum_values(CXCursor c, CXCursor parent,
+                                                       CXClientData data) {
+    (void)parent;
+    uint64_t* h = data;
+    if(clang_getCursorKind(c) == CXCursor_EnumConstantDecl) {
+        *h = fingerprint_cursor_name(*h, c);
+        *h = fingerprint_mix(*h, (uint64_t)clang_getEnumConstantDeclValue(c));
+    }
+    return CXChildVisit_Continue;
+}
+
+// Hashes the layout of a type: tags, sizes and alignments, member names, offsets and types, and
+// enum values. Nested structs, unions and arrays are hashed recursively; pointers to named types
+// only hash their name, as types can point to each other in cycles. See `type_fingerprint`.
+static uint64_t layout_fingerprint(CXType type) {
+    type = clang_getCanonicalType(type);
+    uint64_t h = 0;
+    switch(type.kind) {
+    case CXType_Void:
+        h = fingerprint_mix(h, TAG_VOID);
+        break;
+    case CXType_Float:
+    case CXType_Double:
+    case CXType_LongDouble:
+        h = fingerprint_mix(h, TAG_FLOAT);
+        break;
+    case CXType_Pointer: {
+        h = fingerprint_mix(h, TAG_POINTER);
+        CXType pointee = clang_getCanonicalType(clang_getPointeeType(type));
+        CXCursor decl = clang_getTypeDeclaration(pointee);
+        if((pointee.kind == CXType_Record || pointee.kind == CXType_Enum) &&
+           !clang_Cursor_isAnonymous(decl)) {
+            h = fingerprint_mix(h, pointee.kind == CXType_Enum ? TAG_ENUM : TAG_STRUCT);
+            h = fingerprint_cursor_name(h, decl);
+        } else {
+            h = fingerprint_mix(h, layout_fingerprint(pointee));
+        }
+    } break;
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray:
+        h = fingerprint_mix(h, TAG_ARRAY);
+        h = fingerprint_mix(h, (uint64_t)clang_getNumElements(type));
+        h = fingerprint_mix(h, layout_fingerprint(clang_getElementType(type)));
+        break;
+    case CXType_Vector:
+    case CXType_ExtVector:
+        h = fingerprint_mix(h, TAG_VECTOR);
+        h = fingerprint_mix(h, (uint64_t)clang_getNumElements(type));
+        h = fingerprint_mix(h, layout_fingerprint(clang_getElementType(type)));
+        break;
+    case CXType_Record: {
+        bool is_union = clang_getCursorKind(clang_getTypeDeclaration(type)) == CXCursor_UnionDecl;
+        h = fingerprint_mix(h, is_union ? TAG_UNION : TAG_STRUCT);
+        clang_Type_visitFields(type, fingerprint_fields, &h);
+    } break;
+    case CXType_Enum:
+        h = fingerprint_mix(h, TAG_ENUM);
+        clang_visitChildren(clang_getTypeDeclaration(type), fingerprint_enum_values, &h);
+        break;
+    case CXType_Char_S:
+    case CXType_SChar:
+    case CXType_Short:
+    case CXType_Int:
+    case CXType_Long:
+    case CXType_LongLong:
+        h = fingerprint_mix(h, TAG_INTEGER);
+        h = fingerprint_mix(h, 1);  // Signed
+        break;
+    default:
+        h = fingerprint_mix(h, TAG_INTEGER);
+        h = fingerprint_mix(h, 0);
+        break;
+    }
+    h = fingerprint_mix(h, (uint64_t)clang_Type_getSizeOf(type));
+    return fingerprint_mix(h, (uint64_t)clang_Type_getAlignOf(type));
+}
+
+static bool is_named_type(CXType type) {
+    return (type.kind == CXType_Record || type.kind == CXType_Enum) &&
+           !clang_Cursor_isAnonymous(clang_getTypeDeclaration(type));
+}
+
+static void collect_pointees(CXType type, Type_Queue* pointees);
+
+static enum CXVisitorResult collect_field_pointees(CXCursor c, CXClientData data) {
+    collect_pointees(clang_getCursorType(c), data);
+    return CXVisit_Continue;
+}
+
+// Appends the named types a type points to, seeing through members, elements and pointers to
+// unnamed types, unless they are already in `pointees`
+static void collect_pointees(CXType type, Type_Queue* pointees) {
+    type = clang_getCanonicalType(type);
+    switch(type.kind) {
+    case CXType_Pointer: {
+        CXType pointee = clang_getCanonicalType(clang_getPointeeType(type));
+        if(!is_named_type(pointee)) {
+            collect_pointees(pointee, pointees);
+            break;
+        }
+        array_foreach(const CXType, it, pointees) {
+            if(clang_equalTypes(*it, pointee)) return;
+        }
+        array_push(pointees, pointee);
+    } break;
+    case CXType_ConstantArray:
+    case CXType_IncompleteArray:
+    case CXType_Vector:
+    case CXType_ExtVector:
+        collect_pointees(clang_getElementType(type), pointees);
+        break;
+    case CXType_Record:
+        clang_Type_visitFields(type, collect_field_pointees, pointees);
+        break;
+    default:
+        break;
+    }
+}
+
+// Hashes the layout of a type and of every named type reachable through its pointers, each once
+// in the order first reached, so that a value and all it points to can be accepted as is when
+// fingerprints match. See `fingerprint` in typeinfo.h
+static uint64_t type_fingerprint(CXType type) {
+    type = clang_getCanonicalType(type);
+    uint64_t h = layout_fingerprint(type);
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        Type_Queue pointees = {.allocator = &temp_allocator};
+        array_push(&pointees, type);
+        for(size_t i = 0; i < pointees.size; i++) {
+            CXType reached = pointees.items[i];
+            if(i > 0) h = fingerprint_mix(h, layout_fingerprint(reached));
+            collect_pointees(reached, &pointees);
+        }
+    }
+    return h;
+}
+
+static void emit_fingerprint(FILE* out, CXType type) {
+    fprintf(out, "0x%016llxULL", (unsigned long long)type_fingerprint(type));
+}
+
 static void process_queued_type(Type_Info_Context* ctx, CXType type) {
     type = clang_getCanonicalType(type);
     CXCursor c = clang_getTypeDeclaration(type);
@@ -496,6 +2046,17 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
     }
     hmap_put_cstr(ctx->visited_types, temp_strdup(name), true);
 
+    switch(kind) {
+    case CXCursor_StructDecl:
+    case CXCursor_UnionDecl:
+    case CXCursor_EnumDecl: {
+        Registered_Type registered = {temp_strdup(name)};
+        array_push(ctx->registered_types, registered);
+    } break;
+    default:
+        break;
+    }
+
     FILE* header = ctx->header;
     FILE* source = ctx->source;
 
@@ -508,6 +2069,9 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
     switch(kind) {
     case CXCursor_StructDecl:
     case CXCursor_UnionDecl: {
+        bool is_root = kind == CXCursor_StructDecl && has_typeinfo_annotation(c);
+        define_derived_types_of_record(ctx, type, is_root);
+
         if(kind == CXCursor_StructDecl) {
             fprintf(header, "extern Type_Info_Struct typeinfo_%s; // %s:%u:%u\n", name, filename,
                     line, column);
@@ -517,6 +2081,10 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
                     line, column);
             fprintf(source, "// union %s\n", name);
         }
+        fprintf(header, "#define TI_MAX_DEPTH_%s %d\n", name, max_depth(type));
+        fprintf(header, "#define TI_FINGERPRINT_%s ", name);
+        emit_fingerprint(header, type);
+        fprintf(header, "\n");
 
         fprintf(source,
                 "// %s:%u:%u\n"
@@ -532,14 +2100,16 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
         if(kind == CXCursor_StructDecl) {
             fprintf(source,
                     "Type_Info_Struct typeinfo_%s = {\n"
-                    "  { TYPE_TAG_STRUCT, %lld, %lld },\n",
+                    "  { TYPE_TAG_STRUCT, %lld, %lld, ",
                     name, size, align);
         } else {
             fprintf(source,
                     "Type_Info_Union typeinfo_%s = {\n"
-                    "  { TYPE_TAG_UNION, %lld, %lld },\n",
+                    "  { TYPE_TAG_UNION, %lld, %lld, ",
                     name, size, align);
         }
+        emit_trait_flags(source, type_traits(type));
+        fprintf(source, " },\n");
 
         emit_indentation(source, INDENT);
         emit_annotations_for_cursor(c, source);
@@ -548,14 +2118,42 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
         fprintf(source,
                 "  \"%s\",\n"
                 "  members_%s,\n"
-                "  sizeof(members_%s)/sizeof(*members_%s)\n"
-                "};\n\n",
+                "  sizeof(members_%s)/sizeof(*members_%s),\n",
                 name, name, name, name);
+
+        emit_indentation(source, INDENT);
+        emit_member_index(type, source);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_annotation_set_for_cursor(ctx, c, source);
+        fprintf(source, ",\n  NULL,\n");
+
+        emit_indentation(source, INDENT);
+        emit_byte_ranges(source, type);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_pointer_slots(ctx, type);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_fingerprint(source, type);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_leaves(ctx, type, is_root);
+        fprintf(source, "\n};\n\n");
+
+        if(opts.emit_serializers) emit_serializers(ctx, type, name);
     } break;
 
     case CXCursor_EnumDecl: {
         fprintf(header, "extern Type_Info_Enum typeinfo_%s; // %s:%u:%u \n", name, filename, line,
                 column);
+        fprintf(header, "#define TI_FINGERPRINT_%s ", name);
+        emit_fingerprint(header, type);
+        fprintf(header, "\n");
 
         fprintf(source,
                 "// enum %s\n"
@@ -571,8 +2169,10 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
 
         fprintf(source,
                 "Type_Info_Enum typeinfo_%s = {\n"
-                "  { TYPE_TAG_ENUM, %lld, %lld },\n",
+                "  { TYPE_TAG_ENUM, %lld, %lld, ",
                 name, size, align);
+        emit_trait_flags(source, type_traits(type));
+        fprintf(source, " },\n");
 
         emit_indentation(source, INDENT);
         emit_annotations_for_cursor(c, source);
@@ -581,9 +2181,23 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
         fprintf(source,
                 "  \"%s\",\n"
                 "  values_%s,\n"
-                "  sizeof(values_%s)/sizeof(*values_%s)\n"
-                "};\n\n",
+                "  sizeof(values_%s)/sizeof(*values_%s),\n",
                 name, name, name, name);
+
+        emit_indentation(source, INDENT);
+        emit_enum_lookup(c, source);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_annotation_set_for_cursor(ctx, c, source);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        emit_fingerprint(source, type);
+        fprintf(source, ",\n");
+
+        emit_indentation(source, INDENT);
+        fprintf(source, "%s\n};\n\n", is_signed_enum(c) ? "true" : "false");
     } break;
 
     default:
@@ -594,6 +2208,50 @@ static void process_queued_type(Type_Info_Context* ctx, CXType type) {
     clang_disposeString(filename_str);
 }
 
+// Emits the registry of all the named types emitted so far, see `Type_Info_Registry` in typeinfo.h
+static void emit_registry(Type_Info_Context* ctx) {
+    Registered_Types* types = ctx->registered_types;
+    fprintf(ctx->header, "\nextern Type_Info_Registry %s;\n", opts.registry);
+
+    if(types->size == 0) {
+        fprintf(ctx->source, "Type_Info_Registry %s = { NULL, 0, { NULL, NULL, 0 } };\n",
+                opts.registry);
+        return;
+    }
+
+    fprintf(ctx->source, "// Registry of all the types above\n");
+    fprintf(ctx->source, "static Type_Info_Registry_Entry entries_%s[] = {\n", opts.registry);
+    array_foreach(Registered_Type, it, types) {
+        emit_indentation(ctx->source, INDENT);
+        fprintf(ctx->source, "{ \"%s\", %zu, (Type_Info*)&typeinfo_%s },\n", it->name,
+                strlen(it->name), it->name);
+    }
+    fprintf(ctx->source, "};\n");
+
+    fprintf(ctx->source,
+            "Type_Info_Registry %s = {\n"
+            "  entries_%s,\n"
+            "  sizeof(entries_%s)/sizeof(*entries_%s),\n",
+            opts.registry, opts.registry, opts.registry, opts.registry);
+
+    void* temp;
+    defer_loop(temp = temp_checkpoint(), temp_rewind(temp)) {
+        uint64_t* hashes = temp_alloc(types->size * sizeof(uint64_t));
+        uint32_t* positions = temp_alloc(types->size * sizeof(uint32_t));
+        for(size_t i = 0; i < types->size; i++) {
+            hashes[i] = hash_bytes(types->items[i].name, strlen(types->items[i].name));
+            positions[i] = (uint32_t)i;
+        }
+
+        Hash_Index index;
+        build_hash_index(hashes, positions, types->size, &index);
+        emit_indentation(ctx->source, INDENT);
+        emit_hash_index(ctx->source, &index);
+    }
+
+    fprintf(ctx->source, "\n};\n");
+}
+
 static enum CXChildVisitResult queue_types(CXCursor c, CXCursor parent, CXClientData data) {
     (void)parent;
     Type_Info_Context* ctx = data;
@@ -623,8 +2281,13 @@ static void print_usage(const char* program_name, FILE* stream) {
     fprintf(stream, "OPTIONS\n");
     fprintf(stream, "  -o <out_name>       base name of generated file (REQUIRED)\n");
     fprintf(stream, "  -I<dir>             add include path (forwarded to clang)\n");
+    fprintf(stream, "  -D<macro>[=value]   define a macro (forwarded to clang)\n");
     fprintf(stream, "  -std=<std>          set language standard (forwarded to clang)\n");
     fprintf(stream, "  -no-builtin-types   do not emit builtin type info declarations/definitions\n");
+    fprintf(stream, "  -registry <name>    name of the generated type registry (default typeinfo_registry)\n");
+    fprintf(stream, "  -emit-serializers   emit specialized binary serializers for structs and unions\n");
+    fprintf(stream, "  -annotation-prefix <prefix>\n");
+    fprintf(stream, "                      prefix of the generated annotation IDs (default TI_ANN_)\n");
     fprintf(stream, "  -R                  recursively walk directories\n");
     fprintf(stream, "  -h                  prints this help message and exit\n");
 }
@@ -765,6 +2428,22 @@ static void parse_arguments(int argc, char** argv) {
             opts.recursive = true;
         } else if(strcmp("-no-builtin-types", argv[i]) == 0) {
             opts.no_builtin_types = true;
+        } else if(strcmp("-emit-serializers", argv[i]) == 0) {
+            opts.emit_serializers = true;
+        } else if(strcmp("-registry", argv[i]) == 0) {
+            if(i + 1 >= argc) {
+                fprintf(stderr, "no argument for option `-registry`\n");
+                print_usage(program_name, stderr);
+                exit(1);
+            }
+            opts.registry = argv[++i];
+        } else if(strcmp("-annotation-prefix", argv[i]) == 0) {
+            if(i + 1 >= argc) {
+                fprintf(stderr, "no argument for option `-annotation-prefix`\n");
+                print_usage(program_name, stderr);
+                exit(1);
+            }
+            opts.annotation_prefix = argv[++i];
         } else if(strcmp("-o", argv[i]) == 0) {
             if(i + 1 >= argc) {
                 fprintf(stderr, "no argument for option `-o`\n");
@@ -772,16 +2451,17 @@ static void parse_arguments(int argc, char** argv) {
                 exit(1);
             }
             opts.out = argv[++i];
-        } else if(ss_starts_with(SS(argv[i]), SS("-I"))) {
+        } else if(ss_starts_with(SS(argv[i]), SS("-I")) ||
+                  ss_starts_with(SS(argv[i]), SS("-D"))) {
             if(argv[i][2] != '\0') {
                 array_push(&opts.forwarded, argv[i]);
             } else {
                 if(i + 1 >= argc) {
-                    fprintf(stderr, "no argument for option `-I`\n");
+                    fprintf(stderr, "no argument for option `%s`\n", argv[i]);
                     print_usage(program_name, stderr);
                     exit(1);
                 }
-                array_push(&opts.forwarded, "-I");
+                array_push(&opts.forwarded, argv[i]);
                 array_push(&opts.forwarded, argv[++i]);
             }
         } else if(ss_starts_with(SS(argv[i]), SS("-std="))) {
@@ -795,6 +2475,9 @@ static void parse_arguments(int argc, char** argv) {
         exit(1);
     }
 
+    if(!opts.registry) opts.registry = "typeinfo_registry";
+    if(!opts.annotation_prefix) opts.annotation_prefix = "TI_ANN_";
+
     opts.files = argv;
     opts.count = npos;
 }
@@ -838,15 +2521,26 @@ int main(int argc, char** argv) {
     if(!opts.no_builtin_types) emit_builtin_defs(source);
 
     Visited_Types visited = {0};
+    Derived_Types derived = {0};
     Type_Queue pending = {0};
+    Registered_Types registered = {0};
+    Annotation_Ids annotation_ids = {0};
+    Annotations annotation_constants = {0};
     Type_Info_Context ctx = {
         .header = header,
         .source = source,
         .indent = 0,
         .visited_types = &visited,
+        .derived_types = &derived,
         .pending_types = &pending,
+        .registered_types = &registered,
+        .annotation_ids = &annotation_ids,
+        .annotation_constants = &annotation_constants,
     };
 
+    // Interned first, so that the runtime finds it at a fixed ID
+    intern_annotation(&ctx, ANNOTATION_CSTR);
+
     int result = 0;
     CXIndex index;
     defer_loop(index = clang_createIndex(0, 0), clang_disposeIndex(index)) {
@@ -857,6 +2551,9 @@ int main(int argc, char** argv) {
         }
     }
 
+    emit_registry(&ctx);
+    emit_annotation_ids(&ctx);
+
     fprintf(header, "\n#endif // %.*s_\n", SB_Arg(include_guard));
     fclose(header);
     fclose(source);
@@ -865,7 +2562,20 @@ int main(int argc, char** argv) {
     printf("Generated: %zu type infos\n", visited.size);
 
     hmap_free(&visited);
+    hmap_foreach(Derived_Type_Entry, it, &derived) {
+        ext_free(it->key, strlen(it->key) + 1);
+    }
+    hmap_free(&derived);
     array_free(&pending);
+    array_free(&registered);
+    hmap_foreach(Annotation_Id_Entry, it, &annotation_ids) {
+        ext_free(it->key, strlen(it->key) + 1);
+    }
+    hmap_free(&annotation_ids);
+    array_foreach(char*, it, &annotation_constants) {
+        ext_free(*it, strlen(*it) + 1);
+    }
+    array_free(&annotation_constants);
 
     return result;
 }